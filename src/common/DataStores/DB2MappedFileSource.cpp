@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2008-2018 TrinityCore <https://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DB2MappedFileSource.h"
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+DB2MappedFileSource::DB2MappedFileSource(std::string const& fileName) : _fileName(fileName), _data(nullptr), _size(0), _position(0), _open(false)
+{
+#ifdef _WIN32
+    _mapping = nullptr;
+    _file = CreateFileA(_fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (_file == INVALID_HANDLE_VALUE)
+    {
+        _file = nullptr;
+        return;
+    }
+
+    _open = true;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(_file, &size) || !size.QuadPart)
+        return;
+
+    _mapping = CreateFileMappingA(_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!_mapping)
+        return;
+
+    _data = static_cast<unsigned char const*>(MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0));
+    if (_data)
+        _size = std::size_t(size.QuadPart);
+#else
+    int fd = open(_fileName.c_str(), O_RDONLY);
+    if (fd < 0)
+        return;
+
+    _open = true;
+
+    struct stat fileStat;
+    if (!fstat(fd, &fileStat) && fileStat.st_size > 0)
+    {
+        void* data = mmap(nullptr, std::size_t(fileStat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data != MAP_FAILED)
+        {
+            _data = static_cast<unsigned char const*>(data);
+            _size = std::size_t(fileStat.st_size);
+            // the loader walks the file front to back exactly once
+            madvise(data, _size, MADV_SEQUENTIAL);
+        }
+    }
+
+    // the mapping stays valid after the descriptor is closed
+    close(fd);
+#endif
+}
+
+DB2MappedFileSource::~DB2MappedFileSource()
+{
+#ifdef _WIN32
+    if (_data)
+        UnmapViewOfFile(_data);
+    if (_mapping)
+        CloseHandle(_mapping);
+    if (_file)
+        CloseHandle(_file);
+#else
+    if (_data)
+        munmap(const_cast<unsigned char*>(_data), _size);
+#endif
+}
+
+bool DB2MappedFileSource::IsOpen() const
+{
+    return _open;
+}
+
+bool DB2MappedFileSource::Read(void* buffer, std::size_t numBytes)
+{
+    // zero sized reads fail like they did through fread
+    if (!numBytes || numBytes > _size - _position)
+        return false;
+
+    memcpy(buffer, _data + _position, numBytes);
+    _position += numBytes;
+    return true;
+}
+
+std::size_t DB2MappedFileSource::GetPosition() const
+{
+    return _position;
+}
+
+std::size_t DB2MappedFileSource::GetFileSize() const
+{
+    return _size;
+}
+
+char const* DB2MappedFileSource::GetFileName() const
+{
+    return _fileName.c_str();
+}
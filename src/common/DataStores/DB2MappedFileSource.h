@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2008-2018 TrinityCore <https://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DB2MappedFileSource_h__
+#define DB2MappedFileSource_h__
+
+#include "DB2FileLoader.h"
+#include <string>
+
+/// Read-only memory mapping of a db2 file, Read() is a copy out of the mapping
+/// instead of a stdio call, so several stores can be loaded side by side cheaply.
+struct TC_COMMON_API DB2MappedFileSource : public DB2FileSource
+{
+    DB2MappedFileSource(std::string const& fileName);
+    ~DB2MappedFileSource();
+
+    DB2MappedFileSource(DB2MappedFileSource const&) = delete;
+    DB2MappedFileSource& operator=(DB2MappedFileSource const&) = delete;
+
+    bool IsOpen() const override;
+    bool Read(void* buffer, std::size_t numBytes) override;
+    std::size_t GetPosition() const override;
+    std::size_t GetFileSize() const override;
+    char const* GetFileName() const override;
+
+private:
+    std::string _fileName;
+    unsigned char const* _data;
+    std::size_t _size;
+    std::size_t _position;
+    bool _open;
+#ifdef _WIN32
+    void* _file;
+    void* _mapping;
+#endif
+};
+
+#endif // DB2MappedFileSource_h__
@@ -37,6 +37,8 @@ public:
         return _callbacks.back();
     }
 
+    bool Empty() const { return _callbacks.empty(); }
+
     void ProcessReadyCallbacks()
     {
         if (_callbacks.empty())
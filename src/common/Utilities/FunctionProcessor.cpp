@@ -17,15 +17,123 @@
  */
 
 #include "FunctionProcessor.h"
+#include "NodeCacheAllocator.h"
 
-FunctionProcessor::FunctionProcessor()
+namespace
+{
+    typedef FunctionProcessor::Node Node;
+
+    uint32 const WHEEL_BITS = 4;
+    uint32 const WHEEL_SLOTS = 1 << WHEEL_BITS;
+    uint32 const WHEEL_MASK = WHEEL_SLOTS - 1;
+    uint32 const WHEEL_LEVELS = 6;                          // 16^6 ms (~4.6 hours), later ones wait in the overflow list
+
+    // nodes are recycled per thread, most callbacks are added and run on the same map thread
+    typedef Trinity::NodeCacheAllocator<Node> NodeAllocator;
+
+    void PushFront(Node*& list, Node* node)
+    {
+        node->next = list;
+        list = node;
+    }
+
+    bool RunsBefore(Node const* left, Node const* right)
+    {
+        return left->time < right->time || (left->time == right->time && left->seq < right->seq);
+    }
+
+    // stable merge sort, keeps the old multimap order (time, then insertion)
+    Node* SortList(Node* list)
+    {
+        if (!list || !list->next)
+            return list;
+
+        Node* slow = list;
+        Node* fast = list->next;
+        while (fast && fast->next)
+        {
+            slow = slow->next;
+            fast = fast->next->next;
+        }
+
+        Node* right = SortList(slow->next);
+        slow->next = nullptr;
+        Node* left = SortList(list);
+
+        Node* result = nullptr;
+        Node** tail = &result;
+        while (left && right)
+        {
+            Node*& from = RunsBefore(right, left) ? right : left;
+            *tail = from;
+            tail = &from->next;
+            from = from->next;
+        }
+        *tail = left ? left : right;
+        return result;
+    }
+
+    uint32 LowestBit(uint32 mask)
+    {
+        uint32 bit = 0;
+        while (!(mask & 1))
+        {
+            mask >>= 1;
+            ++bit;
+        }
+        return bit;
+    }
+}
+
+struct FunctionProcessor::Wheel
+{
+    Node* slots[WHEEL_LEVELS][WHEEL_SLOTS] = { };
+    uint32 used[WHEEL_LEVELS] = { };
+    Node* overflow = nullptr;
+    Node* expired = nullptr;                                // already due when scheduled
+};
+
+FunctionProcessor::FunctionProcessor() : m_time(0), m_inbox(nullptr), m_inboxSize(0), m_size(0), m_seq(0), clean(false), m_wakeHandler(nullptr), m_wakeContext(nullptr)
 {
-    m_time = 0;
-    clean = false;
 }
 
 FunctionProcessor::~FunctionProcessor()
 {
+    FreeList(m_inbox.exchange(nullptr));
+    ClearWheel();
+}
+
+FunctionProcessor::Node* FunctionProcessor::AllocateNode()
+{
+    return new (NodeAllocator().allocate(1)) Node();
+}
+
+void FunctionProcessor::FreeNode(Node* node)
+{
+    node->~Node();
+    NodeAllocator().deallocate(node, 1);
+}
+
+void FunctionProcessor::FreeList(Node* list)
+{
+    while (Node* node = list)
+    {
+        list = node->next;
+        FreeNode(node);
+    }
+}
+
+void FunctionProcessor::PushInbox(Node* node)
+{
+    Node* head = m_inbox.load(std::memory_order_relaxed);
+    do
+        node->next = head;
+    while (!m_inbox.compare_exchange_weak(head, node, std::memory_order_release, std::memory_order_relaxed));
+
+    ++m_inboxSize;
+
+    if (m_wakeHandler)
+        m_wakeHandler(m_wakeContext);
 }
 
 void FunctionProcessor::Update(uint32 p_time)
@@ -33,27 +141,24 @@ void FunctionProcessor::Update(uint32 p_time)
     //move from queue
     AddFunctionsFromQueue();
 
-    // update time
-    m_time += p_time;
+    uint64 target = m_time + p_time;
 
     if (clean)
     {
-        m_functions.clear();
+        ClearWheel();
+        m_time = target;
         clean = false;
         return;
     }
 
-    if (m_functions.empty())
+    if (!m_size)
+    {
+        m_time = target;
         return;
+    }
 
     // main event loop
-    FunctionList::iterator i;
-    while (((i = m_functions.begin()) != m_functions.end()) && i->first <= m_time)
-    {
-        // get and remove event from queue
-        i->second();
-        m_functions.erase(i);
-    }
+    Advance(target);
 }
 
 void FunctionProcessor::KillAllFunctions()
@@ -61,49 +166,200 @@ void FunctionProcessor::KillAllFunctions()
     clean = true;
 }
 
-void FunctionProcessor::AddFunction(std::function<void()> && Function, uint64 e_time)
+void FunctionProcessor::AddFunctionsFromQueue()
 {
-    std::lock_guard<std::recursive_mutex> _queue_lock(m_queue_lock);
-    m_functions_queue.insert(std::make_pair(e_time, Function));
+    Node* list = m_inbox.exchange(nullptr, std::memory_order_acquire);
+    if (!list)
+        return;
+
+    // the inbox is a stack, reverse it to keep insertion order
+    Node* ordered = nullptr;
+    while (Node* node = list)
+    {
+        list = node->next;
+        PushFront(ordered, node);
+        --m_inboxSize;
+    }
+
+    if (!m_wheel)
+        m_wheel.reset(new Wheel());
+
+    while (Node* node = ordered)
+    {
+        ordered = node->next;
+        node->seq = m_seq++;
+        Schedule(node);
+        ++m_size;
+    }
 }
 
-void FunctionProcessor::AddFunctionsFromQueue()
+void FunctionProcessor::Schedule(Node* node)
 {
-    if (m_functions_queue.empty())
+    uint64 now = m_time;
+    if (node->time <= now)
+    {
+        PushFront(m_wheel->expired, node);
         return;
+    }
+
+    // level is the highest slot digit where expire time and current time differ
+    uint32 level = 0;
+    for (uint64 diff = (node->time ^ now) >> WHEEL_BITS; diff; diff >>= WHEEL_BITS)
+        ++level;
 
-    FunctionList tempFunctions;
+    if (level >= WHEEL_LEVELS)
     {
-        std::lock_guard<std::recursive_mutex> _queue_lock(m_queue_lock);
-        std::swap(tempFunctions, m_functions_queue);
+        PushFront(m_wheel->overflow, node);
+        return;
     }
-    FunctionList::iterator itr = tempFunctions.begin();
-    for(; itr != tempFunctions.end(); ++itr)
-        m_functions.insert(std::make_pair(itr->first, itr->second));
+
+    uint32 slot = (node->time >> (level * WHEEL_BITS)) & WHEEL_MASK;
+    PushFront(m_wheel->slots[level][slot], node);
+    m_wheel->used[level] |= 1 << slot;
 }
 
-uint64 FunctionProcessor::CalculateTime(uint64 t_offset) const
+void FunctionProcessor::Cascade(uint32 level)
 {
-    return m_time + t_offset;
+    Node* list;
+    if (level == WHEEL_LEVELS)
+    {
+        list = m_wheel->overflow;
+        m_wheel->overflow = nullptr;
+    }
+    else
+    {
+        uint32 slot = (m_time >> (level * WHEEL_BITS)) & WHEEL_MASK;
+        if (!slot)
+            Cascade(level + 1);
+
+        list = m_wheel->slots[level][slot];
+        m_wheel->slots[level][slot] = nullptr;
+        m_wheel->used[level] &= ~(1 << slot);
+    }
+
+    while (Node* node = list)
+    {
+        list = node->next;
+        Schedule(node);
+    }
 }
 
-bool FunctionProcessor::Empty() const
+uint64 FunctionProcessor::NextEventTime() const
 {
-    return m_functions.empty();
+    uint64 now = m_time;
+    for (uint32 level = 0; level < WHEEL_LEVELS; ++level)
+    {
+        uint32 index = (now >> (level * WHEEL_BITS)) & WHEEL_MASK;
+        uint32 ahead = m_wheel->used[level] & ~((2u << index) - 1);
+        if (!ahead)
+            continue;
+
+        // first tick of that slot, lower levels are empty until then
+        uint32 blockBits = (level + 1) * WHEEL_BITS;
+        return ((now >> blockBits) << blockBits) | (uint64(LowestBit(ahead)) << (level * WHEEL_BITS));
+    }
+
+    uint32 const topBits = WHEEL_LEVELS * WHEEL_BITS;
+    return ((now >> topBits) + 1) << topBits;
 }
 
-uint32 FunctionProcessor::Size() const
+void FunctionProcessor::Advance(uint64 target)
+{
+    while (true)
+    {
+        if (m_wheel->expired)
+        {
+            Node* list = m_wheel->expired;
+            m_wheel->expired = nullptr;
+            RunList(list);
+        }
+
+        if (m_time >= target)
+            return;
+
+        if (!m_size)
+        {
+            m_time = target;
+            return;
+        }
+
+        // jump straight to the next tick that has work, skipped slots are all empty
+        uint64 next = NextEventTime();
+        if (next > target)
+        {
+            m_time = target;
+            return;
+        }
+
+        m_time = next;
+        if (!(next & WHEEL_MASK))
+            Cascade(1);
+
+        uint32 slot = next & WHEEL_MASK;
+        if (Node* list = m_wheel->slots[0][slot])
+        {
+            m_wheel->slots[0][slot] = nullptr;
+            m_wheel->used[0] &= ~(1 << slot);
+
+            while (Node* node = list)
+            {
+                list = node->next;
+                PushFront(m_wheel->expired, node);
+            }
+        }
+    }
+}
+
+void FunctionProcessor::RunList(Node* list)
 {
-    return m_functions.size();
+    list = SortList(list);
+    while (Node* node = list)
+    {
+        list = node->next;
+        --m_size;
+        node->function();
+        FreeNode(node);
+    }
 }
 
-uint32 FunctionProcessor::SizeQueue() const
+void FunctionProcessor::ClearWheel()
+{
+    if (!m_wheel)
+        return;
+
+    for (uint32 level = 0; level < WHEEL_LEVELS; ++level)
+    {
+        for (uint32 slot = 0; slot < WHEEL_SLOTS; ++slot)
+        {
+            FreeList(m_wheel->slots[level][slot]);
+            m_wheel->slots[level][slot] = nullptr;
+        }
+        m_wheel->used[level] = 0;
+    }
+
+    FreeList(m_wheel->overflow);
+    FreeList(m_wheel->expired);
+    m_wheel->overflow = nullptr;
+    m_wheel->expired = nullptr;
+    m_size = 0;
+}
+
+uint64 FunctionProcessor::CalculateTime(uint64 t_offset) const
 {
-    return m_functions_queue.size();
+    return m_time + t_offset;
 }
 
-void FunctionProcessor::AddDelayedEvent(uint64 t_offset, std::function<void()>&& function)
+bool FunctionProcessor::Empty() const
 {
-    AddFunction(std::move(function), m_time + t_offset);
+    return !m_size;
 }
 
+uint32 FunctionProcessor::SizeQueue() const
+{
+    return m_inboxSize;
+}
+
+uint32 FunctionProcessor::Size() const
+{
+    return m_size;
+}
@@ -20,32 +20,89 @@
 #define __FunctionProcessor_H
 
 #include "Define.h"
-#include <map>
-#include <functional>
-
-typedef std::multimap<uint64, std::function<void()>> FunctionList;
+#include "SmallFunction.h"
+#include <atomic>
+#include <memory>
 
+/*
+ * Delayed callbacks keyed by an absolute time (CalculateTime).
+ *
+ * AddFunction may be called from any thread, it pushes onto a lock-free inbox
+ * that the owner drains in Update. Pending callbacks live in a hierarchical
+ * timer wheel (levels of 16 slots, 1 ms on the first one), so insert and
+ * expire are O(1) and typical lambdas are stored inline in pooled nodes.
+ * The wheel is allocated on first use, idle owners only pay for the pointers.
+ */
 class TC_COMMON_API FunctionProcessor
 {
     public:
+        typedef Trinity::SmallFunction<48> Function;
+
+        struct Node
+        {
+            Node* next = nullptr;
+            uint64 time = 0;
+            uint32 seq = 0;
+            Function function;
+        };
+
         FunctionProcessor();
         ~FunctionProcessor();
 
+        FunctionProcessor(FunctionProcessor const&) = delete;
+        FunctionProcessor& operator=(FunctionProcessor const&) = delete;
+
         void Update(uint32 p_time);
         void KillAllFunctions();
-        void AddFunction(std::function<void()> && Function, uint64 e_time);
+
+        template <typename F>
+        void AddFunction(F&& function, uint64 e_time)
+        {
+            Node* node = AllocateNode();
+            node->time = e_time;
+            node->function = Function(std::forward<F>(function));
+            PushInbox(node);
+        }
+
+        template <typename F>
+        void AddDelayedEvent(uint64 t_offset, F&& function)
+        {
+            AddFunction(std::forward<F>(function), m_time + t_offset);
+        }
+
+        // called from the queueing thread after every AddFunction, lets an owner that sleeps until a deadline wake up
+        typedef void (*WakeHandler)(void* context);
+        void SetWakeHandler(WakeHandler handler, void* context) { m_wakeHandler = handler; m_wakeContext = context; }
+
         void AddFunctionsFromQueue();
         uint64 CalculateTime(uint64 t_offset) const;
         bool Empty() const;
         uint32 Size() const;
         uint32 SizeQueue() const;
-        void AddDelayedEvent(uint64 t_offset, std::function<void()>&& function);
 
     protected:
+        struct Wheel;
+
+        static Node* AllocateNode();
+        static void FreeNode(Node* node);
+        static void FreeList(Node* list);
+
+        void PushInbox(Node* node);
+        void Schedule(Node* node);
+        void Cascade(uint32 level);
+        void Advance(uint64 target);
+        uint64 NextEventTime() const;
+        void RunList(Node* list);
+        void ClearWheel();
+
         std::atomic<uint64> m_time;
-        FunctionList m_functions;
-        FunctionList m_functions_queue;
-        std::recursive_mutex m_queue_lock;
+        std::atomic<Node*> m_inbox;
+        std::atomic<uint32> m_inboxSize;
+        std::unique_ptr<Wheel> m_wheel;
+        uint32 m_size;
+        uint32 m_seq;
         bool clean;
+        WakeHandler m_wakeHandler;
+        void* m_wakeContext;
 };
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2008-2017 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRINITY_LATENCY_HISTOGRAM_H
+#define TRINITY_LATENCY_HISTOGRAM_H
+
+#include "Define.h"
+
+#include <array>
+#include <atomic>
+
+namespace Trinity
+{
+    /// Lock-free log-linear histogram of uint32 samples (any unit, usually microseconds).
+    /// Values below 16 get exact buckets, above that every power of two is split into
+    /// 8 sub-buckets, so a reported percentile is at most 12.5% above the real sample.
+    /// Record() may run on any thread, readers get a slightly stale but consistent-enough view.
+    class LatencyHistogram
+    {
+    public:
+        static constexpr uint32 LinearBuckets = 16;
+        static constexpr uint32 SubBuckets = 8;
+        static constexpr uint32 BucketCount = LinearBuckets + (32 - 4) * SubBuckets;
+
+        LatencyHistogram() { Reset(); }
+
+        LatencyHistogram(LatencyHistogram const&) = delete;
+        LatencyHistogram& operator=(LatencyHistogram const&) = delete;
+
+        void Record(uint32 value)
+        {
+            _buckets[BucketOf(value)].fetch_add(1, std::memory_order_relaxed);
+            _count.fetch_add(1, std::memory_order_relaxed);
+            _sum.fetch_add(value, std::memory_order_relaxed);
+
+            uint32 max = _max.load(std::memory_order_relaxed);
+            while (value > max && !_max.compare_exchange_weak(max, value, std::memory_order_relaxed))
+                ;
+        }
+
+        void Reset()
+        {
+            for (std::atomic<uint64>& bucket : _buckets)
+                bucket.store(0, std::memory_order_relaxed);
+            _count.store(0, std::memory_order_relaxed);
+            _sum.store(0, std::memory_order_relaxed);
+            _max.store(0, std::memory_order_relaxed);
+        }
+
+        uint64 GetCount() const { return _count.load(std::memory_order_relaxed); }
+        uint64 GetSum() const { return _sum.load(std::memory_order_relaxed); }
+        uint32 GetMax() const { return _max.load(std::memory_order_relaxed); }
+        uint32 GetMean() const { uint64 count = GetCount(); return count ? uint32(GetSum() / count) : 0; }
+
+        /// Upper bound of the bucket holding the given percentile (0..100), clamped to the max sample
+        uint32 GetPercentile(double percentile) const
+        {
+            uint64 count = GetCount();
+            if (!count)
+                return 0;
+
+            uint64 rank = uint64(double(count) * percentile / 100.0 + 0.5);
+            if (rank < 1)
+                rank = 1;
+
+            uint64 seen = 0;
+            for (uint32 i = 0; i < BucketCount; ++i)
+            {
+                seen += _buckets[i].load(std::memory_order_relaxed);
+                if (seen >= rank)
+                {
+                    uint32 upper = BucketUpperBound(i);
+                    uint32 max = GetMax();
+                    return upper < max ? upper : max;
+                }
+            }
+
+            return GetMax();
+        }
+
+        uint64 GetBucketCount(uint32 bucket) const { return _buckets[bucket].load(std::memory_order_relaxed); }
+
+        static uint32 BucketOf(uint32 value)
+        {
+            if (value < LinearBuckets)
+                return value;
+
+            uint32 exponent = 31 - CountLeadingZeros(value);
+            uint32 sub = (value >> (exponent - 3)) & (SubBuckets - 1);
+            return LinearBuckets + (exponent - 4) * SubBuckets + sub;
+        }
+
+        static uint32 BucketLowerBound(uint32 bucket)
+        {
+            if (bucket < LinearBuckets)
+                return bucket;
+
+            uint32 exponent = (bucket - LinearBuckets) / SubBuckets + 4;
+            uint32 sub = (bucket - LinearBuckets) % SubBuckets;
+            return (SubBuckets + sub) << (exponent - 3);
+        }
+
+        static uint32 BucketUpperBound(uint32 bucket)
+        {
+            if (bucket + 1 >= BucketCount)
+                return 0xFFFFFFFF;
+            return BucketLowerBound(bucket + 1) - 1;
+        }
+
+    private:
+        static uint32 CountLeadingZeros(uint32 value)
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return uint32(__builtin_clz(value));
+#else
+            uint32 count = 0;
+            for (uint32 bit = 0x80000000; bit && !(value & bit); bit >>= 1)
+                ++count;
+            return count;
+#endif
+        }
+
+        std::array<std::atomic<uint64>, BucketCount> _buckets;
+        std::atomic<uint64> _count;
+        std::atomic<uint64> _sum;
+        std::atomic<uint32> _max;
+    };
+}
+
+#endif
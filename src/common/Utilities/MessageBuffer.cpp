@@ -27,6 +27,10 @@ MessageBuffer::MessageBuffer(std::size_t initialSize): _wpos(0), _rpos(0), _stor
     _storage.resize(initialSize);
 }
 
+MessageBuffer::MessageBuffer(std::vector<uint8>&& storage): _wpos(0), _rpos(0), _storage(std::move(storage))
+{
+}
+
 MessageBuffer::MessageBuffer(MessageBuffer const& right): _wpos(right._wpos), _rpos(right._rpos), _storage(right._storage)
 {
 }
@@ -28,6 +28,7 @@ class TC_COMMON_API MessageBuffer
 public:
     MessageBuffer();
     explicit MessageBuffer(std::size_t initialSize);
+    explicit MessageBuffer(std::vector<uint8>&& storage);
     MessageBuffer(MessageBuffer const& right);
     MessageBuffer(MessageBuffer&& right) noexcept;
 
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2008-2017 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "MessageBufferPool.h"
+
+#include <algorithm>
+
+namespace
+{
+// buffers kept per thread and class, bounded by bytes so the large classes only hold a few
+std::size_t const ThreadCacheBytes = 256 * 1024;
+std::size_t const DepotBytes = 16 * 1024 * 1024;
+
+std::size_t GetClassSize(std::size_t sizeClass)
+{
+    return MessageBufferPool::MinClassSize << sizeClass;
+}
+
+std::array<MessageBufferPool::Pool::Limits, MessageBufferPool::SizeClassCount> GetClassLimits()
+{
+    std::array<MessageBufferPool::Pool::Limits, MessageBufferPool::SizeClassCount> limits;
+    for (std::size_t i = 0; i < MessageBufferPool::SizeClassCount; ++i)
+        limits[i] = { std::max<std::size_t>(ThreadCacheBytes / GetClassSize(i), 4), DepotBytes / GetClassSize(i) };
+    return limits;
+}
+
+// smallest class able to hold size bytes
+std::size_t GetAcquireClass(std::size_t size)
+{
+    std::size_t sizeClass = 0;
+    while (GetClassSize(sizeClass) < size)
+        ++sizeClass;
+    return sizeClass;
+}
+
+// largest class whose size fits into capacity
+std::size_t GetReleaseClass(std::size_t capacity)
+{
+    std::size_t sizeClass = 0;
+    while (sizeClass + 1 < MessageBufferPool::SizeClassCount && GetClassSize(sizeClass + 1) <= capacity)
+        ++sizeClass;
+    return sizeClass;
+}
+}
+
+MessageBufferPool::MessageBufferPool() : _pool(GetClassLimits())
+{
+}
+
+MessageBufferPool* MessageBufferPool::instance()
+{
+    static MessageBufferPool instance;
+    return &instance;
+}
+
+MessageBuffer MessageBufferPool::Acquire(std::size_t size)
+{
+    return MessageBuffer(AcquireStorage(size));
+}
+
+std::vector<uint8> MessageBufferPool::AcquireStorage(std::size_t size)
+{
+    std::vector<uint8> storage;
+    if (size > MaxClassSize)
+    {
+        storage.resize(size);
+        return storage;
+    }
+
+    std::size_t sizeClass = GetAcquireClass(size);
+    if (!_pool.Acquire(storage, sizeClass))
+        storage.reserve(GetClassSize(sizeClass));
+
+    // capacity is at least the class size, this never reallocates
+    storage.resize(size);
+    return storage;
+}
+
+void MessageBufferPool::Release(std::vector<uint8>&& storage)
+{
+    std::size_t capacity = storage.capacity();
+    if (capacity < MinClassSize || capacity >= MaxClassSize * 2)
+    {
+        if (capacity)
+            _pool.Free(std::move(storage));
+        return;
+    }
+
+    _pool.Release(std::move(storage), GetReleaseClass(capacity));
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2008-2017 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef TRINITY_MESSAGE_BUFFER_POOL_H
+#define TRINITY_MESSAGE_BUFFER_POOL_H
+
+#include "MessageBuffer.h"
+#include "ThreadCachedPool.h"
+
+#include <vector>
+
+/// Recycles the storage of network buffers. Sizes are rounded up to power of two classes,
+/// every thread keeps a small free list per class and exchanges batches with a shared depot
+/// so buffers allocated on map threads and released on network threads keep circulating.
+class TC_COMMON_API MessageBufferPool
+{
+public:
+    static std::size_t const MinClassSize = 256;
+    static std::size_t const SizeClassCount = 9;                                // 256 bytes .. 64 KiB
+    static std::size_t const MaxClassSize = MinClassSize << (SizeClassCount - 1);
+
+    typedef Trinity::ThreadCachedPool<std::vector<uint8>, MessageBufferPool, SizeClassCount> Pool;
+    typedef Pool::Stats Stats;
+
+    static MessageBufferPool* instance();
+
+    /// Returns a buffer of exactly size bytes, reusing pooled storage when possible
+    MessageBuffer Acquire(std::size_t size);
+    std::vector<uint8> AcquireStorage(std::size_t size);
+
+    void Release(MessageBuffer&& buffer) { Release(buffer.Move()); }
+    void Release(std::vector<uint8>&& storage);
+
+    Stats GetStats() const { return _pool.GetStats(); }
+
+private:
+    MessageBufferPool();
+    ~MessageBufferPool() = default;
+
+    Pool _pool;
+};
+
+#define sMessageBufferPool MessageBufferPool::instance()
+
+#endif
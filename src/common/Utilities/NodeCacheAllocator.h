@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2008-2017 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRINITY_NODE_CACHE_ALLOCATOR_H
+#define TRINITY_NODE_CACHE_ALLOCATOR_H
+
+#include "ThreadCachedPool.h"
+
+#include <cstddef>
+#include <new>
+
+namespace Trinity
+{
+    namespace Impl
+    {
+        template<std::size_t Size, std::size_t Align>
+        struct NodeCacheTag { };
+
+        /// Per thread free list of one node size, without a depot: nodes freed on another
+        /// thread than the one that allocated them simply move to that thread's list.
+        template<std::size_t Size, std::size_t Align>
+        using NodeCache = ThreadCachedPool<void*, NodeCacheTag<Size, Align>>;
+
+        template<std::size_t Size, std::size_t Align>
+        NodeCache<Size, Align>& GetNodeCache()
+        {
+            // never destroyed, static containers still free their nodes during exit
+            static NodeCache<Size, Align>* cache = new NodeCache<Size, Align>(4096, 0);
+            return *cache;
+        }
+    }
+
+    /// Allocator for node based containers (std::list, std::map, std::multimap) whose
+    /// nodes come and go at a high rate. Single node allocations are recycled through
+    /// a per thread cache keyed by node size, anything else goes to the global heap.
+    template<class T>
+    class NodeCacheAllocator
+    {
+        static constexpr std::size_t CachedSize = sizeof(T) < sizeof(void*) ? sizeof(void*) : sizeof(T);
+        static constexpr bool Cached = alignof(T) <= alignof(std::max_align_t);
+
+    public:
+        typedef T value_type;
+
+        NodeCacheAllocator() noexcept { }
+        template<class U>
+        NodeCacheAllocator(NodeCacheAllocator<U> const&) noexcept { }
+
+        T* allocate(std::size_t n)
+        {
+            if (Cached && n == 1)
+            {
+                void* node;
+                if (!Impl::GetNodeCache<CachedSize, alignof(T)>().Acquire(node))
+                    node = ::operator new(CachedSize);
+                return static_cast<T*>(node);
+            }
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        }
+
+        void deallocate(T* ptr, std::size_t n) noexcept
+        {
+            if (Cached && n == 1)
+                Impl::GetNodeCache<CachedSize, alignof(T)>().Release(ptr);
+            else
+                ::operator delete(ptr);
+        }
+
+        template<class U>
+        bool operator==(NodeCacheAllocator<U> const&) const noexcept { return true; }
+        template<class U>
+        bool operator!=(NodeCacheAllocator<U> const&) const noexcept { return false; }
+    };
+}
+
+#endif
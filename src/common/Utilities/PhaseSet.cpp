@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2008-2017 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PhaseSet.h"
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace
+{
+    // entries are never freed, handles stay valid for the whole run
+    std::mutex registryLock;
+    std::map<std::vector<uint32>, std::unique_ptr<PhaseSet::Entry>> registry;
+
+    std::vector<uint32> const emptyIds;
+    std::set<uint32> const emptyIdSet;
+}
+
+PhaseSet PhaseSet::Intern(std::set<uint32> const& ids)
+{
+    if (ids.empty())
+        return PhaseSet();
+
+    std::vector<uint32> key(ids.begin(), ids.end());
+
+    std::lock_guard<std::mutex> guard(registryLock);
+    std::unique_ptr<Entry>& entry = registry[key];
+    if (!entry)
+    {
+        entry.reset(new Entry());
+        entry->idSet = ids;
+        entry->signature = 0;
+        for (uint32 phaseId : key)
+            entry->signature |= SignatureBit(phaseId);
+        entry->ids = std::move(key);
+    }
+
+    return PhaseSet(entry.get());
+}
+
+bool PhaseSet::Contains(uint32 phaseId) const
+{
+    if (!_entry || !(_entry->signature & SignatureBit(phaseId)))
+        return false;
+
+    return std::binary_search(_entry->ids.begin(), _entry->ids.end(), phaseId);
+}
+
+bool PhaseSet::Intersects(PhaseSet other) const
+{
+    if (!_entry || !other._entry)
+        return false;
+
+    if (_entry == other._entry)
+        return true;
+
+    if (!(_entry->signature & other._entry->signature))
+        return false;
+
+    auto left = _entry->ids.begin();
+    auto right = other._entry->ids.begin();
+    while (left != _entry->ids.end() && right != other._entry->ids.end())
+    {
+        if (*left < *right)
+            ++left;
+        else if (*right < *left)
+            ++right;
+        else
+            return true;
+    }
+
+    return false;
+}
+
+bool PhaseSet::Intersects(std::set<uint32> const& ids) const
+{
+    for (uint32 phaseId : ids)
+        if (Contains(phaseId))
+            return true;
+
+    return false;
+}
+
+std::vector<uint32> const& PhaseSet::GetIds() const
+{
+    return _entry ? _entry->ids : emptyIds;
+}
+
+std::set<uint32> const& PhaseSet::GetIdSet() const
+{
+    return _entry ? _entry->idSet : emptyIdSet;
+}
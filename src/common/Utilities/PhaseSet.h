@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2008-2017 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRINITY_PHASE_SET_H
+#define TRINITY_PHASE_SET_H
+
+#include "Define.h"
+
+#include <set>
+#include <vector>
+
+/*
+ * Interned, immutable set of phase ids.
+ *
+ * Every distinct combination of phase ids is stored once for the lifetime of
+ * the process and a PhaseSet is only a pointer to it, so copying one is free,
+ * equal sets compare by address and collision queries can carry it around
+ * without allocating. Each entry keeps a 64 bit signature (one bit per id,
+ * id % 64) next to its sorted ids: disjoint signatures reject an intersection
+ * with a single AND, the sorted ids settle the rest.
+ */
+class TC_COMMON_API PhaseSet
+{
+public:
+    struct Entry
+    {
+        std::vector<uint32> ids;            // sorted, unique
+        std::set<uint32> idSet;             // same ids, for code that still wants the std::set
+        uint64 signature;
+    };
+
+    PhaseSet() : _entry(nullptr) { }
+
+    /// Finds or creates the shared entry for these ids, thread safe
+    static PhaseSet Intern(std::set<uint32> const& ids);
+
+    bool empty() const { return _entry == nullptr; }
+    std::size_t size() const { return _entry ? _entry->ids.size() : 0; }
+
+    bool Contains(uint32 phaseId) const;
+    bool Intersects(PhaseSet other) const;
+    bool Intersects(std::set<uint32> const& ids) const;
+
+    std::vector<uint32> const& GetIds() const;
+    std::set<uint32> const& GetIdSet() const;
+
+    static uint64 SignatureBit(uint32 phaseId) { return uint64(1) << (phaseId & 63); }
+
+    bool operator==(PhaseSet other) const { return _entry == other._entry; }
+    bool operator!=(PhaseSet other) const { return _entry != other._entry; }
+
+private:
+    explicit PhaseSet(Entry const* entry) : _entry(entry) { }
+
+    Entry const* _entry;                    // nullptr for the empty set
+};
+
+#endif
@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2008-2017 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRINITY_SMALL_FUNCTION_H
+#define TRINITY_SMALL_FUNCTION_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace Trinity
+{
+    /// Move-only void() callable that keeps callables up to BufferSize bytes inline.
+    /// Bigger ones (or ones that may throw on move) fall back to the heap.
+    template <std::size_t BufferSize>
+    class SmallFunction
+    {
+        enum class Op
+        {
+            Move,
+            Destroy
+        };
+
+        typedef void(*InvokeFn)(void* storage);
+        typedef void(*ManageFn)(Op op, void* storage, void* target);
+
+        template <typename F>
+        static constexpr bool IsInline = sizeof(F) <= BufferSize && alignof(F) <= alignof(std::max_align_t) && std::is_nothrow_move_constructible<F>::value;
+
+    public:
+        SmallFunction() : _invoke(nullptr), _manage(nullptr) { }
+
+        template <typename F, typename = std::enable_if_t<!std::is_same<std::decay_t<F>, SmallFunction>::value>>
+        SmallFunction(F&& function) : _invoke(nullptr), _manage(nullptr)
+        {
+            Assign(std::forward<F>(function));
+        }
+
+        SmallFunction(SmallFunction&& other) noexcept : _invoke(other._invoke), _manage(other._manage)
+        {
+            if (_manage)
+                _manage(Op::Move, &other._storage, &_storage);
+            other._invoke = nullptr;
+            other._manage = nullptr;
+        }
+
+        SmallFunction& operator=(SmallFunction&& other) noexcept
+        {
+            if (this != &other)
+            {
+                Reset();
+                _invoke = other._invoke;
+                _manage = other._manage;
+                if (_manage)
+                    _manage(Op::Move, &other._storage, &_storage);
+                other._invoke = nullptr;
+                other._manage = nullptr;
+            }
+            return *this;
+        }
+
+        SmallFunction(SmallFunction const&) = delete;
+        SmallFunction& operator=(SmallFunction const&) = delete;
+
+        ~SmallFunction() { Reset(); }
+
+        void operator()() { _invoke(&_storage); }
+
+        explicit operator bool() const { return _invoke != nullptr; }
+
+        void Reset()
+        {
+            if (_manage)
+                _manage(Op::Destroy, &_storage, nullptr);
+            _invoke = nullptr;
+            _manage = nullptr;
+        }
+
+    private:
+        template <typename F>
+        void Assign(F&& function)
+        {
+            typedef std::decay_t<F> Functor;
+
+            if constexpr (IsInline<Functor>)
+            {
+                new (&_storage) Functor(std::forward<F>(function));
+                _invoke = [](void* storage) { (*static_cast<Functor*>(storage))(); };
+                _manage = [](Op op, void* storage, void* target)
+                {
+                    Functor* functor = static_cast<Functor*>(storage);
+                    if (op == Op::Move)
+                        new (target) Functor(std::move(*functor));
+                    functor->~Functor();
+                };
+            }
+            else
+            {
+                *reinterpret_cast<Functor**>(&_storage) = new Functor(std::forward<F>(function));
+                _invoke = [](void* storage) { (**static_cast<Functor**>(storage))(); };
+                _manage = [](Op op, void* storage, void* target)
+                {
+                    Functor** functor = static_cast<Functor**>(storage);
+                    if (op == Op::Move)
+                        *static_cast<Functor**>(target) = *functor;
+                    else
+                        delete *functor;
+                };
+            }
+        }
+
+        InvokeFn _invoke;
+        ManageFn _manage;
+        std::aligned_storage_t<BufferSize, alignof(std::max_align_t)> _storage;
+    };
+}
+
+#endif
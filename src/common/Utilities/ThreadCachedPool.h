@@ -0,0 +1,253 @@
+/*
+ * Copyright (C) 2008-2017 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRINITY_THREAD_CACHED_POOL_H
+#define TRINITY_THREAD_CACHED_POOL_H
+
+#include "Define.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <iterator>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace Trinity
+{
+    /// Recycles items (raw blocks from ::operator new or buffers owning their storage) through a
+    /// per thread free list per size class. Threads exchange batches with a shared depot, so items
+    /// allocated on one thread and released on another keep circulating. A depot limit of 0 keeps
+    /// items on their thread, a full thread list then frees half of itself.
+    ///
+    /// Tag selects the thread caches, every pool needs its own tag. Releases after the thread
+    /// cache was destroyed (static owners during exit) free the item directly.
+    template<class T, class Tag, std::size_t ClassCount = 1>
+    class ThreadCachedPool
+    {
+    public:
+        struct Limits
+        {
+            std::size_t Thread;     // items kept per thread
+            std::size_t Depot;      // items kept in the shared depot
+        };
+
+        struct Stats
+        {
+            uint64 Allocated;       // acquires that found neither a thread cache nor a depot item
+            uint64 DepotFetched;    // items moved from the depot to a thread cache
+            uint64 DepotReturned;   // items moved from a thread cache to the depot
+            uint64 Freed;           // items dropped because the depot was full or they did not fit the pool
+            std::array<std::size_t, ClassCount> DepotSize;
+        };
+
+        ThreadCachedPool(std::size_t threadLimit, std::size_t depotLimit)
+        {
+            _limits.fill({ threadLimit, depotLimit });
+        }
+
+        explicit ThreadCachedPool(std::array<Limits, ClassCount> const& limits) : _limits(limits) { }
+
+        ~ThreadCachedPool()
+        {
+            for (std::vector<T>& depot : _depot)
+                for (T& item : depot)
+                    Dispose(item);
+        }
+
+        ThreadCachedPool(ThreadCachedPool const&) = delete;
+        ThreadCachedPool& operator=(ThreadCachedPool const&) = delete;
+
+        /// False if no pooled item was available, the caller allocates a new one then
+        bool Acquire(T& item, std::size_t sizeClass = 0)
+        {
+            if (_threadCacheDestroyed)
+            {
+                ++_allocated;
+                return false;
+            }
+
+            std::vector<T>& cache = GetThreadCache().FreeLists[sizeClass];
+            if (cache.empty() && _limits[sizeClass].Depot)
+            {
+                // may throw here, before anything moved, instead of in the middle of the fetch
+                cache.reserve(_limits[sizeClass].Thread);
+                FetchFromDepot(sizeClass, cache, _limits[sizeClass].Thread / 2);
+            }
+
+            if (cache.empty())
+            {
+                ++_allocated;
+                return false;
+            }
+
+            item = std::move(cache.back());
+            cache.pop_back();
+            return true;
+        }
+
+        /// Never throws, it is called from deallocation functions. The thread list is reserved
+        /// up to its limit on first use, if that fails the item is freed instead
+        void Release(T&& item, std::size_t sizeClass = 0) noexcept
+        {
+            if (_threadCacheDestroyed)
+            {
+                Free(std::move(item));
+                return;
+            }
+
+            std::vector<T>& cache = GetThreadCache().FreeLists[sizeClass];
+            std::size_t limit = _limits[sizeClass].Thread;
+            if (cache.size() >= limit)
+                ReturnToDepot(sizeClass, cache, std::max<std::size_t>(limit / 2, 1));
+
+            if (cache.size() == cache.capacity() && !Reserve(cache, std::max<std::size_t>(limit, 1)))
+            {
+                Free(std::move(item));
+                return;
+            }
+
+            cache.push_back(std::move(item));
+        }
+
+        /// Drops an item that is not pooled
+        void Free(T&& item) noexcept
+        {
+            ++_freed;
+            Dispose(item);
+        }
+
+        Stats GetStats() const
+        {
+            Stats stats;
+            stats.Allocated = _allocated;
+            stats.DepotFetched = _depotFetched;
+            stats.DepotReturned = _depotReturned;
+            stats.Freed = _freed;
+
+            std::lock_guard<std::mutex> lock(_depotLock);
+            for (std::size_t i = 0; i < ClassCount; ++i)
+                stats.DepotSize[i] = _depot[i].size();
+
+            return stats;
+        }
+
+    private:
+        struct ThreadCache
+        {
+            ~ThreadCache()
+            {
+                for (std::vector<T>& list : FreeLists)
+                    for (T& item : list)
+                        Dispose(item);
+
+                // trivially destructible, stays readable while the other thread locals go away
+                _threadCacheDestroyed = true;
+            }
+
+            std::array<std::vector<T>, ClassCount> FreeLists;
+        };
+
+        static ThreadCache& GetThreadCache()
+        {
+            thread_local ThreadCache cache;
+            return cache;
+        }
+
+        static bool Reserve(std::vector<T>& list, std::size_t size) noexcept
+        {
+            try
+            {
+                list.reserve(size);
+                return true;
+            }
+            catch (std::bad_alloc const&)
+            {
+                return false;
+            }
+        }
+
+        static void Dispose(T& item) noexcept
+        {
+            if constexpr (std::is_same<T, void*>::value)
+                ::operator delete(item);
+            else
+                item = T();
+        }
+
+        void FetchFromDepot(std::size_t sizeClass, std::vector<T>& cache, std::size_t count)
+        {
+            std::lock_guard<std::mutex> lock(_depotLock);
+            std::vector<T>& depot = _depot[sizeClass];
+            count = std::min(count, depot.size());
+            if (!count)
+                return;
+
+            std::move(depot.end() - count, depot.end(), std::back_inserter(cache));
+            depot.resize(depot.size() - count);
+            _depotFetched += count;
+        }
+
+        void ReturnToDepot(std::size_t sizeClass, std::vector<T>& cache, std::size_t count) noexcept
+        {
+            count = std::min(count, cache.size());
+
+            if (std::size_t depotLimit = _limits[sizeClass].Depot)
+            {
+                std::lock_guard<std::mutex> lock(_depotLock);
+                std::vector<T>& depot = _depot[sizeClass];
+                std::size_t accepted = std::min(count, depotLimit - std::min(depotLimit, depot.size()));
+
+                // grown before moving, so a failed allocation leaves both lists intact
+                if (depot.size() + accepted > depot.capacity() &&
+                    !Reserve(depot, std::min(depotLimit, std::max(depot.size() + accepted, depot.capacity() * 2))))
+                    accepted = 0;
+
+                std::move(cache.end() - accepted, cache.end(), std::back_inserter(depot));
+                cache.resize(cache.size() - accepted);
+                _depotReturned += accepted;
+                count -= accepted;
+            }
+
+            // depot is full, the rest goes back to the heap outside of the lock
+            for (std::size_t i = cache.size() - count; i < cache.size(); ++i)
+                Dispose(cache[i]);
+
+            _freed += count;
+            cache.resize(cache.size() - count);
+        }
+
+        static thread_local bool _threadCacheDestroyed;
+
+        std::array<Limits, ClassCount> _limits;
+
+        std::array<std::vector<T>, ClassCount> _depot;
+        mutable std::mutex _depotLock;
+
+        std::atomic<uint64> _allocated{ 0 };
+        std::atomic<uint64> _depotFetched{ 0 };
+        std::atomic<uint64> _depotReturned{ 0 };
+        std::atomic<uint64> _freed{ 0 };
+    };
+
+    template<class T, class Tag, std::size_t ClassCount>
+    thread_local bool ThreadCachedPool<T, Tag, ClassCount>::_threadCacheDestroyed = false;
+}
+
+#endif
@@ -142,7 +142,7 @@ void DynamicMapTree::update(uint32 t_diff)
 
 struct DynamicTreeIntersectionCallback
 {
-    DynamicTreeIntersectionCallback(std::set<uint32> const& phases, bool otherUsePlayerPhasingRules) : _didHit(false), _phases(phases), _otherUsePlayerPhasingRules(otherUsePlayerPhasingRules), _go(nullptr) { }
+    DynamicTreeIntersectionCallback(PhaseSet phases, bool otherUsePlayerPhasingRules) : _didHit(false), _phases(phases), _otherUsePlayerPhasingRules(otherUsePlayerPhasingRules), _go(nullptr) { }
 
     bool operator()(G3D::Ray const& r, GameObjectModel const& obj, float& distance)
     {
@@ -161,13 +161,13 @@ struct DynamicTreeIntersectionCallback
 
 private:
     bool _didHit;
-    std::set<uint32> _phases;
+    PhaseSet _phases;
     bool _otherUsePlayerPhasingRules;
 };
 
 struct DynamicTreeisInLineOfSightCallback
 {
-    DynamicTreeisInLineOfSightCallback(std::set<uint32> const& phases, bool otherUsePlayerPhasingRules) : _didHit(false), _phases(phases), _otherUsePlayerPhasingRules(otherUsePlayerPhasingRules), _go(nullptr) { }
+    DynamicTreeisInLineOfSightCallback(PhaseSet phases, bool otherUsePlayerPhasingRules) : _didHit(false), _phases(phases), _otherUsePlayerPhasingRules(otherUsePlayerPhasingRules), _go(nullptr) { }
 
     bool operator()(G3D::Ray const& r, GameObjectModel const& obj, float& distance)
     {
@@ -182,13 +182,13 @@ struct DynamicTreeisInLineOfSightCallback
 
 private:
     bool _didHit;
-    std::set<uint32> _phases;
+    PhaseSet _phases;
     bool _otherUsePlayerPhasingRules;
 };
 
 struct DynamicTreeAreaInfoCallback
 {
-    DynamicTreeAreaInfoCallback(std::set<uint32> const& phases, bool otherUsePlayerPhasingRules) : _phases(phases), _otherUsePlayerPhasingRules(otherUsePlayerPhasingRules) {}
+    DynamicTreeAreaInfoCallback(PhaseSet phases, bool otherUsePlayerPhasingRules) : _phases(phases), _otherUsePlayerPhasingRules(otherUsePlayerPhasingRules) {}
 
     void operator()(G3D::Vector3 const& p, GameObjectModel const& obj)
     {
@@ -198,12 +198,12 @@ struct DynamicTreeAreaInfoCallback
     VMAP::AreaInfo const& GetAreaInfo() const { return _areaInfo; }
 
 private:
-    std::set<uint32> _phases;
+    PhaseSet _phases;
     VMAP::AreaInfo _areaInfo;
     bool _otherUsePlayerPhasingRules;
 };
 
-bool DynamicMapTree::getIntersectionTime(std::set<uint32> const& phases, bool otherUsePlayerPhasingRules, G3D::Ray const& ray, G3D::Vector3 const& endPos, float& maxDist, DynamicTreeCallback* dCallback) const
+bool DynamicMapTree::getIntersectionTime(PhaseSet phases, bool otherUsePlayerPhasingRules, G3D::Ray const& ray, G3D::Vector3 const& endPos, float& maxDist, DynamicTreeCallback* dCallback) const
 {
     float distance = maxDist;
     DynamicTreeIntersectionCallback callback(phases, otherUsePlayerPhasingRules);
@@ -218,7 +218,7 @@ bool DynamicMapTree::getIntersectionTime(std::set<uint32> const& phases, bool ot
     return callback.didHit();
 }
 
-bool DynamicMapTree::getObjectHitPos(std::set<uint32> const& phases, bool otherUsePlayerPhasingRules, G3D::Vector3 const& startPos, G3D::Vector3 const& endPos, G3D::Vector3& resultHitPos, float modifyDist, DynamicTreeCallback* dCallback) const
+bool DynamicMapTree::getObjectHitPos(PhaseSet phases, bool otherUsePlayerPhasingRules, G3D::Vector3 const& startPos, G3D::Vector3 const& endPos, G3D::Vector3& resultHitPos, float modifyDist, DynamicTreeCallback* dCallback) const
 {
     bool result = false;
     float maxDist = (endPos - startPos).magnitude();
@@ -258,7 +258,7 @@ bool DynamicMapTree::getObjectHitPos(std::set<uint32> const& phases, bool otherU
     return result;
 }
 
-bool DynamicMapTree::isInLineOfSight(G3D::Vector3 const& startPos, G3D::Vector3 const& endPos, std::set<uint32> const& phases, bool otherUsePlayerPhasingRules, DynamicTreeCallback* dCallback) const
+bool DynamicMapTree::isInLineOfSight(G3D::Vector3 const& startPos, G3D::Vector3 const& endPos, PhaseSet phases, bool otherUsePlayerPhasingRules, DynamicTreeCallback* dCallback) const
 {
     float maxDist = (endPos - startPos).magnitude();
 
@@ -277,7 +277,7 @@ bool DynamicMapTree::isInLineOfSight(G3D::Vector3 const& startPos, G3D::Vector3
     return !callback.didHit();
 }
 
-float DynamicMapTree::getHeight(float x, float y, float z, float maxSearchDist, std::set<uint32> const& phases, bool otherUsePlayerPhasingRules, DynamicTreeCallback* dCallback) const
+float DynamicMapTree::getHeight(float x, float y, float z, float maxSearchDist, PhaseSet phases, bool otherUsePlayerPhasingRules, DynamicTreeCallback* dCallback) const
 {
     G3D::Vector3 v(x, y, z + 0.5f);
     G3D::Ray r(v, G3D::Vector3(0, 0, -1));
@@ -295,7 +295,7 @@ float DynamicMapTree::getHeight(float x, float y, float z, float maxSearchDist,
         return -G3D::finf();
 }
 
-bool DynamicMapTree::getAreaInfo(float x, float y, float& z, std::set<uint32> const& phases, bool otherUsePlayerPhasingRules, uint32& flags, int32& adtId, int32& rootId, int32& groupId) const
+bool DynamicMapTree::getAreaInfo(float x, float y, float& z, PhaseSet phases, bool otherUsePlayerPhasingRules, uint32& flags, int32& adtId, int32& rootId, int32& groupId) const
 {
     G3D::Vector3 v(x, y, z + 0.5f);
     DynamicTreeAreaInfoCallback intersectionCallBack(phases, otherUsePlayerPhasingRules);
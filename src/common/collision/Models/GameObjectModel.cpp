@@ -161,7 +161,7 @@ GameObjectModel* GameObjectModel::Create(std::unique_ptr<GameObjectModelOwnerBas
     return mdl;
 }
 
-bool GameObjectModel::intersectRay(G3D::Ray const& ray, float& maxDist, bool stopAtFirstHit, std::set<uint32> const& phases, bool otherUsePlayerPhasingRules, VMAP::ModelIgnoreFlags ignoreFlags) const
+bool GameObjectModel::intersectRay(G3D::Ray const& ray, float& maxDist, bool stopAtFirstHit, PhaseSet phases, bool otherUsePlayerPhasingRules, VMAP::ModelIgnoreFlags ignoreFlags) const
 {
     if (!isCollisionEnabled() || !owner->IsSpawned())
         return false;
@@ -186,7 +186,7 @@ bool GameObjectModel::intersectRay(G3D::Ray const& ray, float& maxDist, bool sto
     return hit;
 }
 
-void GameObjectModel::intersectPoint(G3D::Vector3 const& point, VMAP::AreaInfo& info,  std::set<uint32> const& phases, bool otherUsePlayerPhasingRules) const
+void GameObjectModel::intersectPoint(G3D::Vector3 const& point, VMAP::AreaInfo& info,  PhaseSet phases, bool otherUsePlayerPhasingRules) const
 {
     if (!isCollisionEnabled() || !owner->IsSpawned() || !isMapObject())
         return;
@@ -213,7 +213,7 @@ void GameObjectModel::intersectPoint(G3D::Vector3 const& point, VMAP::AreaInfo&
     }
 }
 
-bool GameObjectModel::getObjectHitPos(std::set<uint32> const& phases, bool otherUsePlayerPhasingRules, G3D::Vector3 const& startPos, G3D::Vector3 const& endPos, G3D::Vector3& resultHitPos, float modifyDist) const
+bool GameObjectModel::getObjectHitPos(PhaseSet phases, bool otherUsePlayerPhasingRules, G3D::Vector3 const& startPos, G3D::Vector3 const& endPos, G3D::Vector3& resultHitPos, float modifyDist) const
 {
     bool result = false;
     float maxDist = (endPos - startPos).magnitude();
@@ -253,7 +253,7 @@ bool GameObjectModel::getObjectHitPos(std::set<uint32> const& phases, bool other
     return result;
 }
 
-bool GameObjectModel::isInLineOfSight(G3D::Vector3 const& startPos, G3D::Vector3 const& endPos, std::set<uint32> const& phases, bool otherUsePlayerPhasingRules) const
+bool GameObjectModel::isInLineOfSight(G3D::Vector3 const& startPos, G3D::Vector3 const& endPos, PhaseSet phases, bool otherUsePlayerPhasingRules) const
 {
     float maxDist = (endPos - startPos).magnitude();
 
@@ -278,7 +278,7 @@ bool GameObjectModel::isInLineOfSight(G3D::Vector3 const& startPos, G3D::Vector3
     return !hit;
 }
 
-float GameObjectModel::getHeight(float x, float y, float z, float maxSearchDist, std::set<uint32> const& phases, bool otherUsePlayerPhasingRules) const
+float GameObjectModel::getHeight(float x, float y, float z, float maxSearchDist, PhaseSet phases, bool otherUsePlayerPhasingRules) const
 {
     G3D::Vector3 v(x, y, z + 0.5f);
     G3D::Ray ray(v, G3D::Vector3(0, 0, -1));
@@ -27,6 +27,7 @@
 #include "Implementation/HotfixDatabase.h"
 
 #include "Field.h"
+#include "PreparedResultStream.h"
 #include "PreparedStatement.h"
 #include "QueryCallback.h"
 #include "QueryResult.h"
@@ -42,6 +42,7 @@ using LoginDatabasePreparedStatement = PreparedStatement<LoginDatabaseConnection
 using WorldDatabasePreparedStatement = PreparedStatement<WorldDatabaseConnection>;
 
 class PreparedResultSet;
+class PreparedResultStream;
 using PreparedQueryResult = std::shared_ptr<PreparedResultSet>;
 
 class QueryCallback;
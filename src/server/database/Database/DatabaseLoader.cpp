@@ -22,6 +22,7 @@
 #include "Log.h"
 
 #include <mysqld_error.h>
+#include <array>
 
 DatabaseLoader::DatabaseLoader(std::string const& logger, uint32 const defaultUpdateMask)
     : _logger(logger), _autoSetup(sConfigMgr->GetBoolDefault("Updates.AutoSetup", true)),
@@ -54,6 +55,28 @@ DatabaseLoader& DatabaseLoader::AddDatabase(DatabaseWorkerPool<T>& pool, std::st
         uint8 const synchThreads = uint8(sConfigMgr->GetIntDefault(name + "Database.SynchThreads", 1));
 
         pool.SetConnectionInfo(dbString, asyncThreads, synchThreads);
+
+        std::array<std::pair<DatabaseQueueLane, char const*>, 3> const lanes =
+        { {
+            { DATABASE_LANE_LOGIN, "Database.LoginWorkerThreads" },
+            { DATABASE_LANE_SAVE, "Database.SaveWorkerThreads" },
+            { DATABASE_LANE_LOG, "Database.LogWorkerThreads" }
+        } };
+
+        for (auto const& [lane, key] : lanes)
+        {
+            uint8 const laneThreads = uint8(sConfigMgr->GetIntDefault(name + key, 0));
+            if (laneThreads > 8)
+            {
+                TC_LOG_ERROR(_logger, "%s%s: invalid number of worker threads specified. "
+                    "Please pick a value between 0 and 8.", name.c_str(), key);
+                return false;
+            }
+
+            pool.SetLaneWorkerThreads(lane, laneThreads);
+        }
+
+        pool.SetBackpressureQueueSize(sConfigMgr->GetIntDefault(name + "Database.BackpressureQueueSize", 1000));
         if (uint32 error = pool.Open())
         {
             // Database does not exist
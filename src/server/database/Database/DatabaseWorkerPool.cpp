@@ -26,6 +26,7 @@
 #include "Implementation/HotfixDatabase.h"
 #include "Log.h"
 #include "MySQLPreparedStatement.h"
+#include "PreparedResultStream.h"
 #include "PreparedStatement.h"
 #include "ProducerConsumerQueue.h"
 #include "QueryCallback.h"
@@ -34,6 +35,7 @@
 #include "Transaction.h"
 #include "MySQLWorkaround.h"
 #include <boost/asio/use_future.hpp>
+#include <bit>
 #include <mysqld_error.h>
 #include <utility>
 #ifdef TRINITY_DEBUG
@@ -62,26 +64,24 @@ thread_local bool WarnSyncQueries = false;
 template<typename T>
 struct DatabaseWorkerPool<T>::QueueSizeTracker
 {
-    explicit QueueSizeTracker(DatabaseWorkerPool* pool) : _pool(pool)
+    explicit QueueSizeTracker(DatabaseWorkerPool* pool, DatabaseQueueLane lane = DATABASE_LANE_INTERACTIVE) : _pool(pool), _lane(lane),
+        _queued(std::chrono::steady_clock::now())
     {
-        ++_pool->_queueSize;
+        Increment();
     }
 
-    QueueSizeTracker(QueueSizeTracker const& other) : _pool(other._pool) { ++_pool->_queueSize; }
-    QueueSizeTracker(QueueSizeTracker&& other) noexcept : _pool(std::exchange(other._pool, nullptr)) { }
+    QueueSizeTracker(QueueSizeTracker const& other) : _pool(other._pool), _lane(other._lane), _queued(other._queued) { Increment(); }
+    QueueSizeTracker(QueueSizeTracker&& other) noexcept : _pool(std::exchange(other._pool, nullptr)), _lane(other._lane), _queued(other._queued) { }
 
     QueueSizeTracker& operator=(QueueSizeTracker const& other)
     {
         if (this != &other)
         {
-            if (_pool != other._pool)
-            {
-                if (_pool)
-                    --_pool->_queueSize;
-                if (other._pool)
-                    ++other._pool->_queueSize;
-            }
+            Decrement();
             _pool = other._pool;
+            _lane = other._lane;
+            _queued = other._queued;
+            Increment();
         }
         return *this;
     }
@@ -89,29 +89,64 @@ struct DatabaseWorkerPool<T>::QueueSizeTracker
     {
         if (this != &other)
         {
-            if (_pool != other._pool)
-            {
-                if (_pool)
-                    --_pool->_queueSize;
-            }
+            Decrement();
             _pool = std::exchange(other._pool, nullptr);
+            _lane = other._lane;
+            _queued = other._queued;
         }
         return *this;
     }
 
     ~QueueSizeTracker()
     {
-        if (_pool)
-            --_pool->_queueSize;
+        Decrement();
+    }
+
+    //! Called by the worker when it starts the task, records how long it waited in the queue
+    void Start() const
+    {
+        if (!_pool)
+            return;
+
+        uint64 waited = uint64(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - _queued).count());
+        size_t bucket = std::min<size_t>(std::bit_width(waited), DatabaseQueueStats::LatencyBuckets - 1);
+
+        Lane& lane = _pool->_lanes[_lane];
+        ++lane.Executed;
+        ++lane.Latency[bucket];
     }
 
 private:
+    void Increment()
+    {
+        if (!_pool)
+            return;
+
+        ++_pool->_queueSize;
+        Lane& lane = _pool->_lanes[_lane];
+        size_t depth = ++lane.Depth;
+        size_t peak = lane.PeakDepth;
+        while (depth > peak && !lane.PeakDepth.compare_exchange_weak(peak, depth))
+            ;
+    }
+
+    void Decrement()
+    {
+        if (!_pool)
+            return;
+
+        --_pool->_queueSize;
+        --_pool->_lanes[_lane].Depth;
+    }
+
     DatabaseWorkerPool* _pool;
+    DatabaseQueueLane _lane;
+    std::chrono::steady_clock::time_point _queued;
 };
 
 template <class T>
 DatabaseWorkerPool<T>::DatabaseWorkerPool()
-    : _async_threads(0), _synch_threads(0)
+    : _queueSize(0), _backpressureQueueSize(0), _async_threads(0), _synch_threads(0)
 {
     WPFatal(mysql_thread_safe(), "Used MySQL library isn't thread-safe.");
 
@@ -137,6 +172,15 @@ void DatabaseWorkerPool<T>::SetConnectionInfo(std::string const& infoString,
 
     _async_threads = asyncThreads;
     _synch_threads = synchThreads;
+    _lanes[DATABASE_LANE_INTERACTIVE].WorkerThreads = asyncThreads;
+}
+
+template <class T>
+void DatabaseWorkerPool<T>::SetLaneWorkerThreads(DatabaseQueueLane lane, uint8 threads)
+{
+    // the interactive lane is sized by SetConnectionInfo and must always have workers
+    if (lane != DATABASE_LANE_INTERACTIVE)
+        _lanes[lane].WorkerThreads = threads;
 }
 
 template <class T>
@@ -148,9 +192,20 @@ uint32 DatabaseWorkerPool<T>::Open()
         "Asynchronous connections: %u, synchronous connections: %u.",
         GetDatabaseName(), _async_threads, _synch_threads);
 
-    _ioContext = std::make_unique<Trinity::Asio::IoContext>(_async_threads);
+    uint32 asyncConnections = 0;
+    for (uint8 i = 0; i < MAX_DATABASE_LANES; ++i)
+    {
+        if (!_lanes[i].WorkerThreads)
+            continue;
+
+        _lanes[i].IoContext = std::make_unique<Trinity::Asio::IoContext>(_lanes[i].WorkerThreads);
+        asyncConnections += _lanes[i].WorkerThreads;
 
-    uint32 error = OpenConnections(IDX_ASYNC, _async_threads);
+        if (i != DATABASE_LANE_INTERACTIVE)
+            TC_LOG_INFO("sql.driver", "DatabasePool '%s' lane %u has %u own asynchronous connections.", GetDatabaseName(), uint32(i), uint32(_lanes[i].WorkerThreads));
+    }
+
+    uint32 error = OpenConnections(IDX_ASYNC, uint8(asyncConnections));
 
     if (error)
         return error;
@@ -160,8 +215,10 @@ uint32 DatabaseWorkerPool<T>::Open()
     if (error)
         return error;
 
-    for (std::unique_ptr<T> const& connection : _connections[IDX_ASYNC])
-        connection->StartWorkerThread(_ioContext.get());
+    auto connection = _connections[IDX_ASYNC].begin();
+    for (Lane& lane : _lanes)
+        for (uint8 i = 0; i < lane.WorkerThreads; ++i, ++connection)
+            (*connection)->StartWorkerThread(lane.IoContext.get());
 
     TC_LOG_INFO("sql.driver", "DatabasePool '%s' opened successfully. "
         "%zu total connections running.", GetDatabaseName(),
@@ -175,13 +232,15 @@ void DatabaseWorkerPool<T>::Close()
 {
     TC_LOG_INFO("sql.driver", "Closing down DatabasePool '%s'.", GetDatabaseName());
 
-    if (_ioContext)
-        _ioContext->stop();
+    for (Lane& lane : _lanes)
+        if (lane.IoContext)
+            lane.IoContext->stop();
 
     //! Closes the actualy MySQL connection.
     _connections[IDX_ASYNC].clear();
 
-    _ioContext.reset();
+    for (Lane& lane : _lanes)
+        lane.IoContext.reset();
 
     TC_LOG_INFO("sql.driver", "Asynchronous connections on DatabasePool '%s' terminated. "
                 "Proceeding with synchronous connections.",
@@ -266,10 +325,23 @@ PreparedQueryResult DatabaseWorkerPool<T>::Query(PreparedStatement<T>* stmt)
 }
 
 template <class T>
-QueryCallback DatabaseWorkerPool<T>::AsyncQuery(char const* sql)
+bool DatabaseWorkerPool<T>::StreamQuery(PreparedStatement<T>* stmt, PreparedResultStream& stream)
+{
+    //! connection is unlocked by the stream
+    bool ret = stream.Open(GetFreeConnection(), stmt);
+
+    //! Delete proxy-class. Not needed anymore
+    delete stmt;
+
+    return ret;
+}
+
+template <class T>
+QueryCallback DatabaseWorkerPool<T>::AsyncQuery(char const* sql, DatabaseQueueLane lane /*= DATABASE_LANE_INTERACTIVE*/)
 {
-    std::future<QueryResult> result = boost::asio::post(_ioContext->get_executor(), boost::asio::use_future([this, sql = std::string(sql), tracker = QueueSizeTracker(this)]
+    std::future<QueryResult> result = boost::asio::post(GetIoContext(lane).get_executor(), boost::asio::use_future([this, sql = std::string(sql), tracker = QueueSizeTracker(this, lane)]
     {
+        tracker.Start();
         T* conn = GetAsyncConnectionForCurrentThread();
         return BasicStatementTask::Query(conn, sql.c_str());
     }));
@@ -277,10 +349,11 @@ QueryCallback DatabaseWorkerPool<T>::AsyncQuery(char const* sql)
 }
 
 template <class T>
-QueryCallback DatabaseWorkerPool<T>::AsyncQuery(PreparedStatement<T>* stmt)
+QueryCallback DatabaseWorkerPool<T>::AsyncQuery(PreparedStatement<T>* stmt, DatabaseQueueLane lane /*= DATABASE_LANE_INTERACTIVE*/)
 {
-    std::future<PreparedQueryResult> result = boost::asio::post(_ioContext->get_executor(), boost::asio::use_future([this, stmt = std::unique_ptr<PreparedStatement<T>>(stmt), tracker = QueueSizeTracker(this)]
+    std::future<PreparedQueryResult> result = boost::asio::post(GetIoContext(lane).get_executor(), boost::asio::use_future([this, stmt = std::unique_ptr<PreparedStatement<T>>(stmt), tracker = QueueSizeTracker(this, lane)]
     {
+        tracker.Start();
         T* conn = GetAsyncConnectionForCurrentThread();
         return PreparedStatementTask::Query(conn, stmt.get());
     }));
@@ -288,10 +361,11 @@ QueryCallback DatabaseWorkerPool<T>::AsyncQuery(PreparedStatement<T>* stmt)
 }
 
 template <class T>
-SQLQueryHolderCallback DatabaseWorkerPool<T>::DelayQueryHolder(std::shared_ptr<SQLQueryHolder<T>> holder)
+SQLQueryHolderCallback DatabaseWorkerPool<T>::DelayQueryHolder(std::shared_ptr<SQLQueryHolder<T>> holder, DatabaseQueueLane lane /*= DATABASE_LANE_INTERACTIVE*/)
 {
-    std::future<void> result = boost::asio::post(_ioContext->get_executor(), boost::asio::use_future([this, holder, tracker = QueueSizeTracker(this)]
+    std::future<void> result = boost::asio::post(GetIoContext(lane).get_executor(), boost::asio::use_future([this, holder, tracker = QueueSizeTracker(this, lane)]
     {
+        tracker.Start();
         T* conn = GetAsyncConnectionForCurrentThread();
         SQLQueryHolderTask::Execute(conn, holder.get());
     }));
@@ -305,7 +379,7 @@ SQLTransaction<T> DatabaseWorkerPool<T>::BeginTransaction()
 }
 
 template <class T>
-void DatabaseWorkerPool<T>::CommitTransaction(SQLTransaction<T> transaction)
+void DatabaseWorkerPool<T>::CommitTransaction(SQLTransaction<T> transaction, DatabaseQueueLane lane /*= DATABASE_LANE_INTERACTIVE*/)
 {
 #ifdef TRINITY_DEBUG
     //! Only analyze transaction weaknesses in Debug mode.
@@ -324,15 +398,16 @@ void DatabaseWorkerPool<T>::CommitTransaction(SQLTransaction<T> transaction)
     }
 #endif // TRINITY_DEBUG
 
-    boost::asio::post(_ioContext->get_executor(), [this, transaction, tracker = QueueSizeTracker(this)]
+    boost::asio::post(GetIoContext(lane).get_executor(), [this, transaction, tracker = QueueSizeTracker(this, lane)]
     {
+        tracker.Start();
         T* conn = GetAsyncConnectionForCurrentThread();
         TransactionTask::Execute(conn, transaction);
     });
 }
 
 template <class T>
-TransactionCallback DatabaseWorkerPool<T>::AsyncCommitTransaction(SQLTransaction<T> transaction)
+TransactionCallback DatabaseWorkerPool<T>::AsyncCommitTransaction(SQLTransaction<T> transaction, DatabaseQueueLane lane /*= DATABASE_LANE_INTERACTIVE*/)
 {
 #ifdef TRINITY_DEBUG
     //! Only analyze transaction weaknesses in Debug mode.
@@ -351,8 +426,9 @@ TransactionCallback DatabaseWorkerPool<T>::AsyncCommitTransaction(SQLTransaction
     }
 #endif // TRINITY_DEBUG
 
-    std::future<bool> result = boost::asio::post(_ioContext->get_executor(), boost::asio::use_future([this, transaction, tracker = QueueSizeTracker(this)]
+    std::future<bool> result = boost::asio::post(GetIoContext(lane).get_executor(), boost::asio::use_future([this, transaction, tracker = QueueSizeTracker(this, lane)]
     {
+        tracker.Start();
         T* conn = GetAsyncConnectionForCurrentThread();
         return TransactionTask::Execute(conn, transaction);
     }));
@@ -423,14 +499,16 @@ void DatabaseWorkerPool<T>::KeepAlive()
     //! Assuming all worker threads are free, every worker thread will receive 1 ping operation request
     //! If one or more worker threads are busy, the ping operations will not be split evenly, but this doesn't matter
     //! as the sole purpose is to prevent connections from idling.
-    auto const count = _connections[IDX_ASYNC].size();
-    for (uint8 i = 0; i < count; ++i)
+    for (uint8 lane = 0; lane < MAX_DATABASE_LANES; ++lane)
     {
-        boost::asio::post(_ioContext->get_executor(), [this, tracker = QueueSizeTracker(this)]
+        for (uint8 i = 0; i < _lanes[lane].WorkerThreads; ++i)
         {
-            T* conn = GetAsyncConnectionForCurrentThread();
-            conn->Ping();
-        });
+            boost::asio::post(_lanes[lane].IoContext->get_executor(), [this, tracker = QueueSizeTracker(this, DatabaseQueueLane(lane))]
+            {
+                T* conn = GetAsyncConnectionForCurrentThread();
+                conn->Ping();
+            });
+        }
     }
 }
 
@@ -497,6 +575,37 @@ size_t DatabaseWorkerPool<T>::QueueSize() const
     return _queueSize;
 }
 
+template <class T>
+DatabaseQueueStats DatabaseWorkerPool<T>::GetQueueStats(DatabaseQueueLane lane) const
+{
+    Lane const& source = _lanes[lane];
+
+    DatabaseQueueStats stats;
+    stats.Depth = source.Depth;
+    stats.PeakDepth = source.PeakDepth;
+    stats.Executed = source.Executed;
+    for (size_t i = 0; i < DatabaseQueueStats::LatencyBuckets; ++i)
+        stats.Latency[i] = source.Latency[i];
+
+    return stats;
+}
+
+template <class T>
+bool DatabaseWorkerPool<T>::IsBackpressured(DatabaseQueueLane lane) const
+{
+    if (!_backpressureQueueSize)
+        return false;
+
+    // lanes without own workers share the queue of the interactive lane
+    DatabaseQueueLane workerLane = GetWorkerLane(lane);
+    size_t depth = 0;
+    for (uint8 i = 0; i < MAX_DATABASE_LANES; ++i)
+        if (GetWorkerLane(DatabaseQueueLane(i)) == workerLane)
+            depth += _lanes[i].Depth;
+
+    return depth > _backpressureQueueSize;
+}
+
 template <class T>
 T* DatabaseWorkerPool<T>::GetFreeConnection()
 {
@@ -535,6 +644,18 @@ T* DatabaseWorkerPool<T>::GetAsyncConnectionForCurrentThread() const
     return nullptr;
 }
 
+template <class T>
+DatabaseQueueLane DatabaseWorkerPool<T>::GetWorkerLane(DatabaseQueueLane lane) const
+{
+    return _lanes[lane].WorkerThreads ? lane : DATABASE_LANE_INTERACTIVE;
+}
+
+template <class T>
+Trinity::Asio::IoContext& DatabaseWorkerPool<T>::GetIoContext(DatabaseQueueLane lane) const
+{
+    return *_lanes[GetWorkerLane(lane)].IoContext;
+}
+
 template <class T>
 char const* DatabaseWorkerPool<T>::GetDatabaseName() const
 {
@@ -542,23 +663,25 @@ char const* DatabaseWorkerPool<T>::GetDatabaseName() const
 }
 
 template <class T>
-void DatabaseWorkerPool<T>::Execute(char const* sql)
+void DatabaseWorkerPool<T>::Execute(char const* sql, DatabaseQueueLane lane /*= DATABASE_LANE_INTERACTIVE*/)
 {
     if (!sql)
         return;
 
-    boost::asio::post(_ioContext->get_executor(), [this, sql = std::string(sql), tracker = QueueSizeTracker(this)]
+    boost::asio::post(GetIoContext(lane).get_executor(), [this, sql = std::string(sql), tracker = QueueSizeTracker(this, lane)]
     {
+        tracker.Start();
         T* conn = GetAsyncConnectionForCurrentThread();
         BasicStatementTask::Execute(conn, sql.c_str());
     });
 }
 
 template <class T>
-void DatabaseWorkerPool<T>::Execute(PreparedStatement<T>* stmt)
+void DatabaseWorkerPool<T>::Execute(PreparedStatement<T>* stmt, DatabaseQueueLane lane /*= DATABASE_LANE_INTERACTIVE*/)
 {
-    boost::asio::post(_ioContext->get_executor(), [this, stmt = std::unique_ptr<PreparedStatement<T>>(stmt), tracker = QueueSizeTracker(this)]
+    boost::asio::post(GetIoContext(lane).get_executor(), [this, stmt = std::unique_ptr<PreparedStatement<T>>(stmt), tracker = QueueSizeTracker(this, lane)]
     {
+        tracker.Start();
         T* conn = GetAsyncConnectionForCurrentThread();
         PreparedStatementTask::Execute(conn, stmt.get());
     });
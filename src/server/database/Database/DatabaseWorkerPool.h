@@ -25,11 +25,34 @@
 #include "StringFormat.h"
 #include <array>
 #include <atomic>
+#include <chrono>
 #include <string>
 #include <vector>
 
 struct MySQLConnectionInfo;
 
+//! Async work is split by lane so a burst in one class (e.g. autosaves) does not delay the others.
+//! A lane without own worker threads runs on the interactive workers.
+enum DatabaseQueueLane : uint8
+{
+    DATABASE_LANE_INTERACTIVE,      // default, queries a player is waiting for
+    DATABASE_LANE_LOGIN,            // auth session, account data, character enum and player login
+    DATABASE_LANE_SAVE,             // character save transactions
+    DATABASE_LANE_LOG,              // log appender and audit rows
+    MAX_DATABASE_LANES
+};
+
+struct DatabaseQueueStats
+{
+    //! Queue wait histogram: [0, 1) ms, then [2^(i-1), 2^i) ms, the last bucket is open ended
+    static constexpr size_t LatencyBuckets = 12;
+
+    size_t Depth = 0;
+    size_t PeakDepth = 0;
+    uint64 Executed = 0;
+    std::array<uint64, LatencyBuckets> Latency = { };
+};
+
 template <class T>
 class DatabaseWorkerPool
 {
@@ -49,6 +72,12 @@ class DatabaseWorkerPool
 
         void SetConnectionInfo(std::string const& infoString, uint8 const asyncThreads, uint8 const synchThreads);
 
+        //! Gives a lane its own worker threads (and connections), must be called before Open. 0 runs the lane on the interactive workers.
+        void SetLaneWorkerThreads(DatabaseQueueLane lane, uint8 threads);
+
+        //! Queue depth of a worker queue above which IsBackpressured reports true, 0 disables it.
+        void SetBackpressureQueueSize(size_t size) { _backpressureQueueSize = size; }
+
         uint32 Open();
 
         void Close();
@@ -67,7 +96,7 @@ class DatabaseWorkerPool
 
         //! Enqueues a one-way SQL operation in string format that will be executed asynchronously.
         //! This method should only be used for queries that are only executed once, e.g during startup.
-        void Execute(char const* sql);
+        void Execute(char const* sql, DatabaseQueueLane lane = DATABASE_LANE_INTERACTIVE);
 
         //! Enqueues a one-way SQL operation in string format -with variable args- that will be executed asynchronously.
         //! This method should only be used for queries that are only executed once, e.g during startup.
@@ -82,7 +111,7 @@ class DatabaseWorkerPool
 
         //! Enqueues a one-way SQL operation in prepared statement format that will be executed asynchronously.
         //! Statement must be prepared with CONNECTION_ASYNC flag.
-        void Execute(PreparedStatement<T>* stmt);
+        void Execute(PreparedStatement<T>* stmt, DatabaseQueueLane lane = DATABASE_LANE_INTERACTIVE);
 
         /**
             Direct synchronous one-way statement methods.
@@ -142,24 +171,29 @@ class DatabaseWorkerPool
         //! Statement must be prepared with CONNECTION_SYNCH flag.
         PreparedQueryResult Query(PreparedStatement<T>* stmt);
 
+        //! Executes a query in prepared format and reads the rows through the stream instead of building a result set.
+        //! The connection stays reserved until the stream read its last row or is destroyed.
+        //! Statement must be prepared with CONNECTION_SYNCH flag.
+        bool StreamQuery(PreparedStatement<T>* stmt, PreparedResultStream& stream);
+
         /**
             Asynchronous query (with resultset) methods.
         */
 
         //! Enqueues a query in string format that will set the value of the QueryResultFuture return object as soon as the query is executed.
         //! The return value is then processed in ProcessQueryCallback methods.
-        QueryCallback AsyncQuery(char const* sql);
+        QueryCallback AsyncQuery(char const* sql, DatabaseQueueLane lane = DATABASE_LANE_INTERACTIVE);
 
         //! Enqueues a query in prepared format that will set the value of the PreparedQueryResultFuture return object as soon as the query is executed.
         //! The return value is then processed in ProcessQueryCallback methods.
         //! Statement must be prepared with CONNECTION_ASYNC flag.
-        QueryCallback AsyncQuery(PreparedStatement<T>* stmt);
+        QueryCallback AsyncQuery(PreparedStatement<T>* stmt, DatabaseQueueLane lane = DATABASE_LANE_INTERACTIVE);
 
         //! Enqueues a vector of SQL operations (can be both adhoc and prepared) that will set the value of the QueryResultHolderFuture
         //! return object as soon as the query is executed.
         //! The return value is then processed in ProcessQueryCallback methods.
         //! Any prepared statements added to this holder need to be prepared with the CONNECTION_ASYNC flag.
-        SQLQueryHolderCallback DelayQueryHolder(std::shared_ptr<SQLQueryHolder<T>> holder);
+        SQLQueryHolderCallback DelayQueryHolder(std::shared_ptr<SQLQueryHolder<T>> holder, DatabaseQueueLane lane = DATABASE_LANE_INTERACTIVE);
 
         /**
             Transaction context methods.
@@ -170,11 +204,11 @@ class DatabaseWorkerPool
 
         //! Enqueues a collection of one-way SQL operations (can be both adhoc and prepared). The order in which these operations
         //! were appended to the transaction will be respected during execution.
-        void CommitTransaction(SQLTransaction<T> transaction);
+        void CommitTransaction(SQLTransaction<T> transaction, DatabaseQueueLane lane = DATABASE_LANE_INTERACTIVE);
 
         //! Enqueues a collection of one-way SQL operations (can be both adhoc and prepared). The order in which these operations
         //! were appended to the transaction will be respected during execution.
-        TransactionCallback AsyncCommitTransaction(SQLTransaction<T> transaction);
+        TransactionCallback AsyncCommitTransaction(SQLTransaction<T> transaction, DatabaseQueueLane lane = DATABASE_LANE_INTERACTIVE);
 
         //! Directly executes a collection of one-way SQL operations (can be both adhoc and prepared). The order in which these operations
         //! were appended to the transaction will be respected during execution.
@@ -213,6 +247,13 @@ class DatabaseWorkerPool
 
         size_t QueueSize() const;
 
+        //! Depth and queue wait histogram of the work enqueued on a lane
+        DatabaseQueueStats GetQueueStats(DatabaseQueueLane lane) const;
+
+        //! True while the worker queue serving the lane is deeper than BackpressureQueueSize,
+        //! callers should defer work that is not needed right away.
+        bool IsBackpressured(DatabaseQueueLane lane) const;
+
     private:
         uint32 OpenConnections(InternalIndex type, uint8 numConnections);
 
@@ -224,14 +265,30 @@ class DatabaseWorkerPool
 
         T* GetAsyncConnectionForCurrentThread() const;
 
+        //! Lane whose workers execute the work of the given lane
+        DatabaseQueueLane GetWorkerLane(DatabaseQueueLane lane) const;
+        Trinity::Asio::IoContext& GetIoContext(DatabaseQueueLane lane) const;
+
         char const* GetDatabaseName() const;
 
         struct QueueSizeTracker;
         friend QueueSizeTracker;
 
-        //! Queue shared by async worker threads.
-        std::unique_ptr<Trinity::Asio::IoContext> _ioContext;
+        struct Lane
+        {
+            //! Queue shared by the async worker threads of this lane, null if the lane has no workers
+            std::unique_ptr<Trinity::Asio::IoContext> IoContext;
+            uint8 WorkerThreads = 0;
+
+            std::atomic<size_t> Depth = 0;
+            std::atomic<size_t> PeakDepth = 0;
+            std::atomic<uint64> Executed = 0;
+            std::array<std::atomic<uint64>, DatabaseQueueStats::LatencyBuckets> Latency = { };
+        };
+
+        std::array<Lane, MAX_DATABASE_LANES> _lanes;
         std::atomic<size_t> _queueSize;
+        size_t _backpressureQueueSize;
         std::array<std::vector<std::unique_ptr<T>>, IDX_SIZE> _connections;
         std::unique_ptr<MySQLConnectionInfo> _connectionInfo;
         std::vector<uint8> _preparedStatementSize;
@@ -295,12 +295,7 @@ enum CharacterDatabaseStatements : uint32
     CHAR_INS_TRANSMOG_OUTFIT,
     CHAR_DEL_TRANSMOG_OUTFIT,
 
-    CHAR_INS_AURA,
-    CHAR_INS_AURA_EFFECT,
-
     CHAR_SEL_PLAYER_CURRENCY,
-    CHAR_UPD_PLAYER_CURRENCY,
-    CHAR_REP_PLAYER_CURRENCY,
 
     CHAR_SEL_ACCOUNT_DATA,
     CHAR_REP_ACCOUNT_DATA,
@@ -547,9 +542,6 @@ enum CharacterDatabaseStatements : uint32
     CHAR_DEL_CHAR_QUESTSTATUS_REWARDED_BY_QUEST,
     CHAR_DEL_ACC_QUESTSTATUS_REWARDED_BY_QUEST,
     CHAR_DEL_CHAR_SKILL_BY_SKILL,
-    CHAR_INS_CHAR_SKILLS,
-    CHAR_UDP_CHAR_SKILLS,
-    CHAR_INS_CHAR_SPELL,
     CHAR_DEL_PETITION_BY_OWNER,
     CHAR_DEL_PETITION_SIGNATURE_BY_OWNER,
     CHAR_INS_CHAR_GLYPHS,
@@ -58,6 +58,8 @@ enum WorldDatabaseStatements : uint32
     WORLD_SEL_WAYPOINT_DATA_MAX_ID,
     WORLD_SEL_WAYPOINT_DATA_BY_ID,
     WORLD_SEL_WAYPOINT_DATA_SCRIPT_BY_ID,
+    WORLD_SEL_WAYPOINT_DATA_ALL,
+    WORLD_SEL_WAYPOINT_DATA_SCRIPT_ALL,
     WORLD_SEL_WAYPOINT_DATA_POS_BY_ID,
     WORLD_SEL_WAYPOINT_DATA_POS_FIRST_BY_ID,
     WORLD_SEL_WAYPOINT_DATA_POS_LAST_BY_ID,
@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2008-2017 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MultiRowInsert.h"
+#include "Errors.h"
+#include "PreparedStatement.h"
+#include "Transaction.h"
+#include "Util.h"
+
+#include <algorithm>
+
+MultiRowInsert::MultiRowInsert(char const* head, uint32 maxRows) : _head(head), _maxRows(std::max(maxRows, 1u)), _rows(0), _firstValue(true)
+{
+}
+
+MultiRowInsert& MultiRowInsert::NewRow()
+{
+    if (_rows == _maxRows)
+        Finish();
+
+    if (_rows)
+        _current += "), (";
+    else
+    {
+        _current = _head;
+        _current += '(';
+    }
+
+    ++_rows;
+    _firstValue = true;
+    return *this;
+}
+
+MultiRowInsert& MultiRowInsert::AddBinary(std::vector<uint8> const& value)
+{
+    NextValue();
+    _current += "X'";
+    _current += ByteArrayToHexStr(value.data(), uint32(value.size()));
+    _current += '\'';
+    return *this;
+}
+
+void MultiRowInsert::NextValue()
+{
+    ASSERT(_rows, "MultiRowInsert: value added before NewRow");
+
+    if (!_firstValue)
+        _current += ", ";
+    _firstValue = false;
+}
+
+std::vector<std::string> const& MultiRowInsert::Finish()
+{
+    if (_rows)
+    {
+        _current += ')';
+        _statements.push_back(std::move(_current));
+        _current.clear();
+        _rows = 0;
+    }
+
+    return _statements;
+}
+
+void MultiRowInsert::AppendTo(TransactionBase& trans)
+{
+    for (std::string const& statement : Finish())
+        trans.Append(statement.c_str());
+
+    _statements.clear();
+}
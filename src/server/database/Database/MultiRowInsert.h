@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2008-2017 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _MULTIROWINSERT_H
+#define _MULTIROWINSERT_H
+
+#include "Define.h"
+
+#include <string>
+#include <type_traits>
+#include <vector>
+
+class TransactionBase;
+
+/*! Coalesces rows of the same shape into "INSERT ... VALUES (...), (...)" statements.
+    Saves that write one row per entry send a single statement per MaxRows rows instead
+    of one prepared statement each. Only integers and binaries are accepted, so the
+    values never need escaping. */
+class TC_DATABASE_API MultiRowInsert
+{
+public:
+    /// head is everything up to and including VALUES, e.g. "REPLACE INTO t (a, b) VALUES "
+    explicit MultiRowInsert(char const* head, uint32 maxRows = 256);
+
+    MultiRowInsert& NewRow();
+
+    template<class T>
+    MultiRowInsert& Add(T value)
+    {
+        static_assert(std::is_integral<T>::value, "only integer values can be added unescaped");
+        NextValue();
+        if constexpr (std::is_same<T, bool>::value)
+            _current += value ? '1' : '0';
+        else if constexpr (std::is_signed<T>::value)
+            _current += std::to_string(int64(value));
+        else
+            _current += std::to_string(uint64(value));
+        return *this;
+    }
+
+    MultiRowInsert& AddBinary(std::vector<uint8> const& value);
+
+    bool IsEmpty() const { return _statements.empty() && !_rows; }
+
+    /// Closes the statement being built, the statements stay available until AppendTo
+    std::vector<std::string> const& Finish();
+    /// Appends every statement to the transaction and starts over
+    void AppendTo(TransactionBase& trans);
+
+private:
+    void NextValue();
+
+    std::string _head;
+    uint32 _maxRows;
+    uint32 _rows;
+    bool _firstValue;
+    std::string _current;
+    std::vector<std::string> _statements;
+};
+
+#endif
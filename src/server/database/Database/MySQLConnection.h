@@ -52,6 +52,7 @@ class TC_DATABASE_API MySQLConnection
 {
     template <class T> friend class DatabaseWorkerPool;
     friend class PingOperation;
+    friend class PreparedResultStream;
 
     public:
         MySQLConnection(MySQLConnectionInfo& connInfo, ConnectionFlags connectionFlags);
@@ -34,6 +34,7 @@ class TC_DATABASE_API MySQLPreparedStatement
 {
     friend class MySQLConnection;
     friend class PreparedStatementBase;
+    friend class PreparedResultStream;
 
     public:
         MySQLPreparedStatement(MySQLStmt* stmt, std::string queryString);
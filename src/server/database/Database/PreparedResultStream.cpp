@@ -0,0 +1,275 @@
+/*
+ * Copyright (C) 2008-2017 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PreparedResultStream.h"
+#include "Errors.h"
+#include "Log.h"
+#include "MySQLConnection.h"
+#include "MySQLHacks.h"
+#include "MySQLPreparedStatement.h"
+#include "MySQLWorkaround.h"
+#include "PreparedStatement.h"
+
+namespace
+{
+enum class ColumnClass
+{
+    Integer,
+    Real,
+    String,
+    Unsupported
+};
+
+ColumnClass GetColumnClass(enum_field_types type)
+{
+    switch (type)
+    {
+        case MYSQL_TYPE_TINY:
+        case MYSQL_TYPE_YEAR:
+        case MYSQL_TYPE_SHORT:
+        case MYSQL_TYPE_INT24:
+        case MYSQL_TYPE_LONG:
+        case MYSQL_TYPE_LONGLONG:
+        case MYSQL_TYPE_BIT:
+            return ColumnClass::Integer;
+        case MYSQL_TYPE_FLOAT:
+        case MYSQL_TYPE_DOUBLE:
+        case MYSQL_TYPE_DECIMAL:
+        case MYSQL_TYPE_NEWDECIMAL:
+            return ColumnClass::Real;
+        case MYSQL_TYPE_TINY_BLOB:
+        case MYSQL_TYPE_MEDIUM_BLOB:
+        case MYSQL_TYPE_LONG_BLOB:
+        case MYSQL_TYPE_BLOB:
+        case MYSQL_TYPE_STRING:
+        case MYSQL_TYPE_VAR_STRING:
+            return ColumnClass::String;
+        default:
+            return ColumnClass::Unsupported;
+    }
+}
+
+ColumnClass GetColumnClass(PreparedResultStream::ColumnType type)
+{
+    switch (type)
+    {
+        case PreparedResultStream::ColumnType::Float:
+        case PreparedResultStream::ColumnType::Double:
+            return ColumnClass::Real;
+        case PreparedResultStream::ColumnType::String:
+            return ColumnClass::String;
+        default:
+            return ColumnClass::Integer;
+    }
+}
+
+void SetBufferType(MYSQL_BIND& bind, PreparedResultStream::ColumnType type)
+{
+    switch (type)
+    {
+        case PreparedResultStream::ColumnType::Int8:   bind.buffer_type = MYSQL_TYPE_TINY;     bind.buffer_length = 1; break;
+        case PreparedResultStream::ColumnType::UInt8:  bind.buffer_type = MYSQL_TYPE_TINY;     bind.buffer_length = 1; bind.is_unsigned = true; break;
+        case PreparedResultStream::ColumnType::Int16:  bind.buffer_type = MYSQL_TYPE_SHORT;    bind.buffer_length = 2; break;
+        case PreparedResultStream::ColumnType::UInt16: bind.buffer_type = MYSQL_TYPE_SHORT;    bind.buffer_length = 2; bind.is_unsigned = true; break;
+        case PreparedResultStream::ColumnType::Int32:  bind.buffer_type = MYSQL_TYPE_LONG;     bind.buffer_length = 4; break;
+        case PreparedResultStream::ColumnType::UInt32: bind.buffer_type = MYSQL_TYPE_LONG;     bind.buffer_length = 4; bind.is_unsigned = true; break;
+        case PreparedResultStream::ColumnType::Int64:  bind.buffer_type = MYSQL_TYPE_LONGLONG; bind.buffer_length = 8; break;
+        case PreparedResultStream::ColumnType::UInt64: bind.buffer_type = MYSQL_TYPE_LONGLONG; bind.buffer_length = 8; bind.is_unsigned = true; break;
+        case PreparedResultStream::ColumnType::Float:  bind.buffer_type = MYSQL_TYPE_FLOAT;    bind.buffer_length = 4; break;
+        case PreparedResultStream::ColumnType::Double: bind.buffer_type = MYSQL_TYPE_DOUBLE;   bind.buffer_length = 8; break;
+        case PreparedResultStream::ColumnType::String: bind.buffer_type = MYSQL_TYPE_STRING;   break;
+    }
+}
+}
+
+struct PreparedResultStream::Binding
+{
+    std::vector<MySQLBind> Binds;
+    std::vector<char> Row;
+    MySQLBool* IsNull = nullptr;
+};
+
+PreparedResultStream::PreparedResultStream(std::initializer_list<ColumnType> schema) : _schema(schema),
+    _lengths(nullptr), _connection(nullptr), _stmt(nullptr), _metadata(nullptr), _rowCount(0)
+{
+}
+
+PreparedResultStream::~PreparedResultStream()
+{
+    Close();
+}
+
+bool PreparedResultStream::Open(MySQLConnection* connection, PreparedStatementBase* stmt)
+{
+    ASSERT(!_connection, "PreparedResultStream: stream opened twice");
+    _connection = connection;
+
+    MySQLPreparedStatement* mysqlStmt = nullptr;
+    uint64 rowCount = 0;
+    uint32 fieldCount = 0;
+    if (!connection->_Query(stmt, &mysqlStmt, &_metadata, &rowCount, &fieldCount))
+    {
+        Close();
+        return false;
+    }
+
+    if (mysql_more_results(connection->m_Mysql))
+        mysql_next_result(connection->m_Mysql);
+
+    _stmt = mysqlStmt->GetSTMT();
+
+    if (!_metadata || fieldCount != _schema.size())
+    {
+        TC_LOG_ERROR("sql.sql", "PreparedResultStream: query `%s` returns %u columns, schema has " SZFMTD,
+            mysqlStmt->getQueryString().c_str(), fieldCount, _schema.size());
+        Close();
+        return false;
+    }
+
+    if (!Bind(_metadata))
+    {
+        TC_LOG_ERROR("sql.sql", "PreparedResultStream: cannot bind result of `%s`", mysqlStmt->getQueryString().c_str());
+        Close();
+        return false;
+    }
+
+    return true;
+}
+
+bool PreparedResultStream::Bind(MySQLResult* metadata)
+{
+    //- rows stay in the client library buffer, store_result only gives us max_length to size string columns
+    if (mysql_stmt_store_result(_stmt))
+    {
+        TC_LOG_WARN("sql.sql", "%s:mysql_stmt_store_result, cannot bind result from MySQL server. Error: %s", __FUNCTION__, mysql_stmt_error(_stmt));
+        return false;
+    }
+
+    _rowCount = mysql_stmt_num_rows(_stmt);
+
+    MYSQL_FIELD* fields = mysql_fetch_fields(metadata);
+    for (uint32 i = 0; i < _schema.size(); ++i)
+    {
+        ColumnClass columnClass = GetColumnClass(fields[i].type);
+        if (columnClass == ColumnClass::Unsupported || (columnClass != GetColumnClass(_schema[i])
+            && !(columnClass == ColumnClass::Integer && GetColumnClass(_schema[i]) == ColumnClass::Real)))
+        {
+            TC_LOG_ERROR("sql.sql", "PreparedResultStream: column %u (%s) does not match the schema", i, fields[i].name);
+            return false;
+        }
+    }
+
+    //- same ownership as PreparedResultSet, mysql_stmt_bind_result moves length and is_null to m_stmt->bind
+    // and whoever binds this statement next frees them
+    if (_stmt->bind_result_done)
+    {
+        delete[] _stmt->bind->length;
+        delete[] _stmt->bind->is_null;
+    }
+
+    uint32 const fieldCount = uint32(_schema.size());
+    _binding = std::make_unique<Binding>();
+    _binding->Binds.resize(fieldCount);
+    _binding->IsNull = new MySQLBool[fieldCount];
+    unsigned long* length = new unsigned long[fieldCount];
+    _lengths = length;
+
+    memset(_binding->Binds.data(), 0, sizeof(MySQLBind) * fieldCount);
+    memset(_binding->IsNull, 0, sizeof(MySQLBool) * fieldCount);
+    memset(length, 0, sizeof(unsigned long) * fieldCount);
+
+    std::size_t rowSize = 0;
+    for (uint32 i = 0; i < fieldCount; ++i)
+    {
+        MySQLBind& bind = _binding->Binds[i];
+        SetBufferType(bind, _schema[i]);
+        if (_schema[i] == ColumnType::String)
+            bind.buffer_length = fields[i].max_length + 1;
+
+        bind.length = &length[i];
+        bind.is_null = &_binding->IsNull[i];
+        bind.error = nullptr;
+        rowSize += bind.buffer_length;
+    }
+
+    _binding->Row.resize(rowSize);
+    _buffers.resize(fieldCount);
+    for (uint32 i = 0, offset = 0; i < fieldCount; ++i)
+    {
+        _buffers[i] = _binding->Row.data() + offset;
+        _binding->Binds[i].buffer = _buffers[i];
+        offset += _binding->Binds[i].buffer_length;
+    }
+
+    if (mysql_stmt_bind_result(_stmt, _binding->Binds.data()))
+    {
+        TC_LOG_WARN("sql.sql", "%s:mysql_stmt_bind_result, cannot bind result from MySQL server. Error: %s", __FUNCTION__, mysql_stmt_error(_stmt));
+        delete[] _binding->IsNull;
+        delete[] length;
+        _binding->IsNull = nullptr;
+        _lengths = nullptr;
+        return false;
+    }
+
+    return true;
+}
+
+bool PreparedResultStream::NextRow()
+{
+    if (!_connection || !_binding)
+        return false;
+
+    int retval = mysql_stmt_fetch(_stmt);
+    if (retval != 0 && retval != MYSQL_DATA_TRUNCATED)
+    {
+        Close();
+        return false;
+    }
+
+    for (uint32 i = 0; i < _schema.size(); ++i)
+        if (_schema[i] == ColumnType::String && _lengths[i] < _binding->Binds[i].buffer_length)
+            _buffers[i][_lengths[i]] = '\0';
+
+    return true;
+}
+
+bool PreparedResultStream::IsNull(uint32 index) const
+{
+    ASSERT(_binding && index < _schema.size());
+    return _binding->IsNull[index] != 0;
+}
+
+void PreparedResultStream::Close()
+{
+    if (!_connection)
+        return;
+
+    if (_stmt)
+    {
+        mysql_stmt_free_result(_stmt);
+        _stmt = nullptr;
+    }
+
+    if (_metadata)
+    {
+        mysql_free_result(_metadata);
+        _metadata = nullptr;
+    }
+
+    _connection->Unlock();
+    _connection = nullptr;
+}
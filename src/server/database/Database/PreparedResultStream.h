@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2008-2017 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _PREPAREDRESULTSTREAM_H
+#define _PREPAREDRESULTSTREAM_H
+
+#include "Define.h"
+#include "DatabaseEnvFwd.h"
+
+#include <cstring>
+#include <initializer_list>
+#include <memory>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+class MySQLConnection;
+
+/*! Row by row access to the result of a prepared query without building Field objects.
+    Every column is bound to a buffer of the type the caller asked for, so MySQL converts
+    the value while fetching the row and reading it back is a plain copy. The stream keeps
+    its connection until it is destroyed or the last row was read, it is meant for big
+    startup loads on synchronous connections, see DatabaseWorkerPool::StreamQuery. */
+class TC_DATABASE_API PreparedResultStream
+{
+public:
+    enum class ColumnType : uint8
+    {
+        Int8,
+        UInt8,
+        Int16,
+        UInt16,
+        Int32,
+        UInt32,
+        Int64,
+        UInt64,
+        Float,
+        Double,
+        String
+    };
+
+    virtual ~PreparedResultStream();
+
+    PreparedResultStream(PreparedResultStream const&) = delete;
+    PreparedResultStream& operator=(PreparedResultStream const&) = delete;
+
+    /// Runs the statement on a locked connection, false (and the connection released) on error or schema mismatch
+    bool Open(MySQLConnection* connection, PreparedStatementBase* stmt);
+
+    bool NextRow();
+    uint64 GetRowCount() const { return _rowCount; }
+    bool IsNull(uint32 index) const;
+
+protected:
+    explicit PreparedResultStream(std::initializer_list<ColumnType> schema);
+
+    template<class T>
+    T GetValue(uint32 index) const
+    {
+        if constexpr (std::is_same<T, std::string_view>::value)
+            return std::string_view(_buffers[index], _lengths[index]);
+        else if constexpr (std::is_same<T, bool>::value)
+            return *_buffers[index] != 0;
+        else
+        {
+            T value;
+            memcpy(&value, _buffers[index], sizeof(T));
+            return value;
+        }
+    }
+
+    template<class T>
+    static constexpr ColumnType ColumnTypeOf()
+    {
+        if constexpr (std::is_same<T, bool>::value || std::is_same<T, uint8>::value) return ColumnType::UInt8;
+        else if constexpr (std::is_same<T, int8>::value) return ColumnType::Int8;
+        else if constexpr (std::is_same<T, uint16>::value) return ColumnType::UInt16;
+        else if constexpr (std::is_same<T, int16>::value) return ColumnType::Int16;
+        else if constexpr (std::is_same<T, uint32>::value) return ColumnType::UInt32;
+        else if constexpr (std::is_same<T, int32>::value) return ColumnType::Int32;
+        else if constexpr (std::is_same<T, uint64>::value) return ColumnType::UInt64;
+        else if constexpr (std::is_same<T, int64>::value) return ColumnType::Int64;
+        else if constexpr (std::is_same<T, float>::value) return ColumnType::Float;
+        else if constexpr (std::is_same<T, double>::value) return ColumnType::Double;
+        else
+        {
+            static_assert(std::is_same<T, std::string_view>::value, "unsupported column type");
+            return ColumnType::String;
+        }
+    }
+
+private:
+    bool Bind(MySQLResult* metadata);
+    void Close();
+
+    struct Binding;
+
+    std::vector<ColumnType> _schema;
+    std::unique_ptr<Binding> _binding;
+    std::vector<char*> _buffers;
+    unsigned long const* _lengths;
+    MySQLConnection* _connection;
+    MySQLStmt* _stmt;
+    MySQLResult* _metadata;
+    uint64 _rowCount;
+};
+
+/*! Compile time column schema of a streamed result.
+
+    TypedPreparedResultStream<uint32, float, std::string_view> rows;
+    if (WorldDatabase.StreamQuery(stmt, rows))
+        while (rows.NextRow())
+            uint32 id = rows.Get<0>();
+
+    String columns are views into the row buffer, they are only valid until the next NextRow. */
+template<typename... Columns>
+class TypedPreparedResultStream : public PreparedResultStream
+{
+public:
+    TypedPreparedResultStream() : PreparedResultStream({ ColumnTypeOf<Columns>()... }) { }
+
+    template<std::size_t Index>
+    std::tuple_element_t<Index, std::tuple<Columns...>> Get() const
+    {
+        return GetValue<std::tuple_element_t<Index, std::tuple<Columns...>>>(Index);
+    }
+};
+
+#endif
@@ -22,6 +22,9 @@
 #include "DB2LoadInfo.h"
 #include "DatabaseEnv.h"
 #include "ObjectMgr.h"
+#include <atomic>
+#include <functional>
+#include <thread>
 
 DB2Storage<AchievementEntry>                    sAchievementStore("Achievement.db2", AchievementLoadInfo::Instance());
 DB2Storage<Achievement_CategoryEntry>           sAchievement_CategoryStore("Achievement_Category.db2", Achievement_CategoryLoadInfo::Instance());
@@ -886,11 +889,17 @@ void LoadDB2(uint32& availableDb2Locales, DB2StoreProblemList& errlist, StorageM
                 continue;
 
             loadMutex.lock();
-            if (availableDb2Locales & (1 << i))
-                if (!storage->LoadStringsFrom((db2Path + localeNames[i] + '/'), i))
-                    availableDb2Locales &= ~(1 << i);             // mark as not available for speedup next checks
+            bool available = (availableDb2Locales & (1 << i)) != 0;
             loadMutex.unlock();
 
+            // the locale file itself is read without the lock, other stores keep loading meanwhile
+            if (available && !storage->LoadStringsFrom((db2Path + localeNames[i] + '/'), i))
+            {
+                loadMutex.lock();
+                availableDb2Locales &= ~(1 << i);                 // mark as not available for speedup next checks
+                loadMutex.unlock();
+            }
+
             storage->LoadStringsFromDB(i);
         }
     }
@@ -948,13 +957,37 @@ void LoadDB2(uint32& availableDb2Locales, DB2StoreProblemList& errlist, StorageM
     //};
 }
 
+// every store is one task, its file, hotfix rows and locales are loaded in order by the thread that picked it
+void RunDB2Loads(std::vector<std::function<void()>> const& loads, uint32 threads)
+{
+    if (!threads)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = uint32(std::min<std::size_t>(threads, loads.size()));
+
+    std::atomic<std::size_t> next(0);
+    auto worker = [&loads, &next]()
+    {
+        for (std::size_t i = next++; i < loads.size(); i = next++)
+            loads[i]();
+    };
+
+    std::vector<std::thread> pool;
+    for (uint32 i = 1; i < threads; ++i)
+        pool.emplace_back(worker);
+
+    worker();
+
+    for (std::thread& thread : pool)
+        thread.join();
+}
+
 DB2Manager& DB2Manager::Instance()
 {
     static DB2Manager instance;
     return instance;
 }
 
-uint32 DB2Manager::LoadStores(std::string const& dataPath, uint32 defaultLocale)
+uint32 DB2Manager::LoadStores(std::string const& dataPath, uint32 defaultLocale, uint32 threads)
 {
     uint32 oldMSTime = getMSTime();
 
@@ -963,7 +996,9 @@ uint32 DB2Manager::LoadStores(std::string const& dataPath, uint32 defaultLocale)
     DB2StoreProblemList bad_db2_files;
     uint32 availableDb2Locales = 0xFFF;
 
-#define LOAD_DB2(store) LoadDB2(availableDb2Locales, bad_db2_files, _stores, &(store), db2Path, defaultLocale, GetCppRecordSize(store))
+    std::vector<std::function<void()>> loads;
+
+#define LOAD_DB2(store) loads.emplace_back([&]() { LoadDB2(availableDb2Locales, bad_db2_files, _stores, &(store), db2Path, defaultLocale, GetCppRecordSize(store)); })
 
     LOAD_DB2(sAchievementStore);
     //LOAD_DB2(sAchievement_CategoryStore);
@@ -1572,6 +1607,8 @@ uint32 DB2Manager::LoadStores(std::string const& dataPath, uint32 defaultLocale)
 
 #undef LOAD_DB2
 
+    RunDB2Loads(loads, threads);
+
     // error checks
     if (bad_db2_files.size() == _stores.size())
     {
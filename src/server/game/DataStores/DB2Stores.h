@@ -166,6 +166,7 @@ TC_GAME_API extern DB2Storage<ManagedWorldStateBuffEntry>               sManaged
 TC_GAME_API extern DB2Storage<ManagedWorldStateEntry>                   sManagedWorldStateStore;
 TC_GAME_API extern DB2Storage<ManagedWorldStateInputEntry>              sManagedWorldStateInputStore;
 TC_GAME_API extern DB2Storage<MapChallengeModeEntry>                    sMapChallengeModeStore;
+TC_GAME_API extern DB2Storage<MapDifficultyEntry>                       sMapDifficultyStore;
 TC_GAME_API extern DB2Storage<MapEntry>                                 sMapStore;
 TC_GAME_API extern DB2Storage<ModifierTreeEntry>                        sModifierTreeStore;
 TC_GAME_API extern DB2Storage<MountCapabilityEntry>                     sMountCapabilityStore;
@@ -405,7 +406,7 @@ public:
 
     static DB2Manager& Instance();
 
-    uint32 LoadStores(std::string const& dataPath, uint32 defaultLocale);
+    uint32 LoadStores(std::string const& dataPath, uint32 defaultLocale, uint32 threads);
     void InitDB2CustomStores();
     static DB2StorageBase const* GetStorage(uint32 type);
     void LoadingExtraHotfixData();
@@ -293,9 +293,10 @@ class TC_GAME_API GameObject : public WorldObject, public GridObject<GameObject>
         /// This method transforms supplied global coordinates into local offsets
         virtual void CalculatePassengerOffset(float& x, float& y, float& z, float* o = nullptr);
 
-        void AddDelayedEvent(uint64 timeOffset, std::function<void()>&& function)
+        template <typename F>
+        void AddDelayedEvent(uint64 timeOffset, F&& function)
         {
-            m_Functions.AddDelayedEvent(timeOffset, std::move(function));
+            m_Functions.AddDelayedEvent(timeOffset, std::forward<F>(function));
         }
 
         void KillAllDelayedEvents()
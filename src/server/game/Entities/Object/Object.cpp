@@ -363,10 +363,15 @@ void Object::SendUpdateToPlayer(Player* player)
 
 void Object::BuildValuesUpdateBlockForPlayer(UpdateData* data, Player* target) const
 {
-    if (!IsInWorld())
-        return;
-
     ByteBuffer buf(500);
+    if (BuildValuesUpdateBlock(buf, target))
+        data->AddUpdateBlock(buf);
+}
+
+bool Object::BuildValuesUpdateBlock(ByteBuffer& buf, Player* target) const
+{
+    if (!IsInWorld())
+        return false;
 
     buf << uint8(UPDATETYPE_VALUES);
     buf << GetGUID();
@@ -375,9 +380,9 @@ void Object::BuildValuesUpdateBlockForPlayer(UpdateData* data, Player* target) c
     BuildDynamicValuesUpdate(UPDATETYPE_VALUES, &buf, target);
 
     if (buf.size() > 10000000) // Prevent overflow
-        return;
+        return false;
 
-    data->AddUpdateBlock(buf);
+    return true;
 }
 
 void Object::BuildOutOfRangeUpdateBlock(UpdateData* data) const
@@ -848,7 +853,7 @@ void Object::ClearUpdateMask(bool /*remove*/)
         m_objectUpdated = false;
 }
 
-void Object::BuildFieldsUpdate(Player* player, UpdateDataMapType& data_map) const
+void Object::BuildFieldsUpdate(Player* player, UpdateDataMapType& data_map, ValuesUpdateCache* cache) const
 {
     auto iter = data_map.find(player);
 
@@ -859,7 +864,30 @@ void Object::BuildFieldsUpdate(Player* player, UpdateDataMapType& data_map) cons
         iter = p.first;
     }
 
-    BuildValuesUpdateBlockForPlayer(&iter->second, iter->first);
+    uint32 updateClass = 0;
+    if (!cache || !cache->Shareable || !GetValuesUpdateClass(player, updateClass))
+    {
+        BuildValuesUpdateBlockForPlayer(&iter->second, iter->first);
+        return;
+    }
+
+    // serialize once per visibility class, every other receiver of that class gets the same bytes
+    for (auto const& block : cache->Blocks)
+    {
+        if (block.first != updateClass)
+            continue;
+
+        if (!block.second.empty())
+            iter->second.AddUpdateBlock(block.second);
+        return;
+    }
+
+    cache->Blocks.emplace_back(updateClass, ByteBuffer(500));
+    ByteBuffer& buf = cache->Blocks.back().second;
+    if (BuildValuesUpdateBlock(buf, player))
+        iter->second.AddUpdateBlock(buf);
+    else
+        buf.clear();
 }
 
 uint32 Object::GetUpdateFieldData(Player const* target, uint32*& flags) const
@@ -1589,6 +1617,7 @@ WorldObject::WorldObject(bool isWorldObject): LastUsedScriptID(0), m_transport(n
     m_oldZoneId = 0;
     m_areaId = 0;
     m_oldAreaId = 0;
+    m_updateCollectGeneration = 0;
 }
 
 void WorldObject::SetWorldObject(bool on)
@@ -1743,8 +1772,7 @@ void WorldObject::CleanupsBeforeDelete(bool /*finalCleanup*/)
     if (IsInWorld())
         RemoveFromWorld();
 
-    m_phaseId.clear();
-    m_phaseBit.clear();
+    m_phaseSet = PhaseSet();
     _terrainSwaps.clear();
     _worldMapAreaSwaps.clear();
     _visibilityPlayerList.clear();
@@ -1942,7 +1970,7 @@ bool WorldObject::IsWithinLOSInMap(const WorldObject* obj, VMAP::ModelIgnoreFlag
 //                G3D::Vector3 pos2(ox, oy, oz + 2.f);
 //                transport->CalculatePassengerPosition(pos1.x, pos1.y, pos1.z);
 //                transport->CalculatePassengerPosition(pos2.x, pos2.y, pos2.z);
-//                return _model->isInLineOfSight(pos1, pos2, GetPhases(), IsPlayer() || IsUnitOwnedByPlayer());
+//                return _model->isInLineOfSight(pos1, pos2, GetPhaseSet(), IsPlayer() || IsUnitOwnedByPlayer());
 //            }
 //        }
 //    }
@@ -1971,7 +1999,7 @@ bool WorldObject::IsWithinLOS(float ox, float oy, float oz, VMAP::ModelIgnoreFla
 //                G3D::Vector3 pos2(ox, oy, oz + 2.f);
 //                transport->CalculatePassengerPosition(pos1.x, pos1.y, pos1.z);
 //                // transport->CalculatePassengerPosition(pos2.x, pos2.y, pos2.z);
-//                return _model->isInLineOfSight(pos1, pos2, GetPhases(), IsPlayer() || IsUnitOwnedByPlayer());
+//                return _model->isInLineOfSight(pos1, pos2, GetPhaseSet(), IsPlayer() || IsUnitOwnedByPlayer());
 //            }
 //        }
 //        if (!GetMap())
@@ -1982,7 +2010,7 @@ bool WorldObject::IsWithinLOS(float ox, float oy, float oz, VMAP::ModelIgnoreFla
         else
             GetHitSpherePointFor({ ox, oy, oz }, x, y, z);
 
-        return GetMap()->isInLineOfSight(x, y, z + 2.f, ox, oy, oz + 2.f, GetPhases(), ignoreFlags);
+        return GetMap()->isInLineOfSight(x, y, z + 2.f, ox, oy, oz + 2.f, GetPhaseSet(), ignoreFlags);
     }
 
     return true;
@@ -1994,7 +2022,7 @@ float WorldObject::GetWaterOrGroundLevel(float x, float y, float z, float* groun
     {
         if (GameObjectModel* _model = transport->m_model)
         {
-            float ground_z = _model->getHeight(x, y, z, DEFAULT_HEIGHT_SEARCH, GetPhases(), IsPlayer() || IsUnitOwnedByPlayer());
+            float ground_z = _model->getHeight(x, y, z, DEFAULT_HEIGHT_SEARCH, GetPhaseSet(), IsPlayer() || IsUnitOwnedByPlayer());
             if (ground_z == -G3D::finf() || ground_z == G3D::finf())
                 return VMAP_INVALID_HEIGHT_VALUE;
 
@@ -2006,7 +2034,7 @@ float WorldObject::GetWaterOrGroundLevel(float x, float y, float z, float* groun
 
     if (!GetMap())
         return VMAP_INVALID_HEIGHT_VALUE;
-    return GetMap()->GetWaterOrGroundLevel(GetPhases(), x, y, z, ground);
+    return GetMap()->GetWaterOrGroundLevel(GetPhaseSet(), x, y, z, ground);
 }
 
 float WorldObject::GetHeight(float x, float y, float z, bool vmap /*= true*/, float maxSearchDist /*= DEFAULT_HEIGHT_SEARCH*/) const
@@ -2015,7 +2043,7 @@ float WorldObject::GetHeight(float x, float y, float z, bool vmap /*= true*/, fl
     {
         if (GameObjectModel* _model = transport->m_model)
         {
-            float ground_z = _model->getHeight(x, y, z, maxSearchDist, GetPhases(), IsPlayer() || IsUnitOwnedByPlayer());
+            float ground_z = _model->getHeight(x, y, z, maxSearchDist, GetPhaseSet(), IsPlayer() || IsUnitOwnedByPlayer());
             if (ground_z == -G3D::finf() || ground_z == G3D::finf())
                 return VMAP_INVALID_HEIGHT_VALUE;
             return ground_z;
@@ -2024,7 +2052,7 @@ float WorldObject::GetHeight(float x, float y, float z, bool vmap /*= true*/, fl
 
     if (!GetMap())
         return VMAP_INVALID_HEIGHT_VALUE;
-    return GetMap()->GetHeight(GetPhases(), x, y, z, vmap, maxSearchDist);
+    return GetMap()->GetHeight(GetPhaseSet(), x, y, z, vmap, maxSearchDist);
 }
 
 Position WorldObject::GetHitSpherePointFor(Position const& dest) const
@@ -3381,7 +3409,7 @@ void WorldObject::MovePositionToFirstCollision(Position &pos, float dist, float
         destz -= 0.5f;
 
     // check dynamic collision
-    col = GetMap()->getObjectHitPos(GetPhases(), IsPlayer() || IsUnitOwnedByPlayer(), pos.m_positionX, pos.m_positionY, pos.m_positionZ + 0.5f, destx, desty, destz + 0.5f, destx, desty, destz, -0.5f);
+    col = GetMap()->getObjectHitPos(GetPhaseSet(), IsPlayer() || IsUnitOwnedByPlayer(), pos.m_positionX, pos.m_positionY, pos.m_positionZ + 0.5f, destx, desty, destz + 0.5f, destx, desty, destz, -0.5f);
 
     // Collided with a gameobject
     if (col)
@@ -3497,7 +3525,7 @@ void WorldObject::MovePositionToTransportCollision(Position &pos, float dist, fl
     G3D::Vector3 pos2(destx, desty, destz + 2.0f);
     G3D::Vector3 resultPos;
 
-    bool col = _model->getObjectHitPos(GetPhases(), IsPlayer() || IsUnitOwnedByPlayer(), pos1, pos2, resultPos, -0.5f);
+    bool col = _model->getObjectHitPos(GetPhaseSet(), IsPlayer() || IsUnitOwnedByPlayer(), pos1, pos2, resultPos, -0.5f);
     destx = resultPos.x;
     desty = resultPos.y;
     destz = resultPos.z;
@@ -3582,7 +3610,7 @@ void WorldObject::MovePositionToCollisionBetween(Position &pos, float distMin, f
     }
 
     // check dynamic collision
-    col = GetMap()->getObjectHitPos(GetPhases(), IsPlayer() || IsUnitOwnedByPlayer(), tempDestx, tempDesty, pos.m_positionZ + 0.5f, destx, desty, destz + 0.5f, destx, desty, destz, -0.5f);
+    col = GetMap()->getObjectHitPos(GetPhaseSet(), IsPlayer() || IsUnitOwnedByPlayer(), tempDestx, tempDesty, pos.m_positionZ + 0.5f, destx, desty, destz + 0.5f, destx, desty, destz, -0.5f);
 
     // Collided with a gameobject
     if (col)
@@ -3742,8 +3770,12 @@ struct WorldObjectChangeAccumulator
     UpdateDataMapType& i_updateDatas;
     WorldObject& i_object;
     GuidSet plr_list;
+    ValuesUpdateCache i_valuesCache;
 
-    WorldObjectChangeAccumulator(WorldObject &obj, UpdateDataMapType &d) : i_updateDatas(d), i_object(obj) { }
+    WorldObjectChangeAccumulator(WorldObject &obj, UpdateDataMapType &d) : i_updateDatas(d), i_object(obj)
+    {
+        i_valuesCache.Shareable = obj.CanShareValuesUpdate();
+    }
 
     void Visit(PlayerMapType &m)
     {
@@ -3790,7 +3822,7 @@ struct WorldObjectChangeAccumulator
         // Only send update once to a player
         if (plr_list.find(player->GetGUID()) == plr_list.end() && player->HaveAtClient(&i_object))
         {
-            i_object.BuildFieldsUpdate(player, i_updateDatas);
+            i_object.BuildFieldsUpdate(player, i_updateDatas, &i_valuesCache);
             plr_list.insert(player->GetGUID());
         }
     }
@@ -3829,7 +3861,7 @@ ObjectGuid WorldObject::GetTransGUID() const
 //! If some have 1 2 enother has 1 = see each other.
 //! ir some have 1 2 enorther has 3 - not see.
 //! if some has ignorePhase id - see each.
-bool WorldObject::InSamePhaseId(std::set<uint32> const& phase, bool otherUsePlayerPhasingRules) const
+bool WorldObject::InSamePhaseId(PhaseSet phases, bool otherUsePlayerPhasingRules) const
 {
     bool usePlayerPhasingRules = IsPlayer() || IsUnitOwnedByPlayer();
 
@@ -3839,40 +3871,44 @@ bool WorldObject::InSamePhaseId(std::set<uint32> const& phase, bool otherUsePlay
     if (usePlayerPhasingRules && otherUsePlayerPhasingRules)
         return true;
 
-    if (phase.empty() && m_phaseId.empty())
+    if (phases.empty() && m_phaseSet.empty())
         return true;
 
-    if (usePlayerPhasingRules && phase.empty())
+    if (usePlayerPhasingRules && phases.empty())
         return true;
 
-    if (otherUsePlayerPhasingRules && m_phaseId.empty())
+    if (otherUsePlayerPhasingRules && m_phaseSet.empty())
         return true;
 
-    //! speed up case. should be done in any way. 
-    // As iteration not check empty data but it should be done.
-    if (phase.empty() && !m_phaseId.empty() || !phase.empty() && m_phaseId.empty())
-        return false;
-
-    //! check target phases
-    for (auto PhaseID : phase)
-    {
-        if (PhaseID >= m_phaseBit.size())
-            continue;
-
-        if (m_phaseBit[PhaseID])
-            return true;
-    }
-    return false;
+    //! check target phases, both sides empty was handled above
+    return m_phaseSet.Intersects(phases);
 }
 
-std::set<uint32> const& WorldObject::GetPhases() const
+bool WorldObject::InSamePhaseId(std::set<uint32> const& phase, bool otherUsePlayerPhasingRules) const
 {
-    return m_phaseId;
+    bool usePlayerPhasingRules = IsPlayer() || IsUnitOwnedByPlayer();
+
+    if (IgnorePhaseId())
+        return true;
+
+    if (usePlayerPhasingRules && otherUsePlayerPhasingRules)
+        return true;
+
+    if (phase.empty() && m_phaseSet.empty())
+        return true;
+
+    if (usePlayerPhasingRules && phase.empty())
+        return true;
+
+    if (otherUsePlayerPhasingRules && m_phaseSet.empty())
+        return true;
+
+    return m_phaseSet.Intersects(phase);
 }
 
 bool WorldObject::InSamePhaseId(WorldObject const* obj) const
 {
-    return obj->IgnorePhaseId() || InSamePhaseId(obj->GetPhases(), obj->IsPlayer() || obj->IsUnitOwnedByPlayer());
+    return obj->IgnorePhaseId() || InSamePhaseId(obj->GetPhaseSet(), obj->IsPlayer() || obj->IsUnitOwnedByPlayer());
 }
 
 bool WorldObject::InSamePhase(WorldObject const* obj) const
@@ -3888,32 +3924,23 @@ bool WorldObject::InSamePhase(WorldObject const* obj) const
 
 bool WorldObject::RemovePhase(uint32 PhaseID)
 {
-    if (PhaseID >= m_phaseBit.size() || !m_phaseBit[PhaseID])
+    if (!m_phaseSet.Contains(PhaseID))
         return false;
 
-    m_phaseBit[PhaseID] = false;
-
-    return m_phaseId.erase(PhaseID);
+    std::set<uint32> phases = m_phaseSet.GetIdSet();
+    phases.erase(PhaseID);
+    m_phaseSet = PhaseSet::Intern(phases);
+    return true;
 }
 
 void WorldObject::SetPhaseId(std::set<uint32> const& newPhaseId, bool /*update*/)
 {
-    m_phaseBit.clear();
-    for (auto PhaseID : newPhaseId)
-    {
-        if (PhaseID >= m_phaseBit.size())
-            m_phaseBit.resize(PhaseID+1, false);
-
-        m_phaseBit[PhaseID] = true;
-    }
-    m_phaseId = newPhaseId;
+    m_phaseSet = PhaseSet::Intern(newPhaseId);
 };
 
 bool WorldObject::HasPhaseId(uint32 PhaseID) const
 {
-    if (PhaseID >= m_phaseBit.size())
-        return false;
-    return m_phaseBit[PhaseID];
+    return m_phaseSet.Contains(PhaseID);
 }
 
 C_PTR WorldObject::get_ptr()
@@ -4027,8 +4054,7 @@ void WorldObject::Clear()
 {
     Object::Clear();
 
-    m_phaseId.clear();
-    m_phaseBit.clear();
+    m_phaseSet = PhaseSet();
     _terrainSwaps.clear();
     _worldMapAreaSwaps.clear();
     _visibilityPlayerList.clear();
@@ -25,6 +25,7 @@
 #include "ModelIgnoreFlags.h"
 #include "MovementInfo.h"
 #include "ObjectDefines.h"
+#include "PhaseSet.h"
 #include "UpdateData.h"
 #include "UpdateFields.h"
 
@@ -98,7 +99,12 @@ struct ObjectInvisibility final
     int32 amount;
 };
 
-typedef std::unordered_map<Player*, UpdateData> UpdateDataMapType;
+// Values blocks built during one BuildUpdate pass, shared by every receiver of the same visibility class
+struct ValuesUpdateCache
+{
+    bool Shareable = false;
+    std::vector<std::pair<uint32 /*updateClass*/, ByteBuffer>> Blocks;
+};
 
 namespace UpdateMask
 {
@@ -200,6 +206,7 @@ class TC_GAME_API Object
         void SendUpdateToPlayer(Player* player);
 
         void BuildValuesUpdateBlockForPlayer(UpdateData* data, Player* target) const;
+        bool BuildValuesUpdateBlock(ByteBuffer& buf, Player* target) const;
         void BuildOutOfRangeUpdateBlock(UpdateData* data) const;
 
         virtual void DestroyForPlayer(Player* target) const;
@@ -313,7 +320,11 @@ class TC_GAME_API Object
         virtual bool hasInvolvedQuest(uint32 /* quest_id */) const { return false; }
         virtual void BuildUpdate(UpdateDataMapType&) {}
 
-        void BuildFieldsUpdate(Player*, UpdateDataMapType &) const;
+        void BuildFieldsUpdate(Player*, UpdateDataMapType &, ValuesUpdateCache* cache = nullptr) const;
+
+        // true when the pending values update depends on the receiver only through GetValuesUpdateClass
+        virtual bool CanShareValuesUpdate() const { return false; }
+        virtual bool GetValuesUpdateClass(Player const* /*target*/, uint32& /*updateClass*/) const { return false; }
 
         void SetFieldNotifyFlag(uint16 flag) { _fieldNotifyFlags |= flag; }
         void RemoveFieldNotifyFlag(uint16 flag) { _fieldNotifyFlags &= ~flag; }
@@ -492,8 +503,10 @@ class TC_GAME_API WorldObject : public Object, public WorldLocation
 
         virtual void SetPhaseId(std::set<uint32> const& newPhaseId, bool update);
         bool HasPhaseId(uint32 PhaseID) const;
-        std::set<uint32> const& GetPhases() const;
+        std::set<uint32> const& GetPhases() const { return m_phaseSet.GetIdSet(); }
+        PhaseSet GetPhaseSet() const { return m_phaseSet; }
         bool InSamePhaseId(WorldObject const* obj) const;
+        bool InSamePhaseId(PhaseSet phases, bool otherUsePlayerPhasingRules) const;
         bool InSamePhaseId(std::set<uint32> const& phase, bool otherUsePlayerPhasingRules) const;
         void RebuildTerrainSwaps();
         void RebuildWorldMapAreaSwaps();
@@ -510,6 +523,8 @@ class TC_GAME_API WorldObject : public Object, public WorldLocation
         uint32 m_areaId;
         uint32 m_oldAreaId;
 
+        uint64 m_updateCollectGeneration;                   // Map::Update pass that already queued this object for update
+
         uint32 GetCurrentAreaID() const { return m_areaId; }
         uint32 GetCurrentZoneID() const { return m_zoneId; }
         uint32 GetOldAreaID() const { return m_oldAreaId; }
@@ -755,8 +770,7 @@ class TC_GAME_API WorldObject : public Object, public WorldLocation
         //uint32 m_mapId;                                     // object at map with map_id
         uint32 m_InstanceId;                                // in map copy with instance id
         uint32 m_phaseMask;                                 // in area phase state
-        std::set<uint32> m_phaseId;                         // special phase. It's new generation phase, when we should check id.
-        std::vector<bool> m_phaseBit;
+        PhaseSet m_phaseSet;                                // special phase. It's new generation phase, when we should check id.
         bool m_ignorePhaseIdCheck;                          // like gm mode.
         std::set<uint32> _terrainSwaps;
         std::set<uint32> _worldMapAreaSwaps;
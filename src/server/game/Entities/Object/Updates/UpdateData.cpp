@@ -43,6 +43,13 @@ void UpdateData::AddUpdateBlock(const ByteBuffer &block)
     ++m_blockCount;
 }
 
+void UpdateData::AddUpdateData(UpdateData const& data)
+{
+    m_data.append(data.m_data);
+    m_blockCount += data.m_blockCount;
+    m_outOfRangeGUIDs.insert(data.m_outOfRangeGUIDs.begin(), data.m_outOfRangeGUIDs.end());
+}
+
 bool UpdateData::BuildPacket(WorldPacket* packet)
 {
     ASSERT(packet->empty());                                // shouldn't happen
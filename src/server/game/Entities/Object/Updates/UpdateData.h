@@ -21,6 +21,7 @@
 
 #include "ByteBuffer.h"
 #include "ObjectGuid.h"
+#include <unordered_map>
 
 class WorldPacket;
 
@@ -60,9 +61,11 @@ class TC_GAME_API UpdateData
         void AddOutOfRangeGUID(GuidSet& guids);
         void AddOutOfRangeGUID(ObjectGuid guid);
         void AddUpdateBlock(const ByteBuffer &block);
+        void AddUpdateData(UpdateData const& data);
         bool BuildPacket(WorldPacket* packet);
         bool HasData() const;
         void Clear();
+        void SetMapId(uint16 map) { m_map = map; }
 
         GuidSet const& GetOutOfRangeGUIDs() const;
 
@@ -72,5 +75,7 @@ class TC_GAME_API UpdateData
         GuidSet m_outOfRangeGUIDs;
         ByteBuffer m_data;
 };
+
+typedef std::unordered_map<Player*, UpdateData> UpdateDataMapType;
 #endif
 
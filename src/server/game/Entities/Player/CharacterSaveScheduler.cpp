@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2008-2017 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "CharacterSaveScheduler.h"
+#include "Log.h"
+#include "World.h"
+
+#include <algorithm>
+#include <limits>
+
+CharacterSaveScheduler::CharacterSaveScheduler() : _autosaveBudget(0)
+{
+}
+
+CharacterSaveScheduler::~CharacterSaveScheduler()
+{
+}
+
+CharacterSaveScheduler* CharacterSaveScheduler::instance()
+{
+    static CharacterSaveScheduler instance;
+    return &instance;
+}
+
+void CharacterSaveScheduler::Update(uint32 diff)
+{
+    if (uint32 interval = sWorld->getIntConfig(CONFIG_INTERVAL_SAVE))
+    {
+        uint64 expected = uint64(sWorld->GetActiveSessionCount()) * diff / interval;
+        _autosaveBudget = int32(std::min<uint64>(expected * 2 + 1, std::numeric_limits<int32>::max()));
+    }
+
+    std::lock_guard<std::mutex> guard(_inFlightLock);
+    for (auto itr = _inFlight.begin(); itr != _inFlight.end();)
+    {
+        if (itr->second.InFlight.InvokeIfReady())
+            itr = Advance(itr);
+        else
+            ++itr;
+    }
+}
+
+void CharacterSaveScheduler::Flush()
+{
+    std::lock_guard<std::mutex> guard(_inFlightLock);
+    while (!_inFlight.empty())
+    {
+        for (auto itr = _inFlight.begin(); itr != _inFlight.end();)
+        {
+            itr->second.InFlight.m_future.wait();
+            itr->second.InFlight.InvokeIfReady();
+            itr = Advance(itr);
+        }
+    }
+}
+
+CharacterSaveScheduler::SaveMap::iterator CharacterSaveScheduler::Advance(SaveMap::iterator itr)
+{
+    if (itr->second.Queued.empty())
+        return _inFlight.erase(itr);
+
+    QueuedSave& next = itr->second.Queued.front();
+    itr->second.InFlight = Send(itr->first, std::move(next.Trans), std::move(next.OnCommitted));
+    itr->second.Queued.pop_front();
+    return ++itr;
+}
+
+bool CharacterSaveScheduler::TryReserveAutosave()
+{
+    // the save queue is already behind, adding more only delays everything queued with it
+    if (CharacterDatabase.IsBackpressured(DATABASE_LANE_SAVE))
+        return false;
+
+    return --_autosaveBudget >= 0;
+}
+
+bool CharacterSaveScheduler::IsSaveInFlight(ObjectGuid::LowType guid) const
+{
+    std::lock_guard<std::mutex> guard(_inFlightLock);
+    return _inFlight.find(guid) != _inFlight.end();
+}
+
+void CharacterSaveScheduler::Commit(ObjectGuid::LowType guid, CharacterDatabaseTransaction trans, std::function<void()> onCommitted /*= nullptr*/)
+{
+    std::lock_guard<std::mutex> guard(_inFlightLock);
+    auto itr = _inFlight.find(guid);
+    if (itr == _inFlight.end())
+    {
+        _inFlight.emplace(guid, Send(guid, std::move(trans), std::move(onCommitted)));
+        return;
+    }
+
+    // with more than one worker the database could commit it before the older save
+    itr->second.Queued.push_back({ std::move(trans), std::move(onCommitted) });
+}
+
+TransactionCallback CharacterSaveScheduler::Send(ObjectGuid::LowType guid, CharacterDatabaseTransaction trans, std::function<void()> onCommitted)
+{
+    TransactionCallback callback = CharacterDatabase.AsyncCommitTransaction(trans, DATABASE_LANE_SAVE);
+    callback.AfterComplete([guid, onCommitted = std::move(onCommitted)](bool success)
+    {
+        if (!success)
+            TC_LOG_ERROR("entities.player", "CharacterSaveScheduler: save of character " UI64FMTD " failed", guid);
+        else if (onCommitted)
+            onCommitted();
+    });
+    return callback;
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2008-2017 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __TRINITY_CHARACTERSAVESCHEDULER_H
+#define __TRINITY_CHARACTERSAVESCHEDULER_H
+
+#include "DatabaseEnv.h"
+#include "ObjectGuid.h"
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+
+/*
+ * Paces player saves.
+ *
+ * - Autosaves get a per world tick budget of about twice the average rate
+ *   (online players * tick / PlayerSaveInterval), players over the budget retry
+ *   on the next tick instead of all saving in the same tick after a mass login.
+ *   No autosave is started while the character database save lane is backpressured.
+ * - Player::RequestSave moves the next save to at most PlayerSave.CoalesceWindow
+ *   ahead, every request inside that window is written by the same save.
+ * - Every character save transaction goes through Commit, which remembers it
+ *   until the database has written it. Autosaves and requested saves wait while
+ *   a save of the same character is still queued, so they never overlap and
+ *   nothing is held back once it has been built.
+ * - A forced save built while an older save of the same character is in flight
+ *   is queued behind it and only sent to the database once the older one is
+ *   done, so the saves of one character always commit in the order they were built.
+ * - Neither wait exceeds PlayerSave.MaxDelay, forced saves (logout, shutdown,
+ *   direct SaveToDB calls) are never delayed.
+ */
+class TC_GAME_API CharacterSaveScheduler
+{
+public:
+    static CharacterSaveScheduler* instance();
+
+    /// Called at the start of every world tick
+    void Update(uint32 diff);
+
+    /// False when this tick already used its share of autosaves or the save queue is backpressured
+    bool TryReserveAutosave();
+    bool IsSaveInFlight(ObjectGuid::LowType guid) const;
+
+    /// onCommitted runs on the world thread once the database wrote the transaction
+    void Commit(ObjectGuid::LowType guid, CharacterDatabaseTransaction trans, std::function<void()> onCommitted = nullptr);
+
+    /// Blocks until every queued save was written, called at shutdown after the last world tick
+    void Flush();
+
+private:
+    CharacterSaveScheduler();
+    ~CharacterSaveScheduler();
+
+    struct QueuedSave
+    {
+        CharacterDatabaseTransaction Trans;
+        std::function<void()> OnCommitted;
+    };
+
+    struct CharacterSaves
+    {
+        CharacterSaves(TransactionCallback&& inFlight) : InFlight(std::move(inFlight)) { }
+
+        TransactionCallback InFlight;
+        std::deque<QueuedSave> Queued;                      // forced saves waiting for InFlight
+    };
+
+    typedef std::unordered_map<ObjectGuid::LowType, CharacterSaves> SaveMap;
+
+    static TransactionCallback Send(ObjectGuid::LowType guid, CharacterDatabaseTransaction trans, std::function<void()> onCommitted);
+    // InFlight of itr is done: runs its callback and sends the next queued save, returns the next entry
+    SaveMap::iterator Advance(SaveMap::iterator itr);
+
+    std::atomic<int32> _autosaveBudget;
+
+    mutable std::mutex _inFlightLock;
+    SaveMap _inFlight;
+};
+
+#define sCharacterSaveScheduler CharacterSaveScheduler::instance()
+
+#endif
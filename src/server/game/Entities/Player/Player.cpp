@@ -39,6 +39,7 @@
 #include "ChallengeMgr.h"
 #include "Channel.h"
 #include "ChannelMgr.h"
+#include "CharacterSaveScheduler.h"
 #include "CharacterData.h"
 #include "CharacterDatabaseCleaner.h"
 #include "CharacterPackets.h"
@@ -83,6 +84,7 @@
 #include "MapManager.h"
 #include "MiscPackets.h"
 #include "MovementPackets.h"
+#include "MultiRowInsert.h"
 #include "NPCPackets.h"
 #include "ObjectAccessor.h"
 #include "ObjectMgr.h"
@@ -104,6 +106,7 @@
 #include "ScenePackets.h"
 #include "ScriptsData.h"
 #include "SkillDiscovery.h"
+#include "SharedWorldPacket.h"
 #include "SocialMgr.h"
 #include "SpectatorAddon.h"
 #include "Spell.h"
@@ -220,6 +223,8 @@ m_achievementMgr(sf::safe_ptr<AchievementMgr<Player>>(this))
     NeedUpdateVisibility = false;
 
     m_nextSave = sWorld->getIntConfig(CONFIG_INTERVAL_SAVE);
+    m_saveDelay = 0;
+    m_savedAuras = std::make_shared<SavedAuraRows>();
 
     _resurrectionData = NULL;
 
@@ -1715,9 +1720,19 @@ void Player::Update(uint32 p_time)
     {
         if (p_time >= m_nextSave)
         {
-            // m_nextSave reseted in SaveToDB call
-            SaveToDB();
-            TC_LOG_DEBUG("entities.player", "Player '%s' (GUID: %u) saved", GetName(), GetGUIDLow());
+            // hold the save back while the last one is still queued or this tick is out of autosaves
+            if (m_saveDelay < sWorld->getIntConfig(CONFIG_INTERVAL_SAVE_MAX_DELAY) &&
+                (sCharacterSaveScheduler->IsSaveInFlight(GetGUIDLow()) || !sCharacterSaveScheduler->TryReserveAutosave()))
+            {
+                m_saveDelay += p_time;
+                m_nextSave = 1;
+            }
+            else
+            {
+                // m_nextSave reseted in SaveToDB call
+                SaveToDB();
+                TC_LOG_DEBUG("entities.player", "Player '%s' (GUID: %u) saved", GetName(), GetGUIDLow());
+            }
         }
         else
             m_nextSave -= p_time;
@@ -8582,6 +8597,12 @@ void Player::SendDirectMessage(WorldPacket const* data) const
         m_session->SendPacket(data);
 }
 
+void Player::SendDirectMessage(SharedWorldPacket const& data) const
+{
+    if (!IsDelete() && m_session)
+        m_session->SendPacket(data);
+}
+
 void Player::SendCinematicStart(uint32 CinematicSequenceId)
 {
     WorldPackets::Misc::TriggerCinematic packet;
@@ -9264,7 +9285,8 @@ void Player::_LoadCurrency(PreparedQueryResult result)
 
 void Player::_SaveCurrency(CharacterDatabaseTransaction& trans)
 {
-    CharacterDatabasePreparedStatement* stmt = NULL;
+    // new and changed currencies both write every column, one REPLACE covers them
+    MultiRowInsert currencies("REPLACE INTO character_currency (guid, currency, week_count, total_count, season_total, flags, curentcap) VALUES ");
     for (PlayerCurrenciesMap::iterator itr = _currencyStorage.begin(); itr != _currencyStorage.end(); ++itr)
     {
         CurrencyTypesEntry const* entry = sCurrencyTypesStore.LookupEntry(itr->first);
@@ -9274,26 +9296,15 @@ void Player::_SaveCurrency(CharacterDatabaseTransaction& trans)
         switch(itr->second.state)
         {
         case PLAYERCURRENCY_NEW:
-            stmt = CharacterDatabase.GetPreparedStatement(CHAR_REP_PLAYER_CURRENCY);
-            stmt->setUInt64(0, GetGUIDLow());
-            stmt->setUInt16(1, itr->first);
-            stmt->setUInt32(2, itr->second.weekCount);
-            stmt->setUInt32(3, itr->second.totalCount);
-            stmt->setUInt32(4, itr->second.seasonTotal);
-            stmt->setUInt8(5, itr->second.flags);
-            stmt->setUInt32(6, itr->second.curentCap);
-            trans->Append(stmt);
-            break;
         case PLAYERCURRENCY_CHANGED:
-            stmt = CharacterDatabase.GetPreparedStatement(CHAR_UPD_PLAYER_CURRENCY);
-            stmt->setUInt32(0, itr->second.weekCount);
-            stmt->setUInt32(1, itr->second.totalCount);
-            stmt->setUInt32(2, itr->second.seasonTotal);
-            stmt->setUInt8(3, itr->second.flags);
-            stmt->setUInt32(4, itr->second.curentCap);
-            stmt->setUInt64(5, GetGUIDLow());
-            stmt->setUInt16(6, itr->first);
-            trans->Append(stmt);
+            currencies.NewRow()
+                .Add(GetGUIDLow())
+                .Add(uint16(itr->first))
+                .Add(uint32(itr->second.weekCount))
+                .Add(uint32(itr->second.totalCount))
+                .Add(uint32(itr->second.seasonTotal))
+                .Add(uint8(itr->second.flags))
+                .Add(uint32(itr->second.curentCap));
             break;
         default:
             break;
@@ -9301,6 +9312,8 @@ void Player::_SaveCurrency(CharacterDatabaseTransaction& trans)
 
         itr->second.state = PLAYERCURRENCY_UNCHANGED;
     }
+
+    currencies.AppendTo(*trans);
 }
 
 void Player::SendCurrencies()
@@ -24715,10 +24728,23 @@ bool Player::_LoadHomeBind(PreparedQueryResult result)
 /***                   SAVE SYSTEM                     ***/
 /*********************************************************/
 
+void Player::RequestSave()
+{
+    uint32 window = sWorld->getIntConfig(CONFIG_INTERVAL_SAVE_COALESCE);
+    if (!window || !m_nextSave)
+    {
+        SaveToDB();
+        return;
+    }
+
+    m_nextSave = std::min(m_nextSave, window);
+}
+
 void Player::SaveToDB(bool create /*=false*/)
 {
     // delay auto save at any saves (manual, in code, or autosave)
     m_nextSave = sWorld->getIntConfig(CONFIG_INTERVAL_SAVE);
+    m_saveDelay = 0;
 
     //lets allow only players in world to be saved
     if (IsBeingTeleportedFar())
@@ -25061,7 +25087,18 @@ void Player::SaveToDB(bool create /*=false*/)
     _SaveArmyTrainingInfo(trans);
     _SaveAccountProgress(trans);
 
-    CharacterDatabase.CommitTransaction(trans);
+    std::function<void()> onCommitted;
+    if (m_queuedAuraRows)
+    {
+        onCommitted = [saved = m_savedAuras, rows = std::move(*m_queuedAuraRows)]() mutable
+        {
+            std::lock_guard<std::mutex> guard(saved->Lock);
+            saved->Rows = std::move(rows);
+        };
+        m_queuedAuraRows.reset();
+    }
+
+    sCharacterSaveScheduler->Commit(GetGUIDLow(), trans, std::move(onCommitted));
 
     // TODO: Move this out
     LoginDatabaseTransaction trans2 = LoginDatabase.BeginTransaction();
@@ -25360,12 +25397,10 @@ void Player::_SaveActions(CharacterDatabaseTransaction& trans)
 
 void Player::_SaveAuras(CharacterDatabaseTransaction& trans)
 {
-    CharacterDatabasePreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_CHAR_AURA);
-    stmt->setUInt64(0, GetGUIDLow());
-    trans->Append(stmt);
-    stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_CHAR_AURA_EFFECT);
-    stmt->setUInt64(0, GetGUIDLow());
-    trans->Append(stmt);
+    m_queuedAuraRows.reset();
+
+    MultiRowInsert auras("INSERT INTO character_aura (guid, slot, caster_guid, item_guid, spell, effect_mask, recalculate_mask, stackcount, maxduration, remaintime, remaincharges) VALUES ");
+    MultiRowInsert effects("INSERT INTO character_aura_effect (guid, slot, effect, baseamount, amount) VALUES ");
 
     for (AuraMap::const_iterator itr = m_ownedAuras.begin(); itr != m_ownedAuras.end(); ++itr)
     {
@@ -25377,22 +25412,18 @@ void Player::_SaveAuras(CharacterDatabaseTransaction& trans)
         if(!foundAura)
             continue;
 
-        uint8 index = 0;
         uint32 effMask = 0;
         uint32 recalculateMask = 0;
         for (uint8 i = 0; i < MAX_SPELL_EFFECTS; ++i)
         {
             if (AuraEffect const* effect = aura->GetEffect(i))
             {
-                index = 0;
-                stmt = CharacterDatabase.GetPreparedStatement(CHAR_INS_AURA_EFFECT);
-                stmt->setUInt64(index++, GetGUIDLow());
-                stmt->setUInt8(index++, foundAura->GetSlot());
-                stmt->setUInt8(index++, i);
-                stmt->setInt32(index++, effect->GetBaseAmount());
-                stmt->setInt32(index++, effect->GetAmount());
-
-                trans->Append(stmt);
+                effects.NewRow()
+                    .Add(GetGUIDLow())
+                    .Add(foundAura->GetSlot())
+                    .Add(i)
+                    .Add(int32(effect->GetBaseAmount()))
+                    .Add(int32(effect->GetAmount()));
 
                 effMask |= 1 << i;
                 if (effect->CanBeRecalculated())
@@ -25400,21 +25431,47 @@ void Player::_SaveAuras(CharacterDatabaseTransaction& trans)
             }
         }
 
-        index = 0;
-        stmt = CharacterDatabase.GetPreparedStatement(CHAR_INS_AURA);
-        stmt->setUInt64(index++, GetGUIDLow());
-        stmt->setUInt8(index++, foundAura->GetSlot());
-        stmt->setBinary(index++, itr->second->GetCasterGUID().GetRawValue());
-        stmt->setBinary(index++, itr->second->GetCastItemGUID().GetRawValue());
-        stmt->setUInt32(index++, itr->second->GetId());
-        stmt->setUInt16(index++, effMask);
-        stmt->setUInt8(index++, recalculateMask);
-        stmt->setUInt8(index++, itr->second->GetStackAmount());
-        stmt->setInt32(index++, itr->second->GetMaxDuration());
-        stmt->setInt32(index++, itr->second->GetDuration());
-        stmt->setUInt8(index, itr->second->GetCharges());
-        trans->Append(stmt);
+        auras.NewRow()
+            .Add(GetGUIDLow())
+            .Add(foundAura->GetSlot())
+            .AddBinary(itr->second->GetCasterGUID().GetRawValue())
+            .AddBinary(itr->second->GetCastItemGUID().GetRawValue())
+            .Add(itr->second->GetId())
+            .Add(uint16(effMask))
+            .Add(uint8(recalculateMask))
+            .Add(uint8(itr->second->GetStackAmount()))
+            .Add(itr->second->GetMaxDuration())
+            .Add(itr->second->GetDuration())
+            .Add(itr->second->GetCharges());
     }
+
+    // auras that only have permanent effects usually look the same on every save,
+    // skip them when the database already confirmed exactly these rows. Not while an
+    // older save is still queued, it can still overwrite them with different rows
+    std::vector<std::string> rows;
+    for (MultiRowInsert* insert : { &auras, &effects })
+    {
+        std::vector<std::string> const& statements = insert->Finish();
+        rows.insert(rows.end(), statements.begin(), statements.end());
+    }
+
+    if (!sCharacterSaveScheduler->IsSaveInFlight(GetGUIDLow()))
+    {
+        std::lock_guard<std::mutex> guard(m_savedAuras->Lock);
+        if (m_savedAuras->Rows && *m_savedAuras->Rows == rows)
+            return;
+    }
+
+    CharacterDatabasePreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_CHAR_AURA);
+    stmt->setUInt64(0, GetGUIDLow());
+    trans->Append(stmt);
+    stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_CHAR_AURA_EFFECT);
+    stmt->setUInt64(0, GetGUIDLow());
+    trans->Append(stmt);
+
+    effects.AppendTo(*trans);
+    auras.AppendTo(*trans);
+    m_queuedAuraRows = std::move(rows);
 }
 
 void Player::_SaveInventory(CharacterDatabaseTransaction& trans)
@@ -25906,7 +25963,8 @@ void Player::_SaveAdventureQuest(CharacterDatabaseTransaction& trans)
 void Player::_SaveSkills(CharacterDatabaseTransaction& trans)
 {
     CharacterDatabasePreparedStatement* stmt = NULL;
-    // we don't need transactions here.
+    // new and changed skills both write every column, one REPLACE covers them
+    MultiRowInsert skills("REPLACE INTO character_skills (guid, skill, value, max) VALUES ");
     for (SkillStatusMap::iterator itr = mSkillStatus.begin(); itr != mSkillStatus.end();)
     {
         if (itr->second.uState == SKILL_UNCHANGED)
@@ -25936,20 +25994,12 @@ void Player::_SaveSkills(CharacterDatabaseTransaction& trans)
         switch (itr->second.uState)
         {
             case SKILL_NEW:
-                stmt = CharacterDatabase.GetPreparedStatement(CHAR_INS_CHAR_SKILLS);
-                stmt->setUInt64(0, GetGUIDLow());
-                stmt->setUInt16(1, uint16(itr->first));
-                stmt->setUInt16(2, value);
-                stmt->setUInt16(3, max);
-                trans->Append(stmt);
-                break;
             case SKILL_CHANGED:
-                stmt = CharacterDatabase.GetPreparedStatement(CHAR_UDP_CHAR_SKILLS);
-                stmt->setUInt16(0, value);
-                stmt->setUInt16(1, max);
-                stmt->setUInt64(2, GetGUIDLow());
-                stmt->setUInt16(3, uint16(itr->first));
-                trans->Append(stmt);
+                skills.NewRow()
+                    .Add(GetGUIDLow())
+                    .Add(uint16(itr->first))
+                    .Add(value)
+                    .Add(max);
                 break;
             default:
                 break;
@@ -25958,18 +26008,22 @@ void Player::_SaveSkills(CharacterDatabaseTransaction& trans)
         itr->second.uState = SKILL_UNCHANGED;
         ++itr;
     }
+
+    skills.AppendTo(*trans);
 }
 
 void Player::_SaveSpells(CharacterDatabaseTransaction& trans)
 {
     CharacterDatabasePreparedStatement* stmt = NULL;
+    MultiRowInsert spells("REPLACE INTO character_spell (guid, spell, active, disabled) VALUES ");
 
     for (PlayerSpellMap::iterator itr = m_spells.begin(); itr != m_spells.end(); ++itr)
     {
         if (itr->second.state == PLAYERSPELL_TEMPORARY)
             continue;
 
-        if (itr->second.state == PLAYERSPELL_REMOVED || itr->second.state == PLAYERSPELL_CHANGED)
+        // a changed spell that is still saved is overwritten by the REPLACE below
+        if (itr->second.state == PLAYERSPELL_REMOVED || (itr->second.state == PLAYERSPELL_CHANGED && itr->second.dependent))
         {
             stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_CHAR_SPELL_BY_SPELL);
             stmt->setUInt32(0, itr->first);
@@ -25980,12 +26034,11 @@ void Player::_SaveSpells(CharacterDatabaseTransaction& trans)
         // add only changed/new not dependent spells
         if (!itr->second.dependent && (itr->second.state == PLAYERSPELL_NEW || itr->second.state == PLAYERSPELL_CHANGED))
         {
-            stmt = CharacterDatabase.GetPreparedStatement(CHAR_INS_CHAR_SPELL);
-            stmt->setUInt64(0, GetGUIDLow());
-            stmt->setUInt32(1, itr->first);
-            stmt->setBool(2, itr->second.active);
-            stmt->setBool(3, itr->second.disabled);
-            trans->Append(stmt);
+            spells.NewRow()
+                .Add(GetGUIDLow())
+                .Add(itr->first)
+                .Add(itr->second.active)
+                .Add(itr->second.disabled);
         }
 
         if (itr->second.state == PLAYERSPELL_REMOVED)
@@ -25993,6 +26046,8 @@ void Player::_SaveSpells(CharacterDatabaseTransaction& trans)
         else
             itr->second.state = PLAYERSPELL_UNCHANGED;
     }
+
+    spells.AppendTo(*trans);
 }
 
 void Player::_SaveCUFProfiles(CharacterDatabaseTransaction& trans)
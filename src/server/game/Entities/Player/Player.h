@@ -45,6 +45,8 @@
 #include "SpellMgr.h"
 #include "Unit.h"
 #include "Util.h"
+#include <mutex>
+#include <optional>
 #include <queue>
 #include <safe_ptr.h>
 
@@ -699,6 +701,7 @@ typedef std::vector<int16> SkillSpellCount;
 class Quest;
 class Spell;
 class Item;
+class SharedWorldPacket;
 class WorldSession;
 
 enum PlayerSlots
@@ -2066,6 +2069,9 @@ class TC_GAME_API Player : public Unit, public GridObject<Player>
         /*********************************************************/
 
         void SaveToDB(bool create = false);
+        /// Saves within PlayerSave.CoalesceWindow, repeated requests end up in one save.
+        /// Only for routine checkpoints, irreversible changes (faction, race, teleports, resurrects) call SaveToDB
+        void RequestSave();
         void SaveInventoryAndGoldToDB(CharacterDatabaseTransaction& trans);                    // fast save function for item/money cheating preventing
         void SaveGoldToDB(CharacterDatabaseTransaction& trans);
 
@@ -2727,6 +2733,7 @@ class TC_GAME_API Player : public Unit, public GridObject<Player>
         void SetLastWorldStateUpdateTime(time_t _time) { m_lastWSUpdateTime = _time; };
         
         void SendDirectMessage(WorldPacket const* data) const;
+        void SendDirectMessage(SharedWorldPacket const& data) const;
 
         void SendAurasForTarget(Unit* target);
         void SendSpellHistoryData();
@@ -3382,6 +3389,14 @@ class TC_GAME_API Player : public Unit, public GridObject<Player>
 
         uint32 m_team;
         uint32 m_nextSave;
+        uint32 m_saveDelay;                                 // time the due save has been held back, see CharacterSaveScheduler
+        struct SavedAuraRows
+        {
+            std::mutex Lock;
+            std::optional<std::vector<std::string>> Rows;   // set from the save commit callback, empty until a save was confirmed
+        };
+        std::shared_ptr<SavedAuraRows> m_savedAuras;        // aura rows the database has, outlives the player for pending saves
+        std::optional<std::vector<std::string>> m_queuedAuraRows;  // rows _SaveAuras added to the save being built
         time_t m_speakTime;
         uint32 m_speakCount;
         Difficulty m_dungeonDifficulty;
@@ -83,6 +83,7 @@
 #include "World.h"
 #include "WorldPacket.h"
 #include "WorldSession.h"
+#include <boost/container/small_vector.hpp>
 #include <numeric>
 
 float baseMoveSpeed[MAX_MOVE_TYPE] =
@@ -263,6 +264,10 @@ playerDamageTaken_(), npcDamageTaken_()
         m_ObjectSlot[i].Clear();
 
     m_auraUpdateIterator = m_ownedAuras.end();
+    m_appliedAuraFilter.fill(0);
+    m_procAuraSequence = 0;
+    m_procAuraVisit = 0;
+    m_procAuraSpawnMode = GetSpawnMode();
 
     m_interruptMask.fill(0);
     m_transform = 0;
@@ -4560,8 +4565,12 @@ AuraApplication * Unit::_CreateAuraApplication(Aura* aura, uint32 effMask)
     AuraApplicationPtr aurApp = std::make_shared<AuraApplication>(this, caster, aura, effMask);
     m_appliedAuras.insert(std::make_pair(aurId, aurApp));
 
-    if (aurSpellInfo->GetAuraOptions(GetSpawnMode())->IsProcAura)
-        m_procAuras.insert(std::make_pair(aurId, aurApp));
+    // saturated slots stay set for good, the tree walk still gives the right answer
+    uint8& filterSlot = GetAppliedAuraFilterSlot(aurId);
+    if (filterSlot != 0xFF)
+        ++filterSlot;
+
+    RegisterProcAura(aurApp);
     m_aura_lock.unlock();
 
     if (aurSpellInfo->HasAnyAuraInterruptFlag())
@@ -4589,6 +4598,76 @@ void Unit::_ApplyAuraEffect(Aura* aura, uint32 effIndex)
         aurApp->_HandleEffect(effIndex, true);
 }
 
+// proc flags an aura can react to with the unit's current difficulty, 0 if it never procs
+uint32 Unit::GetProcAuraMask(SpellInfo const* spellInfo) const
+{
+    SpellInfo::SpellAuraOptions const* auraOptions = spellInfo->GetAuraOptions(GetSpawnMode());
+    if (!auraOptions->IsProcAura)
+        return 0;
+
+    // IsTriggeredAtSpellProcEvent takes the flags of the matching spell_proc_event row or falls back to the spell's
+    uint32 procMask = auraOptions->ProcTypeMask;
+    if (std::vector<SpellProcEventEntry> const* spellProcEvents = sSpellMgr->GetSpellProcEvent(spellInfo->Id))
+        for (SpellProcEventEntry const& spellProcEvent : *spellProcEvents)
+            procMask |= spellProcEvent.procFlags;
+
+    return procMask;
+}
+
+void Unit::RegisterProcAura(AuraApplicationPtr const& aurApp)
+{
+    // masks depend on difficulty, a map change since the last registration invalidates all of them
+    if (m_procAuraSpawnMode != GetSpawnMode())
+    {
+        RebuildProcAuraIndex();
+        return;
+    }
+
+    uint32 procMask = GetProcAuraMask(aurApp->GetBase()->GetSpellInfo());
+    aurApp->_SetProcSubscription(procMask, ++m_procAuraSequence);
+
+    for (uint32 bit = 0; procMask; ++bit, procMask >>= 1)
+        if (procMask & 1)
+            m_procAuraBuckets[bit].push_back(aurApp);
+}
+
+void Unit::UnregisterProcAura(AuraApplication* aurApp)
+{
+    uint32 procMask = aurApp->GetProcMask();
+    for (uint32 bit = 0; procMask; ++bit, procMask >>= 1)
+    {
+        if (!(procMask & 1))
+            continue;
+
+        ProcAuraBucket& bucket = m_procAuraBuckets[bit];
+        for (std::size_t i = 0; i < bucket.size(); ++i)
+        {
+            if (bucket[i].get() != aurApp)
+                continue;
+
+            // collection order comes from the registration sequence, bucket order does not matter
+            bucket[i] = std::move(bucket.back());
+            bucket.pop_back();
+            break;
+        }
+    }
+
+    aurApp->_SetProcSubscription(0, 0);
+}
+
+void Unit::RebuildProcAuraIndex()
+{
+    for (ProcAuraBucket& bucket : m_procAuraBuckets)
+        bucket.clear();
+
+    m_procAuraSpawnMode = GetSpawnMode();
+    m_procAuraSequence = 0;
+
+    for (AuraApplicationMap::value_type const& applied : m_appliedAuras)
+        if (applied.second && !applied.second->GetRemoveMode())
+            RegisterProcAura(applied.second);
+}
+
 // handles effects of aura application
 // should be done after registering aura in lists
 void Unit::_ApplyAura(AuraApplication * aurApp, uint32 effMask)
@@ -4661,9 +4740,13 @@ void Unit::_UnapplyAura(AuraApplicationMap::iterator &i, AuraRemoveMode removeMo
     Unit* caster = aura->GetCaster();
 
     // Remove all pointers from lists here to prevent possible pointer invalidation on spellcast/auraapply/auraremove
-    m_procAuras.erase(aura->GetId());
+    UnregisterProcAura(aurApp.get());
     m_appliedAuras.erase(i);
 
+    uint8& filterSlot = GetAppliedAuraFilterSlot(aura->GetId());
+    if (filterSlot != 0xFF)
+        --filterSlot;
+
     if (spellInfo->HasAnyAuraInterruptFlag())
     {
         m_interruptableAuras.remove(aurApp);
@@ -4815,6 +4898,70 @@ void Unit::_RegisterAuraEffect(AuraEffect* aurEff, bool apply)
         RecursiveGuard guard(i_auraEff_lock);
         m_modAuras[auraType].remove(aurEff);
     }
+
+    InvalidateAuraModifierTotals(auraType);
+}
+
+void Unit::InvalidateAuraModifierTotals(AuraType auratype)
+{
+    std::lock_guard<std::mutex> guard(m_modAuraTotalsLock);
+    m_modAuraTotals.erase(auratype);
+}
+
+Unit::AuraModifierTotals Unit::GetAuraModifierTotals(AuraType auratype) const
+{
+    std::lock_guard<std::mutex> guard(m_modAuraTotalsLock);
+
+    auto itr = m_modAuraTotals.find(auratype);
+    if (itr != m_modAuraTotals.end())
+        return itr->second;
+
+    // same walk as the predicated versions, all five totals in one pass
+    AuraModifierTotals totals;
+    totals.total = 0;
+    totals.raidTotal = 0;
+    totals.multiplier = 1.0f;
+    totals.maxPositive = 0;
+    totals.maxNegative = 0;
+
+    std::map<SpellGroup, int32> SameEffectSpellGroup;
+    std::map<SpellGroup, int32> SameEffectSpellGroupRaid;
+    int32 raidModifier = 0;
+
+    for (auto const& auraEffect : GetAuraEffectsByType(auratype))
+    {
+        if (!sSpellMgr->AddSameEffectStackRuleSpellGroups(auraEffect->GetSpellInfo(), auraEffect->GetAmount(), SameEffectSpellGroup))
+        {
+            totals.total += auraEffect->GetAmount();
+            AddPct(totals.multiplier, auraEffect->GetAmount());
+        }
+
+        if (auraEffect->GetSpellInfo()->HasAttribute(SPELL_ATTR7_CONSOLIDATED_RAID_BUFF))
+        {
+            if (auraEffect->GetAmount() > raidModifier)
+                raidModifier = auraEffect->GetAmount();
+        }
+        else if (!sSpellMgr->AddSameEffectStackRuleSpellGroups(auraEffect->GetSpellInfo(), auraEffect->GetAmount(), SameEffectSpellGroupRaid))
+            totals.raidTotal += auraEffect->GetAmount();
+
+        if (auraEffect->GetAmount() > totals.maxPositive)
+            totals.maxPositive = auraEffect->GetAmount();
+        if (auraEffect->GetAmount() < totals.maxNegative)
+            totals.maxNegative = auraEffect->GetAmount();
+    }
+
+    for (auto const& k : SameEffectSpellGroup)
+    {
+        totals.total += k.second;
+        AddPct(totals.multiplier, k.second);
+    }
+
+    for (auto const& k : SameEffectSpellGroupRaid)
+        totals.raidTotal += k.second;
+    totals.raidTotal += raidModifier;
+
+    m_modAuraTotals[auratype] = totals;
+    return totals;
 }
 
 // All aura base removes should go threw this function!
@@ -5806,6 +5953,9 @@ void Unit::GetAuraEffectsByMechanic(uint32 mechanic_mask, AuraList& auraList, Ob
 
 AuraEffect* Unit::GetAuraEffect(uint32 spellId, uint8 effIndex, ObjectGuid caster) const
 {
+    if (!MayHaveAppliedAura(spellId))
+        return nullptr;
+
     for (AuraApplicationMap::const_iterator itr = m_appliedAuras.lower_bound(spellId); itr != m_appliedAuras.upper_bound(spellId); ++itr)
         if (itr->second->HasEffect(effIndex) && (caster.IsEmpty() || itr->second->GetBase()->GetCasterGUID() == caster))
             return itr->second->GetBase()->GetEffect(effIndex);
@@ -5846,6 +5996,9 @@ AuraEffect* Unit::GetAuraEffect(AuraType type, SpellFamilyNames family, uint32 f
 
 AuraApplication * Unit::GetAuraApplication(uint32 spellId, ObjectGuid casterGUID, ObjectGuid itemCasterGUID, uint32 reqEffMask, AuraApplication * except) const
 {
+    if (!MayHaveAppliedAura(spellId))
+        return nullptr;
+
     for (AuraApplicationMap::const_iterator itr = m_appliedAuras.lower_bound(spellId); itr != m_appliedAuras.upper_bound(spellId); ++itr)
     {
         Aura const* aura = itr->second->GetBase();
@@ -6279,22 +6432,35 @@ int32 Unit::GetMaxPositiveAuraModifier(AuraType auratype, std::function<bool(Aur
 
 int32 Unit::GetTotalAuraModifier(AuraType auratype, bool raid) const
 {
-    return GetTotalAuraModifier(auratype, [](AuraEffect const* /*aurEff*/) { return true; }, raid);
+    if (m_modAuras[auratype].empty())
+        return 0;
+
+    AuraModifierTotals totals = GetAuraModifierTotals(auratype);
+    return raid ? totals.raidTotal : totals.total;
 }
 
 float Unit::GetTotalAuraMultiplier(AuraType auratype) const
 {
-    return GetTotalAuraMultiplier(auratype, [](AuraEffect const* /*aurEff*/) { return true; });
+    if (m_modAuras[auratype].empty())
+        return 1.0f;
+
+    return GetAuraModifierTotals(auratype).multiplier;
 }
 
 int32 Unit::GetMaxPositiveAuraModifier(AuraType auratype) const
 {
-    return GetMaxPositiveAuraModifier(auratype, [](AuraEffect const* /*aurEff*/) { return true; });
+    if (m_modAuras[auratype].empty())
+        return 0;
+
+    return GetAuraModifierTotals(auratype).maxPositive;
 }
 
 int32 Unit::GetMaxNegativeAuraModifier(AuraType auratype) const
 {
-    return GetMaxNegativeAuraModifier(auratype, [](AuraEffect const* /*aurEff*/) { return true; });
+    if (m_modAuras[auratype].empty())
+        return 0;
+
+    return GetAuraModifierTotals(auratype).maxNegative;
 }
 
 int32 Unit::GetTotalForAurasModifier(std::list<AuraType> *auratypelist) const
@@ -17571,7 +17737,9 @@ struct ProcTriggeredData
     bool isProcOneEff;
 };
 
-typedef std::list< ProcTriggeredData > ProcTriggeredList;
+// both live on the stack for the usual handful of procs per event
+typedef boost::container::small_vector<ProcTriggeredData, 16> ProcTriggeredList;
+typedef boost::container::small_vector<AuraApplicationPtr, 32> ProcAuraCandidates;
 
 // List of auras that CAN be trigger but may not exist in spell_proc_event
 // in most case need for drop charges
@@ -17775,13 +17943,38 @@ void Unit::ProcDamageAndSpellFor(bool isVictim, Unit* target, uint32 procFlag, u
     ProcEventInfo eventInfo = ProcEventInfo(actor, actionTarget, target, procFlag, 0, 0, procExtra, spell, dmgInfoProc, &healInfo);
 
     TimePoint now = GameTime::Now();
+
+    if (m_procAuraSpawnMode != GetSpawnMode())
+        RebuildProcAuraIndex();
+
+    // Collect the auras subscribed to any flag of this event, an aura listening to several of them is taken once.
+    // Scripts run below may apply or remove auras, so candidates are copied out of the buckets first.
+    ProcAuraCandidates candidates;
+    uint32 visit = ++m_procAuraVisit;
+    for (uint32 bit = 0, flags = procFlag; flags; ++bit, flags >>= 1)
+    {
+        if (!(flags & 1))
+            continue;
+
+        for (AuraApplicationPtr const& auraApp : m_procAuraBuckets[bit])
+            if (auraApp->_MarkProcVisit(visit))
+                candidates.push_back(auraApp);
+    }
+
+    // same order as walking the applied aura map: by spell id, then by application order
+    std::sort(candidates.begin(), candidates.end(), [](AuraApplicationPtr const& left, AuraApplicationPtr const& right)
+    {
+        if (left->GetBase()->GetId() != right->GetBase()->GetId())
+            return left->GetBase()->GetId() < right->GetBase()->GetId();
+        return left->GetProcSequence() < right->GetProcSequence();
+    });
+
     ProcTriggeredList procTriggered;
     // Fill procTriggered list
-    for (AuraApplicationMap::const_iterator itr = GetAppliedAuras().begin(); itr!= GetAppliedAuras().end(); ++itr)
+    for (AuraApplicationPtr const& auraApp : candidates)
     {
-        AuraApplicationPtr auraApp = itr->second;
         // Do not allow auras to proc from effect triggered by itself
-        if (procAura && procAura->Id == itr->first || !auraApp || !auraApp->GetBase()->GetSpellInfo()->GetAuraOptions(GetSpawnMode())->IsProcAura)
+        if (procAura && procAura->Id == auraApp->GetBase()->GetId())
             continue;
         ProcTriggeredData triggerData(auraApp->GetBase());
 
@@ -17838,7 +18031,7 @@ void Unit::ProcDamageAndSpellFor(bool isVictim, Unit* target, uint32 procFlag, u
             continue;
 
         // AuraScript Hook
-        if (!triggerData.aura->CallScriptCheckProcHandlers(itr->second.get(), eventInfo))
+        if (!triggerData.aura->CallScriptCheckProcHandlers(auraApp.get(), eventInfo))
             continue;
 
         // Triggered spells not triggering additional spells
@@ -17891,10 +18084,10 @@ void Unit::ProcDamageAndSpellFor(bool isVictim, Unit* target, uint32 procFlag, u
                         break;
                     }
                 if(!foundProc)
-                    procTriggered.push_front(triggerData);
+                    procTriggered.push_back(triggerData);
             }
             else
-                procTriggered.push_front(triggerData);
+                procTriggered.push_back(triggerData);
         }
     }
 
@@ -17910,8 +18103,8 @@ void Unit::ProcDamageAndSpellFor(bool isVictim, Unit* target, uint32 procFlag, u
     if (procExtra & (PROC_EX_INTERNAL_TRIGGERED | PROC_EX_INTERNAL_CANT_PROC))
         SetCantProc(true);
 
-    // Handle effects proceed this time
-    for (ProcTriggeredList::const_iterator i = procTriggered.begin(); i != procTriggered.end(); ++i)
+    // Handle effects proceed this time, latest collected first
+    for (ProcTriggeredList::const_reverse_iterator i = procTriggered.rbegin(); i != procTriggered.rend(); ++i)
     {
         // look for aura in auras list, it may be removed while proc event processing
         if (i->aura->IsRemoved())
@@ -25288,7 +25481,7 @@ void Unit::BuildValuesUpdate(uint8 updateType, ByteBuffer* data, Player* target)
 
     uint32 valCount = m_valuesCount;
     uint32* flags = UnitUpdateFieldFlags;
-    uint32 visibleFlag = UF_FLAG_PUBLIC;
+    uint32 visibleFlag = GetValuesUpdateVisibleFlag(target);
 
     if (target == this)
         visibleFlag |= UF_FLAG_PRIVATE;
@@ -25297,17 +25490,6 @@ void Unit::BuildValuesUpdate(uint8 updateType, ByteBuffer* data, Player* target)
 
     std::size_t blockCount = UpdateMask::GetBlockCount(valCount);
 
-    Player* plr = GetCharmerOrOwnerPlayerOrPlayerItself();
-    if (GetOwnerGUID() == target->GetGUID())
-        visibleFlag |= UF_FLAG_OWNER;
-
-    if (HasFlag(OBJECT_FIELD_DYNAMIC_FLAGS, UNIT_DYNFLAG_SPECIALINFO))
-        if (HasAuraTypeWithCaster(SPELL_AURA_EMPATHY, target->GetGUID()))
-            visibleFlag |= UF_FLAG_SPECIAL_INFO;
-
-    if (plr && plr->IsInSameRaidWith(target))
-        visibleFlag |= UF_FLAG_PARTY_MEMBER;
-
     Creature const* creature = ToCreature();
 
     *data << uint8(blockCount);
@@ -25491,6 +25673,63 @@ void Unit::BuildValuesUpdate(uint8 updateType, ByteBuffer* data, Player* target)
     }
 }
 
+uint32 Unit::GetValuesUpdateVisibleFlag(Player const* target) const
+{
+    uint32 visibleFlag = UF_FLAG_PUBLIC;
+
+    if (GetOwnerGUID() == target->GetGUID())
+        visibleFlag |= UF_FLAG_OWNER;
+
+    if (HasFlag(OBJECT_FIELD_DYNAMIC_FLAGS, UNIT_DYNFLAG_SPECIALINFO))
+        if (HasAuraTypeWithCaster(SPELL_AURA_EMPATHY, target->GetGUID()))
+            visibleFlag |= UF_FLAG_SPECIAL_INFO;
+
+    Player* plr = GetCharmerOrOwnerPlayerOrPlayerItself();
+    if (plr && plr->IsInSameRaidWith(target))
+        visibleFlag |= UF_FLAG_PARTY_MEMBER;
+
+    return visibleFlag;
+}
+
+bool Unit::CanShareValuesUpdate() const
+{
+    // fields that BuildValuesUpdate rewrites per receiver
+    static uint16 const targetDependentFields[] =
+    {
+        UNIT_FIELD_NPC_FLAGS, UNIT_FIELD_NPC_FLAGS2, UNIT_FIELD_AURA_STATE, UNIT_FIELD_FLAGS, UNIT_FIELD_DISPLAY_ID,
+        OBJECT_FIELD_DYNAMIC_FLAGS, UNIT_FIELD_BYTES_2, UNIT_FIELD_FACTION_TEMPLATE
+    };
+
+    for (uint16 index : targetDependentFields)
+        if (_changesMask[index])
+            return false;
+
+    // aura state is always sent (per receiver) while a per caster state is set
+    if (HasFlag(UNIT_FIELD_AURA_STATE, PER_CASTER_AURA_STATE_MASK))
+        return false;
+
+    if (IsPlayer())
+    {
+        if (_changesMask[PLAYER_FIELD_BYTES_6])
+            return false;
+
+        if (_dynamicChangesMask[PLAYER_DYNAMIC_FIELD_ARENA_COOLDOWNS] != UpdateMask::UNCHANGED)
+            return false;
+    }
+
+    return true;
+}
+
+bool Unit::GetValuesUpdateClass(Player const* target, uint32& updateClass) const
+{
+    // self gets private fields and the full player field range
+    if (target == this || target->needUpdateDynamicFlags)
+        return false;
+
+    updateClass = GetValuesUpdateVisibleFlag(target);
+    return true;
+}
+
 bool Unit::SetCanDoubleJump(bool enable)
 {
     if (enable == HasExtraUnitMovementFlag(MOVEMENTFLAG2_CAN_DOUBLE_JUMP))
@@ -27915,6 +28154,9 @@ void Unit::Clear()
     m_visibleAuras.clear();
     m_sharedVision.clear();
     m_appliedAuras.clear();
+    m_appliedAuraFilter.fill(0);
+    for (ProcAuraBucket& bucket : m_procAuraBuckets)
+        bucket.clear();
     m_ownedAuras.clear();
     m_removedAuras.clear();
     m_gameObj.clear();
@@ -27,6 +27,7 @@
 #include "FunctionProcessor.h"
 #include "HostileRefManager.h"
 #include "MotionMaster.h"
+#include "NodeCacheAllocator.h"
 #include "Object.h"
 #include "SharedDefines.h"
 #include "SpellAuraDefines.h"
@@ -1096,13 +1097,14 @@ class TC_GAME_API Unit : public WorldObject
 
     public:
         typedef std::set<ObjectGuid> ControlList;
-        typedef std::multimap<uint32, Aura*> AuraMap;
-        typedef std::multimap<uint32, AuraApplicationPtr> AuraApplicationMap;
+        // aura containers churn nodes on every apply/remove, their nodes are recycled per thread
+        typedef std::multimap<uint32, Aura*, std::less<uint32>, Trinity::NodeCacheAllocator<std::pair<uint32 const, Aura*>>> AuraMap;
+        typedef std::multimap<uint32, AuraApplicationPtr, std::less<uint32>, Trinity::NodeCacheAllocator<std::pair<uint32 const, AuraApplicationPtr>>> AuraApplicationMap;
         typedef std::multimap<AuraStateType,  AuraApplication*> AuraStateAurasMap;
-        typedef std::list<AuraEffect*> AuraEffectList;
+        typedef std::list<AuraEffect*, Trinity::NodeCacheAllocator<AuraEffect*>> AuraEffectList;
         typedef std::map<uint32, AuraEffectList*> AuraEffectListMap;
-        typedef std::list<Aura*> AuraList;
-        typedef std::map<uint32, AuraList> AuraMyMap;
+        typedef std::list<Aura*, Trinity::NodeCacheAllocator<Aura*>> AuraList;
+        typedef std::map<uint32, AuraList, std::less<uint32>, Trinity::NodeCacheAllocator<std::pair<uint32 const, AuraList>>> AuraMyMap;
         typedef std::list<AuraApplicationPtr> AuraApplicationList;
         typedef std::list<DiminishingReturn> Diminishing;
 
@@ -1122,6 +1124,9 @@ class TC_GAME_API Unit : public WorldObject
         void SetDisabledCurrentAI() { i_disabledAI = i_AI; i_AI = nullptr; }
 
         void BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, Player* target) const override;
+        bool CanShareValuesUpdate() const override;
+        bool GetValuesUpdateClass(Player const* target, uint32& updateClass) const override;
+        uint32 GetValuesUpdateVisibleFlag(Player const* target) const;
 
         void AddToWorld() override;
         void RemoveFromWorld() override;
@@ -1676,6 +1681,7 @@ class TC_GAME_API Unit : public WorldObject
         void _UnapplyAura(AuraApplication * aurApp, AuraRemoveMode removeMode);
         void _RemoveNoStackAurasDueToAura(Aura* aura);
         void _RegisterAuraEffect(AuraEffect* aurEff, bool apply);
+        void InvalidateAuraModifierTotals(AuraType auratype);
 
         // m_ownedAuras container management
         AuraMap      & GetOwnedAuras()       { return m_ownedAuras; }
@@ -1964,9 +1970,10 @@ class TC_GAME_API Unit : public WorldObject
         // Event handler
         EventProcessor m_Events;
 
-        void AddDelayedEvent(uint64 timeOffset, std::function<void()>&& function)
+        template <typename F>
+        void AddDelayedEvent(uint64 timeOffset, F&& function)
         {
-            m_Functions.AddDelayedEvent(timeOffset, std::move(function));
+            m_Functions.AddDelayedEvent(timeOffset, std::forward<F>(function));
         }
 
         void KillAllDelayedEvents()
@@ -1974,9 +1981,10 @@ class TC_GAME_API Unit : public WorldObject
             m_Functions.KillAllFunctions();
         }
 
-        void AddDelayedCombat(uint64 timeOffset, std::function<void()>&& function)
+        template <typename F>
+        void AddDelayedCombat(uint64 timeOffset, F&& function)
         {
-            m_CombatFunctions.AddDelayedEvent(timeOffset, std::move(function));
+            m_CombatFunctions.AddDelayedEvent(timeOffset, std::forward<F>(function));
         }
 
         void KillAllDelayedCombats()
@@ -2526,13 +2534,43 @@ class TC_GAME_API Unit : public WorldObject
 
         AuraMap m_ownedAuras;
         AuraApplicationMap m_appliedAuras;
-        AuraApplicationMap m_procAuras;
+        // counting filter over the spell ids in m_appliedAuras, lets the common "not applied" lookup skip the tree walk
+        static uint32 const APPLIED_AURA_FILTER_SIZE = 128;
+        std::array<uint8, APPLIED_AURA_FILTER_SIZE> m_appliedAuraFilter;
+        uint8& GetAppliedAuraFilterSlot(uint32 spellId) { return m_appliedAuraFilter[(spellId * 2654435761u) >> 25]; }
+        bool MayHaveAppliedAura(uint32 spellId) const { return m_appliedAuraFilter[(spellId * 2654435761u) >> 25] != 0; }
+
+        // proc capable applications bucketed by the proc flag bits they can react to,
+        // a proc event only collects the buckets of its own flags
+        typedef std::vector<AuraApplicationPtr> ProcAuraBucket;
+        std::array<ProcAuraBucket, 32> m_procAuraBuckets;
+        uint32 m_procAuraSequence;
+        uint32 m_procAuraVisit;
+        uint8 m_procAuraSpawnMode;                          // spawn mode the proc masks were computed for
+        uint32 GetProcAuraMask(SpellInfo const* spellInfo) const;
+        void RegisterProcAura(AuraApplicationPtr const& aurApp);
+        void UnregisterProcAura(AuraApplication* aurApp);
+        void RebuildProcAuraIndex();
         AuraList m_removedAuras;
         AuraMap::iterator m_auraUpdateIterator;
         uint32 m_removedAurasCount;
 
         AuraEffectList m_modAuras[TOTAL_AURAS];
         AuraEffectListMap m_modMapAuras;
+
+        // unpredicated totals of one m_modAuras list, dropped whenever an effect of the type is registered, removed or changes amount
+        struct AuraModifierTotals
+        {
+            int32 total;
+            int32 raidTotal;                                  // consolidated raid buffs only count the strongest one
+            float multiplier;
+            int32 maxPositive;
+            int32 maxNegative;
+        };
+
+        AuraModifierTotals GetAuraModifierTotals(AuraType auratype) const;
+        mutable std::unordered_map<uint32, AuraModifierTotals> m_modAuraTotals;
+        mutable std::mutex m_modAuraTotalsLock;
         AuraList m_scAuras;                        // casted singlecast auras
         AuraList m_gbAuras;                        // casted singlecast auras
         AuraApplicationList m_interruptableAuras;             // auras which have interrupt mask applied on unit
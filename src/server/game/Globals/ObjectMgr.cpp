@@ -42,6 +42,7 @@
 #include "Spell.h"
 #include "SpellMgr.h"
 #include "SpellScript.h"
+#include "StartupSnapshot.h"
 #include "StringConvert.h"
 #include "Util.h"
 #include "Vehicle.h"
@@ -2001,10 +2002,29 @@ std::vector<TempSummonData> const* ObjectMgr::GetSummonGroup(uint32 summonerId,
     return Trinity::Containers::MapGetValuePtr(_tempSummonDataStore, TempSummonGroupKey(summonerId, summonerType, group));
 }
 
+// bump when CreatureData or the snapshot record below changes
+uint32 const CREATURE_SNAPSHOT_VERSION = 1;
+
 void ObjectMgr::LoadCreatures()
 {
     uint32 oldMSTime = getMSTime();
 
+    StartupSnapshot::Key snapshotKey(CREATURE_SNAPSHOT_VERSION);
+    bool snapshot = StartupSnapshot::IsEnabled();
+    if (snapshot)
+    {
+        // everything the checks below read, the spawns are kept after validation
+        snapshotKey.AddWorldVersion()
+            .AddWorldTables({ "creature", "game_event_creature", "pool_creature", "creature_template", "creature_equip_template" })
+            .AddStore(sMapStore).AddStore(sMapDifficultyStore).AddStore(sPhaseStore);
+
+        if (LoadCreaturesFromSnapshot(snapshotKey))
+        {
+            TC_LOG_INFO("server.loading", ">> Loaded " SZFMTD " creatures from startup snapshot in %u ms", _creatureDataStore.size(), GetMSTimeDiffToNow(oldMSTime));
+            return;
+        }
+    }
+
     //                                                      0            1      2      3        4           5           6           7           8            9            10            11
     QueryResult result = WorldDatabase.Query("SELECT creature.guid, id, map, zoneId, areaId, modelid, equipment_id, position_x, position_y, position_z, orientation, spawntimesecs, spawndist, "
     //        12            13         14          15           16        17         18          19             20                21                   22                    23                    24
@@ -2203,9 +2223,138 @@ void ObjectMgr::LoadCreatures()
         ++count;
 
     } while (result->NextRow());
+
+    if (snapshot)
+        SaveCreaturesSnapshot(snapshotKey);
+
     TC_LOG_INFO("server.loading", ">> Loaded %u creatures in %u ms", count, GetMSTimeDiffToNow(oldMSTime));
 }
 
+bool ObjectMgr::LoadCreaturesFromSnapshot(StartupSnapshot::Key const& key)
+{
+    StartupSnapshot::Reader reader;
+    if (!reader.Open("creature", key))
+        return false;
+
+    uint32 count = reader.Get<uint32>();
+    _creatureDataStore.rehash(count);
+
+    for (uint32 i = 0; i < count && !reader.HasFailed(); ++i)
+    {
+        ObjectGuid::LowType guid = reader.Get<uint64>();
+
+        CreatureData& data = _creatureDataStore[guid];
+        data.guid           = guid;
+        data.id             = reader.Get<uint32>();
+        data.mapid          = reader.Get<uint16>();
+        data.zoneId         = reader.Get<uint16>();
+        data.areaId         = reader.Get<uint16>();
+        data.phaseMask      = reader.Get<uint32>();
+        data.displayid      = reader.Get<uint32>();
+        data.equipmentId    = reader.Get<int8>();
+        data.posX           = reader.Get<float>();
+        data.posY           = reader.Get<float>();
+        data.posZ           = reader.Get<float>();
+        data.orientation    = reader.Get<float>();
+        data.spawntimesecs  = reader.Get<uint32>();
+        data.spawndist      = reader.Get<float>();
+        data.currentwaypoint= reader.Get<uint32>();
+        data.curhealth      = reader.Get<uint64>();
+        data.curmana        = reader.Get<uint32>();
+        data.movementType   = reader.Get<uint8>();
+        data.spawnMask      = reader.Get<uint64>();
+        data.npcflag        = reader.Get<uint32>();
+        data.npcflag2       = reader.Get<uint32>();
+        data.unit_flags     = reader.Get<uint32>();
+        data.unit_flags3    = reader.Get<uint32>();
+        data.dynamicflags   = reader.Get<uint32>();
+        data.isActive       = reader.Get<bool>();
+        data.personalSize   = reader.Get<float>();
+        data.isTeemingSpawn = reader.Get<bool>();
+
+        for (uint32 phases = reader.Get<uint32>(); phases && !reader.HasFailed(); --phases)
+            data.PhaseID.insert(reader.Get<uint32>());
+
+        data.AiID           = reader.Get<uint32>();
+        data.MovementID     = reader.Get<uint32>();
+        data.MeleeID        = reader.Get<uint32>();
+        data.skipClone      = reader.Get<bool>();
+        data.gameEvent      = reader.Get<int16>();
+        data.pool           = reader.Get<uint32>();
+
+        // spawns on maps missing from the DBC stay in the store but are never added, as in LoadCreatures
+        if (!sMapStore.LookupEntry(data.mapid))
+            continue;
+
+        if (data.gameEvent == 0 && data.pool == 0)
+            AddCreatureToGrid(guid, &data);
+    }
+
+    if (!reader.IsComplete())
+    {
+        TC_LOG_ERROR("server.loading", "StartupSnapshot: creature snapshot does not match its record layout, loading from the database");
+
+        for (auto const& itr : _creatureDataStore)
+            if (itr.second.gameEvent == 0 && itr.second.pool == 0 && sMapStore.LookupEntry(itr.second.mapid))
+                RemoveCreatureFromGrid(itr.first, &itr.second);
+        _creatureDataStore.clear();
+        return false;
+    }
+
+    return true;
+}
+
+void ObjectMgr::SaveCreaturesSnapshot(StartupSnapshot::Key const& key) const
+{
+    StartupSnapshot::Writer writer;
+    writer.Put(uint32(_creatureDataStore.size()));
+
+    for (auto const& itr : _creatureDataStore)
+    {
+        CreatureData const& data = itr.second;
+        writer.Put(uint64(data.guid));
+        writer.Put(data.id);
+        writer.Put(data.mapid);
+        writer.Put(data.zoneId);
+        writer.Put(data.areaId);
+        writer.Put(data.phaseMask);
+        writer.Put(data.displayid);
+        writer.Put(data.equipmentId);
+        writer.Put(data.posX);
+        writer.Put(data.posY);
+        writer.Put(data.posZ);
+        writer.Put(data.orientation);
+        writer.Put(data.spawntimesecs);
+        writer.Put(data.spawndist);
+        writer.Put(data.currentwaypoint);
+        writer.Put(data.curhealth);
+        writer.Put(data.curmana);
+        writer.Put(data.movementType);
+        writer.Put(data.spawnMask);
+        writer.Put(data.npcflag);
+        writer.Put(data.npcflag2);
+        writer.Put(data.unit_flags);
+        writer.Put(data.unit_flags3);
+        writer.Put(data.dynamicflags);
+        writer.Put(data.isActive);
+        writer.Put(data.personalSize);
+        writer.Put(data.isTeemingSpawn);
+
+        writer.Put(uint32(data.PhaseID.size()));
+        for (uint32 phaseId : data.PhaseID)
+            writer.Put(phaseId);
+
+        writer.Put(data.AiID);
+        writer.Put(data.MovementID);
+        writer.Put(data.MeleeID);
+        writer.Put(data.skipClone);
+        writer.Put(data.gameEvent);
+        writer.Put(data.pool);
+    }
+
+    writer.Save("creature", key);
+}
+
 void ObjectMgr::LoadCreatureAIInstance()
 {
     uint32 oldMSTime = getMSTime();
@@ -41,6 +41,11 @@
 class Item;
 class PhaseMgr;
 
+namespace StartupSnapshot
+{
+    class Key;
+}
+
 struct EventObjectData;
 
 #pragma pack(push, 1)
@@ -906,6 +911,9 @@ class TC_GAME_API ObjectMgr
         uint32 GetCreatureDisplay(int32 modelid) const;
 
     private:
+        bool LoadCreaturesFromSnapshot(StartupSnapshot::Key const& key);
+        void SaveCreaturesSnapshot(StartupSnapshot::Key const& key) const;
+
         // first free id for selected id type
         uint32 _auctionId;
         uint64 _equipmentSetGuid;
@@ -0,0 +1,246 @@
+/*
+ * Copyright (C) 2008-2017 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "StartupSnapshot.h"
+#include "Config.h"
+#include "DatabaseEnv.h"
+#include "DB2Store.h"
+#include "Log.h"
+#include "Timer.h"
+#include "World.h"
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <cstdio>
+
+namespace
+{
+    uint32 const SNAPSHOT_MAGIC = 0x53534354;              // "TCSS"
+
+    struct SnapshotHeader
+    {
+        uint32 magic;
+        uint32 formatVersion;
+        uint64 key;
+        uint64 payloadSize;
+        uint64 checksum;
+    };
+
+    uint64 const FNV_OFFSET = UI64LIT(14695981039346656037);
+    uint64 const FNV_PRIME = UI64LIT(1099511628211);
+
+    uint64 Fnv1a(uint64 hash, void const* data, std::size_t size)
+    {
+        uint8 const* bytes = static_cast<uint8 const*>(data);
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            hash ^= bytes[i];
+            hash *= FNV_PRIME;
+        }
+        return hash;
+    }
+
+    std::string GetFileName(char const* name)
+    {
+        std::string dir = sConfigMgr->GetStringDefault("StartupSnapshot.Dir", "./cache/");
+        if (!dir.empty() && dir.back() != '/' && dir.back() != '\\')
+            dir.push_back('/');
+        return dir + name + ".snap";
+    }
+}
+
+bool StartupSnapshot::IsEnabled()
+{
+    return sWorld->getBoolConfig(CONFIG_STARTUP_SNAPSHOT);
+}
+
+StartupSnapshot::Key::Key(uint32 formatVersion) : _formatVersion(formatVersion), _value(FNV_OFFSET)
+{
+    Add(uint64(formatVersion));
+}
+
+StartupSnapshot::Key& StartupSnapshot::Key::Add(std::string const& value)
+{
+    _value = Fnv1a(_value, value.c_str(), value.size() + 1);
+    return *this;
+}
+
+StartupSnapshot::Key& StartupSnapshot::Key::Add(uint64 value)
+{
+    _value = Fnv1a(_value, &value, sizeof(value));
+    return *this;
+}
+
+StartupSnapshot::Key& StartupSnapshot::Key::AddWorldVersion()
+{
+    Add(std::string(sWorld->GetDBVersion()));
+    return Add(uint64(sWorld->getIntConfig(CONFIG_CLIENTCACHE_VERSION)));
+}
+
+StartupSnapshot::Key& StartupSnapshot::Key::AddWorldTables(std::vector<char const*> const& tables)
+{
+    std::string list;
+    for (char const* table : tables)
+    {
+        if (!list.empty())
+            list += ", ";
+        list += table;
+    }
+
+    uint32 oldMSTime = getMSTime();
+
+    // a full scan of every table, but the only signal that also sees edits made outside the sql
+    // updater (.npc add, manual edits); a missing table has a NULL checksum, which still changes the key
+    if (QueryResult result = WorldDatabase.PQuery("CHECKSUM TABLE %s", list.c_str()))
+    {
+        do
+        {
+            Field* fields = result->Fetch();
+            Add(fields[0].GetString());
+            Add(fields[1].IsNull() ? UI64LIT(0xFFFFFFFFFFFFFFFF) : fields[1].GetUInt64());
+        } while (result->NextRow());
+    }
+    else
+        Add(std::string("no checksum"));
+
+    TC_LOG_INFO("server.loading", "StartupSnapshot: checksummed %s in %u ms", list.c_str(), GetMSTimeDiffToNow(oldMSTime));
+    return *this;
+}
+
+StartupSnapshot::Key& StartupSnapshot::Key::AddStore(DB2StorageBase const& store)
+{
+    Add(uint64(store.GetTableHash()) << 32 | store.GetLayoutHash());
+    return Add(uint64(store.GetNumRows()));
+}
+
+void StartupSnapshot::Writer::PutString(std::string const& value)
+{
+    Put(uint32(value.size()));
+    _payload.insert(_payload.end(), value.begin(), value.end());
+}
+
+bool StartupSnapshot::Writer::Save(char const* name, Key const& key) const
+{
+    std::string fileName = GetFileName(name);
+    std::string tempName = fileName + ".tmp";
+
+    boost::system::error_code error;
+    boost::filesystem::create_directories(boost::filesystem::path(fileName).parent_path(), error);
+
+    FILE* file = fopen(tempName.c_str(), "wb");
+    if (!file)
+    {
+        TC_LOG_ERROR("server.loading", "StartupSnapshot: can't create %s", tempName.c_str());
+        return false;
+    }
+
+    SnapshotHeader header;
+    header.magic = SNAPSHOT_MAGIC;
+    header.formatVersion = key.GetFormatVersion();
+    header.key = key.GetValue();
+    header.payloadSize = _payload.size();
+    header.checksum = Fnv1a(FNV_OFFSET, _payload.data(), _payload.size());
+
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1 && (_payload.empty() || fwrite(_payload.data(), _payload.size(), 1, file) == 1);
+    written = fclose(file) == 0 && written;
+
+    if (written)
+    {
+        // rename() does not replace an existing file everywhere
+        std::remove(fileName.c_str());
+        written = std::rename(tempName.c_str(), fileName.c_str()) == 0;
+    }
+
+    if (!written)
+    {
+        std::remove(tempName.c_str());
+        TC_LOG_ERROR("server.loading", "StartupSnapshot: can't write %s", fileName.c_str());
+        return false;
+    }
+
+    TC_LOG_INFO("server.loading", "StartupSnapshot: saved %s (" UI64FMTD " bytes)", fileName.c_str(), uint64(_payload.size()));
+    return true;
+}
+
+StartupSnapshot::Reader::Reader() : _data(nullptr), _size(0), _pos(0), _failed(false)
+{
+}
+
+StartupSnapshot::Reader::~Reader() = default;
+
+bool StartupSnapshot::Reader::Open(char const* name, Key const& key)
+{
+    std::string fileName = GetFileName(name);
+
+    boost::system::error_code error;
+    uint64 fileSize = boost::filesystem::file_size(fileName, error);
+    if (error || fileSize < sizeof(SnapshotHeader))
+        return false;
+
+    try
+    {
+        boost::interprocess::file_mapping mapping(fileName.c_str(), boost::interprocess::read_only);
+        _region.reset(new boost::interprocess::mapped_region(mapping, boost::interprocess::read_only));
+    }
+    catch (boost::interprocess::interprocess_exception const& e)
+    {
+        TC_LOG_ERROR("server.loading", "StartupSnapshot: can't map %s: %s", fileName.c_str(), e.what());
+        return false;
+    }
+
+    uint8 const* base = static_cast<uint8 const*>(_region->get_address());
+    std::size_t mappedSize = _region->get_size();
+
+    SnapshotHeader header;
+    memcpy(&header, base, sizeof(header));
+
+    if (header.magic != SNAPSHOT_MAGIC || header.formatVersion != key.GetFormatVersion() || header.key != key.GetValue())
+    {
+        TC_LOG_INFO("server.loading", "StartupSnapshot: %s is stale, rebuilding it", fileName.c_str());
+        _region.reset();
+        return false;
+    }
+
+    if (header.payloadSize != mappedSize - sizeof(header) || header.checksum != Fnv1a(FNV_OFFSET, base + sizeof(header), std::size_t(header.payloadSize)))
+    {
+        TC_LOG_ERROR("server.loading", "StartupSnapshot: %s is damaged, rebuilding it", fileName.c_str());
+        _region.reset();
+        return false;
+    }
+
+    _data = base + sizeof(header);
+    _size = std::size_t(header.payloadSize);
+    _pos = 0;
+    _failed = false;
+    return true;
+}
+
+std::string StartupSnapshot::Reader::GetString()
+{
+    uint32 length = Get<uint32>();
+    if (length > _size - _pos)
+    {
+        _failed = true;
+        _pos = _size;
+        return std::string();
+    }
+
+    std::string value(reinterpret_cast<char const*>(_data + _pos), length);
+    _pos += length;
+    return value;
+}
@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2008-2017 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRINITY_STARTUP_SNAPSHOT_H
+#define TRINITY_STARTUP_SNAPSHOT_H
+
+#include "Define.h"
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+class DB2StorageBase;
+
+namespace boost { namespace interprocess { class mapped_region; } }
+
+/*
+ * Opt-in (StartupSnapshot.Enable) on-disk copy of data built at startup.
+ *
+ * A snapshot file is a fixed header (magic, format version, source key,
+ * payload size, payload checksum) followed by the payload a loader wrote.
+ * The key identifies the sources the data was built from: the loader mixes in
+ * the world database version, server side table checksums and the db2 store
+ * hashes it depends on, so any change there makes the old file unusable and it
+ * is rebuilt from the database at that boot. Files are memory mapped for reading.
+ */
+namespace StartupSnapshot
+{
+    TC_GAME_API bool IsEnabled();
+
+    /// Builds the source key of a snapshot
+    class TC_GAME_API Key
+    {
+    public:
+        explicit Key(uint32 formatVersion);
+
+        Key& Add(std::string const& value);
+        Key& Add(uint64 value);
+        /// Adds the database version of the world database
+        Key& AddWorldVersion();
+        /// Adds the MySQL CHECKSUM TABLE result of every listed world table, this reads every row of them
+        Key& AddWorldTables(std::vector<char const*> const& tables);
+        Key& AddStore(DB2StorageBase const& store);
+
+        uint32 GetFormatVersion() const { return _formatVersion; }
+        uint64 GetValue() const { return _value; }
+
+    private:
+        uint32 _formatVersion;
+        uint64 _value;
+    };
+
+    class TC_GAME_API Writer
+    {
+    public:
+        template<class T>
+        void Put(T value)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "snapshot values must be trivially copyable");
+            std::size_t pos = _payload.size();
+            _payload.resize(pos + sizeof(T));
+            memcpy(&_payload[pos], &value, sizeof(T));
+        }
+
+        void PutString(std::string const& value);
+
+        /// Writes to a temporary file and renames it over the old snapshot
+        bool Save(char const* name, Key const& key) const;
+
+    private:
+        std::vector<uint8> _payload;
+    };
+
+    class TC_GAME_API Reader
+    {
+    public:
+        Reader();
+        ~Reader();
+
+        /// False if there is no snapshot or it does not belong to this key (stale, damaged, other format)
+        bool Open(char const* name, Key const& key);
+
+        template<class T>
+        T Get()
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "snapshot values must be trivially copyable");
+            T value = T();
+            if (sizeof(T) > _size - _pos)
+            {
+                _failed = true;
+                _pos = _size;
+                return value;
+            }
+
+            memcpy(&value, _data + _pos, sizeof(T));
+            _pos += sizeof(T);
+            return value;
+        }
+
+        std::string GetString();
+
+        bool HasFailed() const { return _failed; }
+        /// Whole payload consumed without running past its end
+        bool IsComplete() const { return !_failed && _pos == _size; }
+
+    private:
+        std::unique_ptr<boost::interprocess::mapped_region> _region;
+        uint8 const* _data;
+        std::size_t _size;
+        std::size_t _pos;
+        bool _failed;
+    };
+}
+
+#endif
@@ -382,7 +382,10 @@ void MessageDistDeliverer::SendPacket(Player* player)
     if (i_message->GetOpcode() == SMSG_CHAT && player->GetSocial()->HasIgnore(i_source->GetGUID()))
         return;
 
-    player->SendDirectMessage(i_message);
+    if (!i_shared)
+        i_shared = SharedWorldPacket(*i_message);
+
+    player->SendDirectMessage(i_shared);
 }
 
 UnfriendlyMessageDistDeliverer::UnfriendlyMessageDistDeliverer(Unit const* src, WorldPacket* msg, float dist) : i_source(src), i_message(msg), i_phaseMask(src->GetPhaseMask()), i_distSq(dist * dist)
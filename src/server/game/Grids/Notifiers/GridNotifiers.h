@@ -29,6 +29,7 @@
 #include "Player.h"
 #include "SocialMgr.h"
 #include "Spell.h"
+#include "SharedWorldPacket.h"
 #include "UpdateData.h"
 
 namespace Trinity
@@ -93,6 +94,7 @@ namespace Trinity
         uint32 team;
         Player const* skipped_receiver;
         GuidUnorderedSet m_IgnoredGUIDs;
+        SharedWorldPacket i_shared;     // copied on first receiver, every receiver queues the same packet
         MessageDistDeliverer(WorldObject* src, WorldPacket const* msg, float dist, bool own_team_only = false, Player const* skipped = nullptr, GuidUnorderedSet ignoredSet = GuidUnorderedSet());
 
         void Visit(PlayerMapType &m);
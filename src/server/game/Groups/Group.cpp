@@ -20,6 +20,7 @@
 #include "Opcodes.h"
 #include "WorldPacket.h"
 #include "WorldSession.h"
+#include "SharedWorldPacket.h"
 #include "Player.h"
 #include "World.h"
 #include "ObjectMgr.h"
@@ -1861,6 +1862,7 @@ void Group::BroadcastAddonMessagePacket(WorldPacket const* packet, std::string c
 
 void Group::BroadcastPacket(const WorldPacket* packet, bool ignorePlayersInBGRaid, int group, ObjectGuid ignore)
 {
+    SharedWorldPacket shared(*packet);
     for (GroupReference* itr = GetFirstMember(); itr != nullptr; itr = itr->next())
     {
         Player* player = itr->getSource();
@@ -1868,7 +1870,7 @@ void Group::BroadcastPacket(const WorldPacket* packet, bool ignorePlayersInBGRai
             continue;
 
         if (group == -1 || itr->getSubGroup() == group)
-            player->SendDirectMessage(packet);
+            player->SendDirectMessage(shared);
     }
 }
 
@@ -441,9 +441,10 @@ class TC_GAME_API Group
         uint32 m_challengeInstanceID;
         std::array<uint32, 3> m_affixes{};
 
-        void AddDelayedEvent(uint64 timeOffset, std::function<void()>&& function)
+        template <typename F>
+        void AddDelayedEvent(uint64 timeOffset, F&& function)
         {
-            m_Functions.AddDelayedEvent(timeOffset, std::move(function));
+            m_Functions.AddDelayedEvent(timeOffset, std::forward<F>(function));
         }
 
         lfg::LFGDungeonData const* m_dungeon;
@@ -48,9 +48,10 @@ public:
     void   AddGroup(Group* group);
     void   RemoveGroup(Group* group);
 
-    void AddDelayedEvent(uint64 timeOffset, std::function<void()>&& function)
+    template <typename F>
+    void AddDelayedEvent(uint64 timeOffset, F&& function)
     {
-        m_Functions.AddDelayedEvent(timeOffset, std::move(function));
+        m_Functions.AddDelayedEvent(timeOffset, std::forward<F>(function));
     }
 
 protected:
@@ -721,7 +721,7 @@ void WorldSession::HandlePetBattleRequestPVP(WorldPackets::BattlePet::RequestPVP
 
     for (auto const& teamPosition : battleRequest->TeamPosition)
     {
-        if (_player->GetMap()->getObjectHitPos(_player->GetPhases(), true, battleRequest->PetBattleCenterPosition, teamPosition, 0.0f))
+        if (_player->GetMap()->getObjectHitPos(_player->GetPhaseSet(), true, battleRequest->PetBattleCenterPosition, teamPosition, 0.0f))
         {
             SendPetBattleRequestFailed(PETBATTLE_REQUEST_NOT_HERE_UNEVEN_GROUND);
             sPetBattleSystem->RemoveRequest(battleRequest->RequesterGuid);
@@ -25,6 +25,7 @@
 #include "CalendarPackets.h"
 #include "CharacterData.h"
 #include "CharacterPackets.h"
+#include "CharacterSaveScheduler.h"
 #include "Chat.h"
 #include "ClientConfigPackets.h"
 #include "DatabaseEnv.h"
@@ -150,7 +151,7 @@ void WorldSession::SendCharacterEnum(bool deleted /*= false*/)
 
     stmt->setUInt32(0, GetAccountId());
 
-    _queryProcessor.AddCallback(CharacterDatabase.AsyncQuery(stmt).WithPreparedCallback(std::bind(&WorldSession::HandleCharEnum, this, std::placeholders::_1, deleted)));
+    _queryProcessor.AddCallback(CharacterDatabase.AsyncQuery(stmt, DATABASE_LANE_LOGIN).WithPreparedCallback(std::bind(&WorldSession::HandleCharEnum, this, std::placeholders::_1, deleted)));
 }
 
 void WorldSession::HandleCharCreateOpcode(WorldPackets::Character::CreateChar& charCreate)
@@ -1994,6 +1995,14 @@ void WorldSession::HandleContinuePlayerLogin()
         return;
     }
 
+    // saves and logins run on separate database lanes, a login query could read the character
+    // before its logout save committed. ProcessQueryCallbacks continues the login after the save
+    if (sCharacterSaveScheduler->IsSaveInFlight(m_playerLoading.GetCounter()))
+    {
+        m_playerLoadingWaitsForSave = true;
+        return;
+    }
+
     std::shared_ptr<LoginQueryHolder> holder = std::make_shared<LoginQueryHolder>(GetAccountId(), m_playerLoading);
     if (!holder->Initialize())
     {
@@ -2005,7 +2014,7 @@ void WorldSession::HandleContinuePlayerLogin()
 
     SendPacket(WorldPackets::Auth::ResumeComms(CONNECTION_TYPE_INSTANCE).Write());
 
-    AddQueryHolderCallback(CharacterDatabase.DelayQueryHolder(holder)).AfterComplete([this](SQLQueryHolderBase const& holder)
+    AddQueryHolderCallback(CharacterDatabase.DelayQueryHolder(holder, DATABASE_LANE_LOGIN)).AfterComplete([this](SQLQueryHolderBase const& holder)
     {
         HandlePlayerLogin(dynamic_cast<LoginQueryHolder const&>(holder));
     });
@@ -34,6 +34,7 @@
 #include "MapDefines.h"
 #include "MapInstanced.h"
 #include "MapManager.h"
+#include "MapUpdateScheduler.h"
 #include "MiscPackets.h"
 #include "MMapFactory.h"
 #include "ObjectAccessor.h"
@@ -42,6 +43,7 @@
 #include "OutdoorPvPMgr.h"
 #include "ScenarioMgr.h"
 #include "ScriptMgr.h"
+#include "SharedWorldPacket.h"
 #include "StringFormat.h"
 #include "Totem.h"
 #include "Transport.h"
@@ -56,6 +58,7 @@ namespace {
 
 #define DEFAULT_GRID_EXPIRY     300
 #define MAX_GRID_LOAD_TIME      50
+#define MAP_IDLE_TICK_INTERVAL  1000                // ms between ticks of empty world maps that cannot park yet
 #define MAX_CREATURE_ATTACK_RADIUS  (45.0f * sWorld->getRate(RATE_CREATURE_AGGRO))
 
 typedef void (*GridStateUpdate)(Map &, Map::GridContainerType::iterator, uint32);
@@ -173,18 +176,131 @@ void Map::VisitNearbyCellsOf(WorldObject* obj)
             Visit(cell, gridVisitor);
             Visit(cell, worldVisitor);
 
-            uint32 pullY = y / sWorld->getIntConfig(CONFIG_SIZE_CELL_FOR_PULL); // Max y = MAX_NUMBER_OF_GRIDS - 1
-            uint32 pullX = x / sWorld->getIntConfig(CONFIG_SIZE_CELL_FOR_PULL); // Max x = MAX_NUMBER_OF_GRIDS - 1
-            // count of pull is TOTAL_NUMBER_OF_CELLS_PER_MAP / CONFIG_SIZE_CELL_FOR_PULL
-            uint32 pullId = (pullY * (TOTAL_NUMBER_OF_CELLS_PER_MAP / sWorld->getIntConfig(CONFIG_SIZE_CELL_FOR_PULL))) + pullX;
-            std::vector<WorldObject*>& collectObjects = i_objectUpdater[pullY % 2][(pullY + pullX) % 2][pullId];
+            if (objectUpdater.i_collectObjects.empty())
+                continue;
+
+            std::vector<WorldObject*>& collectObjects = i_updatePartition.GetTileObjects(x, y);
             for (auto& obj : objectUpdater.i_collectObjects)
-                if (i_objectTest.find(obj) == i_objectTest.end())
+            {
+                if (obj->m_updateCollectGeneration == i_collectGeneration)
+                    continue;
+
+                obj->m_updateCollectGeneration = i_collectGeneration;
+                collectObjects.push_back(obj);
+            }
+            objectUpdater.i_collectObjects.clear();
+        }
+    }
+}
+
+uint32 Map::UpdateCollectedTiles(uint32 diff)
+{
+    uint32 collectedCount = 0;
+    uint32 workers = threadPool ? std::max<uint32>(1, sMapTaskExecutor->GetWorkerCount()) : 1;
+
+    // colors run one after another, tiles of one color are never neighbours
+    for (uint32 color = 0; color < i_updatePartition.GetColorCount(); ++color)
+    {
+        i_updatePartition.BuildBatches(color, workers, i_updateBatches);
+
+        for (MapUpdatePartition::Batch& batch : i_updateBatches)
+        {
+            if (batch.empty())
+                continue;
+
+            for (MapUpdatePartition::Tile* tile : batch)
+                collectedCount += tile->Objects.size();
+
+            MapUpdatePartition::Batch* tiles = &batch;
+            auto updateTiles = [tiles, diff, this]()
+            {
+                for (MapUpdatePartition::Tile* tile : *tiles)
                 {
-                    i_objectTest.insert(obj);
-                    collectObjects.push_back(obj);
+                    TimePoint start = std::chrono::steady_clock::now();
+                    updateCollected(tile->Objects, diff, GetId(), GetInstanceId());
+                    tile->Cost = uint32(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
                 }
-            objectUpdater.i_collectObjects.clear();
+            };
+
+            if (threadPool)
+                threadPool->schedule(updateTiles);
+            else
+                updateTiles();
+        }
+
+        if (threadPool)
+            threadPool->wait();
+    }
+
+    if (i_updatePartition.EndTick(workers))
+    {
+        MapUpdatePartition::Stats const& stats = i_updatePartition.GetStats();
+        TC_LOG_DEBUG("maps", "Map::UpdateCollectedTiles: map %u instance %u split level %u -> %u (tile %u cells, %u colors, %u tiles), hot tile %u %uus, total %uus, critical path %uus",
+            GetId(), GetInstanceId(), stats.SplitLevel, i_updatePartition.GetPendingSplitLevel(), stats.TileSize, stats.ColorCount, stats.TileCount,
+            stats.HotTileId, stats.HotTileCost, stats.TotalCost, stats.CriticalPathCost);
+    }
+
+    return collectedCount;
+}
+
+void Map::UpdatePlayers(uint32 diff)
+{
+    // update worldsessions for existing players
+    for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
+    {
+        if (b_isMapUnload)
+            return;
+
+        if (Player* player = m_mapRefIter->getSource())
+        {
+            if (player->IsDelete() || player->IsPreDelete()) // If object in delete list or ported don`t update it
+                continue;
+
+            WorldSession* session = player->GetSession();
+            m_currentSession = session;
+            if (!session || session->PlayerLoading() || session->PlayerLogout()) // Prevent update if player not in map fulling
+                continue;
+
+            if (player->IsChangeMap() || player->GetMap() != this || session->GetMap() != this)
+                continue;
+
+            try
+            {
+                // Can be not in world after WorldSession::Update
+                if (player->IsInWorld())
+                {
+                    if (MapTickProfiler::IsEnabled())
+                    {
+                        auto start = std::chrono::steady_clock::now();
+                        player->Update(diff);
+                        i_tickProfiler.RecordObject(player, uint32(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count()));
+                    }
+                    else
+                        player->Update(diff);
+
+                    VisitNearbyCellsOf(player);
+                }
+                if (player->IsRemoveFromMap())
+                {
+                    RemovePlayerFromMap(player, false);
+                    player->SetRemoveFromMap(false);
+                    session->SetCanLogout();
+                }
+            }
+            catch (std::exception& e)
+            {
+                sLog->outTryCatch("Exception caught Player in Map::Update %s _mapId %u InstanceId %u", e.what(), GetId(), GetInstanceId());
+
+                if (m_currentSession)
+                    m_currentSession->KickPlayer();
+            }
+            catch (...)
+            {
+                sLog->outTryCatch("Exception caught Player in Map::Update _mapId %u InstanceId %u", GetId(), GetInstanceId());
+
+                if (m_currentSession)
+                    m_currentSession->KickPlayer();
+            }
         }
     }
 }
@@ -194,6 +310,8 @@ void Map::updateCollected(std::vector<WorldObject*>& objectsToUpdate, uint32 dif
     if (b_isMapUnload)
         return;
 
+    bool profile = MapTickProfiler::IsEnabled();
+
     if (!objectsToUpdate.empty())
     {
         for (auto& object : objectsToUpdate)
@@ -205,18 +323,15 @@ void Map::updateCollected(std::vector<WorldObject*>& objectsToUpdate, uint32 dif
                     if (b_isMapUnload)
                         return;
 
-                    uint32 _s = getMSTime();
-                    object->Update(diff);
-                    uint32 _ms = GetMSTimeDiffToNow(_s);
-                    if (_ms > 200)
+                    if (!profile)
                     {
-                        sLog->outDiff("ObjectUpdater::updateCollected: type - %u, e:%u(g:%u). time - %ums diff %u isActiveObject %u visible %f mapId %u i_InstanceId %u",
-                            object->GetTypeId(), object->GetEntry(), object->GetGUIDLow(), _ms, diff, object->isActiveObject(), object->GetVisibilityRange(), object->GetMapId(), i_InstanceId);
-
-                        if (Unit* unit = object->ToUnit())
-                            sLog->outDiff("ObjectUpdater::updateCollected: e:%u(g:%u) castCount %u targetCount %u eventCount %u functionCount %u",
-                                unit->GetEntry(), unit->GetGUIDLow(), unit->_castCount, unit->_targetCount, unit->_eventCount, unit->_functionCount);
+                        object->Update(diff);
+                        continue;
                     }
+
+                    auto start = std::chrono::steady_clock::now();
+                    object->Update(diff);
+                    i_tickProfiler.RecordObject(object, uint32(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count()));
                 }
             }
             catch (std::exception& e)
@@ -275,11 +390,8 @@ Map::~Map()
     if (!m_scriptSchedule.empty())
         sMapMgr->DecreaseScheduledScriptCount(m_scriptSchedule.size());
 
-    if (threadPool)
-    {
-        threadPool->stop();
-        delete threadPool;
-    }
+    // waits for our tasks still queued on the shared executor
+    delete threadPool;
 
     MMAP::MMapFactory::createOrGetMMapManager()->unloadMapInstance(GetId(), GetInstanceId());
 
@@ -541,7 +653,7 @@ void Map::LoadMapAndVMap(int gx, int gy)
 }
 
 Map::Map(uint32 id, time_t expiry, uint32 InstanceId, Difficulty difficulty, Map* _parent) :
-m_updateTime(0), m_sessionTime(0), m_mapLoopCounter(0),
+m_updateTime(0), m_sessionTime(0), m_mapLoopCounter(0), m_tickPrevTime(0), m_tickTask(nullptr), m_sessionWake(false), m_sessionsBusy(false), m_tickParked(false), i_collectGeneration(0), i_unitPositionIndex(*this),
 m_activeNonPlayersIter(m_activeNonPlayers.end()), i_grids(), GridMaps(), _transportsUpdateIter(_transports.end())
 {
     i_mapEntry = sMapStore.LookupEntry(id);
@@ -575,14 +687,14 @@ m_activeNonPlayersIter(m_activeNonPlayers.end()), i_grids(), GridMaps(), _transp
     }
 
     i_timer_se.SetInterval(sWorld->getIntConfig(CONFIG_INTERVAL_MAP_SESSION_UPDATE));
+
+    m_Functions.SetWakeHandler([](void* map) { static_cast<Map*>(map)->WakeTickForQueuedWork(false); }, this);
+
     i_timer_op.SetInterval(1000); // OutdoorPvP timer update
     m_respawnChallenge = 0;
 
     if (CanCreatedZone() || CanCreatedThread())
-    {
-        threadPool = new ThreadPoolMap();
-        threadPool->start(sWorld->getIntConfig(CONFIG_MAP_NUMTHREADS));
-    }
+        threadPool = new MapTaskGroup();
     else
         threadPool = nullptr;
 
@@ -645,6 +757,7 @@ void Map::AddToGrid(Player *obj, Cell const &cell)
 {
     auto const ngrid = getNGrid(cell.GridX(), cell.GridY());
     ngrid->GetGrid(cell.CellX(), cell.CellY()).AddWorldObject(obj);
+    i_unitPositionIndex.Invalidate(cell);
 }
 
 void Map::AddToGrid(Creature *obj, Cell const &cell)
@@ -656,6 +769,7 @@ void Map::AddToGrid(Creature *obj, Cell const &cell)
         ngrid->GetGrid(cell.CellX(), cell.CellY()).AddGridObject(obj);
 
     obj->SetCurrentCell(cell);
+    i_unitPositionIndex.Invalidate(cell);
 }
 
 void Map::AddToGrid(GameObject *obj, Cell const &cell)
@@ -1040,7 +1154,8 @@ void Map::Update(const uint32 t_diff)
     volatile uint32 _mapId = GetId();
     volatile uint32 _instanceId = GetInstanceId();
 
-    uint32 _s = getMSTime();
+    i_tickProfiler.ReportIfRequested(GetId(), GetInstanceId());
+    MapTickPhaseTimer totalTimer(i_tickProfiler, MAP_TICK_PHASE_TOTAL);
 
     m_Functions.Update(t_diff);
 
@@ -1049,125 +1164,61 @@ void Map::Update(const uint32 t_diff)
     /// update active cells around players and active objects
     resetMarkedCells();
 
-    // update worldsessions for existing players
-    for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
-    {
-        if (b_isMapUnload)
-            return;
-
-        if (Player* player = m_mapRefIter->getSource())
-        {
-            if (player->IsDelete() || player->IsPreDelete()) // If object in delete list or ported don`t update it
-                continue;
+    // a new generation per pass of any map, objects moved between maps in one tick are still collected
+    static std::atomic<uint64> collectGeneration(0);
+    i_collectGeneration = ++collectGeneration;
 
-            WorldSession* session = player->GetSession();
-            m_currentSession = session;
-            if (!session || session->PlayerLoading() || session->PlayerLogout()) // Prevent update if player not in map fulling
-                continue;
+    i_updatePartition.BeginTick(sWorld->getIntConfig(CONFIG_SIZE_CELL_FOR_PULL));
 
-            if (player->IsChangeMap() || player->GetMap() != this || session->GetMap() != this)
-                continue;
+    // packed unit positions are valid for one update phase at most
+    i_unitPositionIndex.Reset();
 
-            try
-            {
-                // Can be not in world after WorldSession::Update
-                if (player->IsInWorld())
-                {
-                    uint32 _ss = getMSTime();
-                    player->Update(t_diff);
-                    uint32 _mssu = GetMSTimeDiffToNow(_ss);
-                    VisitNearbyCellsOf(player);
-                    uint32 _mss = GetMSTimeDiffToNow(_ss);
-                    if (_mss > 250)
-                        sLog->outDiff("player->Update: type - player, g:%u castCount %u targetCount %u All %ums player %ums mapId %u diff %u i_InstanceId %u activeEntry %u", player->GetGUIDLow(), player->_castCount, player->_targetCount, _mss, _mssu, GetId(), t_diff, i_InstanceId, m_activeEntry);
-                }
-                if (player->IsRemoveFromMap())
-                {
-                    RemovePlayerFromMap(player, false);
-                    player->SetRemoveFromMap(false);
-                    session->SetCanLogout();
-                }
-            }
-            catch (std::exception& e)
-            {
-                // sLog->outTryCatch("\n\n//==-----------------------------------------------------------------------------------------------------==//");
-                sLog->outTryCatch("Exception caught Player in Map::Update %s _mapId %u InstanceId %u", e.what(), _mapId, _instanceId);
-
-                if (m_currentSession)
-                    m_currentSession->KickPlayer();
-            }
-        }
+    {
+        MapTickPhaseTimer timer(i_tickProfiler, MAP_TICK_PHASE_PLAYERS);
+        UpdatePlayers(t_diff);
     }
 
-    m_currentSession = nullptr;
+    i_unitPositionIndex.Reset();
 
-    uint32 _ms = GetMSTimeDiffToNow(_s);
-    if (_ms > 200)
-        sLog->outDiff("Map::Update Player mapId %u Update time - %ums diff %u Players online: %u i_InstanceId %u activeEntry %u", GetId(), _ms, t_diff, m_sessions.size(), i_InstanceId, m_activeEntry);
+    m_currentSession = nullptr;
 
     if (b_isMapUnload)
         return;
 
-    // non-player active objects, increasing iterator in the loop in case of object removal
-    for (auto &obj: m_activeNonPlayers)
     {
-        if (obj && obj->IsInWorld())
-        {
-            if (CanCreatedZone())
-            {
-                if (obj->GetCurrentZoneID() == i_InstanceId)
-                    VisitNearbyCellsOf(obj);
-            }
-            else
-                VisitNearbyCellsOf(obj);
-        }
-    }
+        MapTickPhaseTimer timer(i_tickProfiler, MAP_TICK_PHASE_COLLECTED);
 
-    uint32 collectedCount = 0;
-    for (auto const _stepY : {0, 1})
-    {
-        for (auto const _stepX : {0, 1})
+        // non-player active objects, increasing iterator in the loop in case of object removal
+        for (auto &obj: m_activeNonPlayers)
         {
-            for (auto& collected : i_objectUpdater[_stepY][_stepX])
+            if (obj && obj->IsInWorld())
             {
-                if (collected.second.empty())
-                    continue;
-
-                collectedCount += collected.second.size();
-
-                if (threadPool)
+                if (CanCreatedZone())
                 {
-                    threadPool->schedule([collected, t_diff, this]() mutable {
-                    updateCollected(collected.second, t_diff, GetId(), GetInstanceId());
-                    });
+                    if (obj->GetCurrentZoneID() == i_InstanceId)
+                        VisitNearbyCellsOf(obj);
                 }
                 else
-                    updateCollected(collected.second, t_diff, GetId(), GetInstanceId());
+                    VisitNearbyCellsOf(obj);
             }
-
-            if (threadPool)
-                threadPool->wait();
-
-            i_objectUpdater[_stepY][_stepX].clear();
         }
+
+        UpdateCollectedTiles(t_diff);
     }
-    i_objectTest.clear();
 
-    _ms = GetMSTimeDiffToNow(_s);
-    if (_ms > 250)
-        sLog->outDiff("Map::Update Collected mapId %u Update time - %ums diff %u Players online: %u i_InstanceId %u activeEntry %u collectedCount %u", GetId(), _ms, t_diff, m_sessions.size(), i_InstanceId, m_activeEntry, collectedCount);
+    i_unitPositionIndex.Reset();
 
     // sWorldStateMgr.MapUpdate(this);
 
     ///- Process necessary scripts
     if (!m_scriptSchedule.empty())
     {
+        MapTickPhaseTimer timer(i_tickProfiler, MAP_TICK_PHASE_SCRIPTS);
         i_scriptLock = true;
         ScriptsProcess();
         i_scriptLock = false;
     }
 
-
     if (_weatherUpdateTimer.Passed())
     {
         for (auto&& zoneInfo : _zoneDynamicInfo)
@@ -1177,73 +1228,26 @@ void Map::Update(const uint32 t_diff)
         _weatherUpdateTimer.Reset();
     }
 
-    _ms = GetMSTimeDiffToNow(_s);
-    if (_ms > 250)
-        sLog->outDiff("Map::Update ScriptsProcess mapId %u Update time - %ums diff %u Players online: %u i_InstanceId %u activeEntry %u activeEncounter %u", GetId(), _ms, t_diff, m_sessions.size(), i_InstanceId, m_activeEntry, m_activeEncounter);
-
     if (b_isMapUnload)
         return;
 
-    MoveAllCreaturesInMoveList();
-    MoveAllGameObjectsInMoveList();
-    MoveAllDynamicObjectsInMoveList();
-    MoveAllAreaTriggersInMoveList();
-
-    _ms = GetMSTimeDiffToNow(_s);
-    if (_ms > 250)
-        sLog->outDiff("Map::Update MoveAll mapId %u Update time - %ums diff %u Players online: %u i_InstanceId %u activeEntry %u activeEncounter %u", GetId(), _ms, t_diff, m_sessions.size(), i_InstanceId, m_activeEntry, m_activeEncounter);
-
-    std::set<ObjectGuid> objectsTemp;
-
-    if (!i_objects.empty())
     {
-        std::lock_guard<std::recursive_mutex> _lock(i_objectLock);
-        std::swap(objectsTemp, i_objects);
+        MapTickPhaseTimer timer(i_tickProfiler, MAP_TICK_PHASE_MOVE_LISTS);
+        MoveAllCreaturesInMoveList();
+        MoveAllGameObjectsInMoveList();
+        MoveAllDynamicObjectsInMoveList();
+        MoveAllAreaTriggersInMoveList();
     }
 
+    i_unitPositionIndex.Reset();
+
     if (b_isMapUnload)
         return;
 
-    for (auto &guid : objectsTemp)
     {
-        if (Object* obj = ObjectAccessor::GetObject(this, guid))
-        {
-            if (threadPool)
-            {
-                threadPool->schedule([obj] 
-                {
-                    UpdateDataMapType update_players;
-                    obj->BuildUpdate(update_players);
-
-                    WorldPacket packet;
-                    for (auto& updatePlayer : update_players)
-                    {
-                        if (updatePlayer.second.BuildPacket(&packet))
-                            updatePlayer.first->SendDirectMessage(&packet);
-                        packet.clear();
-                    }}
-                );
-            }
-            else
-            {
-                UpdateDataMapType update_players;
-                obj->BuildUpdate(update_players);
-
-                WorldPacket packet;
-                for (auto& updatePlayer : update_players)
-                {
-                    if (updatePlayer.second.BuildPacket(&packet))
-                        updatePlayer.first->SendDirectMessage(&packet);
-                    packet.clear();
-                }
-            }
-        }
+        MapTickPhaseTimer timer(i_tickProfiler, MAP_TICK_PHASE_UPDATE_DATA);
+        SendObjectUpdates();
     }
-    objectsTemp.clear();
-
-    _ms = GetMSTimeDiffToNow(_s);
-    if (_ms > 250)
-        sLog->outDiff("Map::Update UpdateDataMap mapId %u Update time - %ums diff %u Players online: %u i_InstanceId %u activeEntry %u activeEncounter %u", GetId(), _ms, t_diff, m_sessions.size(), i_InstanceId, m_activeEntry, m_activeEncounter);
 
     std::set<Object*> objectsAddTemp;
     if (!i_objectsAddToMap.empty())
@@ -1260,8 +1264,12 @@ void Map::Update(const uint32 t_diff)
     }
     objectsAddTemp.clear();
 
-    for (auto& scenario : m_scenarios)
-        scenario->Update(t_diff);
+    if (!m_scenarios.empty())
+    {
+        MapTickPhaseTimer timer(i_tickProfiler, MAP_TICK_PHASE_SCENARIOS);
+        for (auto& scenario : m_scenarios)
+            scenario->Update(t_diff);
+    }
 
     if (threadPool)
         threadPool->wait();
@@ -1275,10 +1283,6 @@ void Map::Update(const uint32 t_diff)
         UpdateOutdoorPvP(uint32(i_timer_op.GetCurrent()));
         i_timer_op.SetCurrent(0);
     }
-
-    _ms = GetMSTimeDiffToNow(_s);
-    if (_ms > 500) // Only lags
-        sLog->outDiff("Map::Update mapId %u Update time - %ums diff %u Players online: %u i_InstanceId %u activeEntry %u activeEncounter %u", GetId(), _ms, t_diff, m_sessions.size(), i_InstanceId, m_activeEntry, m_activeEncounter);
 }
 
 void Map::UpdateSessions(uint32 diff)
@@ -1286,12 +1290,14 @@ void Map::UpdateSessions(uint32 diff)
     volatile uint32 _mapId = GetId();
     volatile uint32 _instanceId = GetInstanceId();
 
-    uint32 _s = getMSTime();
+    MapTickPhaseTimer timer(i_tickProfiler, MAP_TICK_PHASE_SESSIONS);
 
     WorldSessionPtr sess = nullptr;
     while (addSessQueue.next(sess))
         AddSession_(sess);
 
+    bool sessionsBusy = false;
+
     // update worldsessions for existing players
     for (SessionMap::iterator itr = m_sessions.begin(), next; itr != m_sessions.end(); itr = next)
     {
@@ -1312,6 +1318,7 @@ void Map::UpdateSessions(uint32 diff)
             if (pSession->GetPlayer()->IsChangeMap())
             {
                 pSession->m_Functions.Update(diff);
+                sessionsBusy = true;
                 continue;
             }
 
@@ -1323,13 +1330,17 @@ void Map::UpdateSessions(uint32 diff)
             pSession->LogoutPlayer(true);
             pSession->SetMap(nullptr);
             m_sessions.erase(itr);
+            continue;
         }
+
+        if (pSession->HasPendingWork())
+            sessionsBusy = true;
     }
     m_currentSession = nullptr;
 
-    uint32 _ms = GetMSTimeDiffToNow(_s);
-    if (_ms > 500)
-        sLog->outDiff("Map::UpdateSessions mapId %u Update time - %ums diff %u", GetId(), _ms, diff);
+    if (sessionsBusy)
+        if (Map* owner = GetTickOwner())
+            owner->m_sessionsBusy = true;
 }
 
 void Map::UpdateOutdoorPvP(uint32 diff)
@@ -1337,8 +1348,6 @@ void Map::UpdateOutdoorPvP(uint32 diff)
     if (b_isMapUnload)
         return;
 
-    uint32 _s = getMSTime();
-
     if (OutdoorPvPList && !OutdoorPvPList->empty())
         for (auto itr : *OutdoorPvPList)
             if (itr && itr->GetMap() == this)
@@ -1349,10 +1358,6 @@ void Map::UpdateOutdoorPvP(uint32 diff)
             if (itr && itr->GetMap() == this)
                 if (itr->IsEnabled())
                     itr->Update(diff);
-
-    uint32 _ms = GetMSTimeDiffToNow(_s);
-    if (_ms > 500)
-        sLog->outDiff("Map::UpdateOutdoorPvP mapId %u Update time - %ums diff %u", GetId(), _ms, diff);
 }
 
 uint32 Map::GetCurrentDiff() const
@@ -1459,6 +1464,9 @@ void Map::PlayerRelocation(Player* player, float x, float y, float z, float orie
     Cell old_cell(player->GetPositionX(), player->GetPositionY());
     Cell new_cell(x, y);
 
+    if (!old_cell.DiffGrid(new_cell) && !old_cell.DiffCell(new_cell))
+        i_unitPositionIndex.OnRelocated(player->GetGUID(), x, y, z);
+
     player->Relocate(x, y, z, orientation);
     player->m_movementInfo.Pos.Relocate(x, y, z, orientation);
 
@@ -1499,6 +1507,7 @@ void Map::CreatureRelocation(Creature* creature, float x, float y, float z, floa
     }
     else
     {
+        i_unitPositionIndex.OnRelocated(creature->GetGUID(), x, y, z);
         creature->Relocate(x, y, z, ang);
         if (creature->IsVehicle())
             creature->GetVehicleKit()->RelocatePassengers();
@@ -2370,7 +2379,7 @@ inline GridMap* Map::GetGrid(float x, float y)
     return GridMaps[gx][gy];
 }
 
-float Map::GetWaterOrGroundLevel(std::set<uint32> const& phases, float x, float y, float z, float* ground /*= NULL*/, bool /*swim = false*/) const
+float Map::GetWaterOrGroundLevel(PhaseSet phases, float x, float y, float z, float* ground /*= NULL*/, bool /*swim = false*/) const
 {
     if (const_cast<Map*>(this)->GetGrid(x, y))
     {
@@ -2512,7 +2521,7 @@ bool Map::GetAreaInfo(float x, float y, float z, uint32 &flags, int32 &adtId, in
     int32 dgroupId;
 
     bool hasVmapAreaInfo = vmgr->getAreaInfo(GetId(), x, y, vmap_z, vflags, vadtId, vrootId, vgroupId);
-    bool hasDynamicAreaInfo = _dynamicTree.getAreaInfo(x, y, dynamic_z, std::set<uint32>(), false, dflags, dadtId, drootId, dgroupId);
+    bool hasDynamicAreaInfo = _dynamicTree.getAreaInfo(x, y, dynamic_z, PhaseSet(), false, dflags, dadtId, drootId, dgroupId);
     auto useVmap = [&]() { check_z = vmap_z; flags = vflags; adtId = vadtId; rootId = vrootId; groupId = vgroupId; };
     auto useDyn = [&]() { check_z = dynamic_z; flags = dflags; adtId = dadtId; rootId = drootId; groupId = dgroupId; };
 
@@ -2725,13 +2734,13 @@ float Map::GetWaterLevel(float x, float y) const
     return 0;
 }
 
-bool Map::isInLineOfSight(float x1, float y1, float z1, float x2, float y2, float z2, std::set<uint32> const& phases, VMAP::ModelIgnoreFlags ignoreFlags, DynamicTreeCallback* dCallback /*= nullptr*/) const
+bool Map::isInLineOfSight(float x1, float y1, float z1, float x2, float y2, float z2, PhaseSet phases, VMAP::ModelIgnoreFlags ignoreFlags, DynamicTreeCallback* dCallback /*= nullptr*/) const
 {
     return VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), x1, y1, z1, x2, y2, z2, ignoreFlags)
         && _dynamicTree.isInLineOfSight({ x1, y1, z1 }, { x2, y2, z2 }, phases, dCallback);
 }
 
-bool Map::getObjectHitPos(std::set<uint32> const& phases, bool otherUsePlayerPhasingRules, Position startPos, Position destPos, float modifyDist, DynamicTreeCallback* dCallback /*= nullptr*/)
+bool Map::getObjectHitPos(PhaseSet phases, bool otherUsePlayerPhasingRules, Position startPos, Position destPos, float modifyDist, DynamicTreeCallback* dCallback /*= nullptr*/)
 {
     G3D::Vector3 resultPos;
     G3D::Vector3 _startPos = G3D::Vector3(startPos.m_positionX, startPos.m_positionY, startPos.m_positionZ);
@@ -2739,7 +2748,7 @@ bool Map::getObjectHitPos(std::set<uint32> const& phases, bool otherUsePlayerPha
     return _dynamicTree.getObjectHitPos(phases, otherUsePlayerPhasingRules, _startPos, _dstPos, resultPos, modifyDist, dCallback);
 }
 
-bool Map::getObjectHitPos(std::set<uint32> const& phases, bool otherUsePlayerPhasingRules, float x1, float y1, float z1, float x2, float y2, float z2, float& rx, float& ry, float& rz, float modifyDist, DynamicTreeCallback* dCallback /*= nullptr*/)
+bool Map::getObjectHitPos(PhaseSet phases, bool otherUsePlayerPhasingRules, float x1, float y1, float z1, float x2, float y2, float z2, float& rx, float& ry, float& rz, float modifyDist, DynamicTreeCallback* dCallback /*= nullptr*/)
 {
     G3D::Vector3 startPos = G3D::Vector3(x1, y1, z1);
     G3D::Vector3 dstPos = G3D::Vector3(x2, y2, z2);
@@ -2752,7 +2761,7 @@ bool Map::getObjectHitPos(std::set<uint32> const& phases, bool otherUsePlayerPha
     return result;
 }
 
-float Map::GetHeight(std::set<uint32> const& phases, float x, float y, float z, bool vmap /*= true*/, float maxSearchDist /*= DEFAULT_HEIGHT_SEARCH*/, DynamicTreeCallback* dCallback /*= nullptr*/) const
+float Map::GetHeight(PhaseSet phases, float x, float y, float z, bool vmap /*= true*/, float maxSearchDist /*= DEFAULT_HEIGHT_SEARCH*/, DynamicTreeCallback* dCallback /*= nullptr*/) const
 {
     float vmapZ = GetHeight(x, y, z, vmap, maxSearchDist);
     float goZ = _dynamicTree.getHeight(x, y, z, maxSearchDist, phases, dCallback);
@@ -3194,11 +3203,12 @@ uint32 Map::GetPlayersCountExceptGMs() const
 
 void Map::SendToPlayers(WorldPacket const* data) const
 {
+    SharedWorldPacket shared(*data);
     for (MapRefManager::const_iterator itr = m_mapRefManager.begin(), next; itr != m_mapRefManager.end(); itr = next)
     {
         next = itr;
         ++next;
-        itr->getSource()->SendDirectMessage(data);
+        itr->getSource()->SendDirectMessage(shared);
     }
 }
 
@@ -4697,6 +4707,123 @@ void Map::UpdateEncounterState(EncounterCreditType type, uint32 creditEntry, Uni
     sLFGMgr->SetCompletedMask(groupGuid, completedEncounters);
 }
 
+void Map::SendObjectUpdates()
+{
+    std::set<ObjectGuid> objectsTemp;
+
+    if (!i_objects.empty())
+    {
+        std::lock_guard<std::recursive_mutex> _lock(i_objectLock);
+        std::swap(objectsTemp, i_objects);
+    }
+
+    i_updateObjectsTemp.clear();
+    for (auto &guid : objectsTemp)
+        if (Object* obj = ObjectAccessor::GetObject(this, guid))
+            i_updateObjectsTemp.push_back(obj);
+
+    if (i_updateObjectsTemp.empty())
+        return;
+
+    // small batches are not worth a task of their own
+    std::size_t const minObjectsPerTask = 16;
+    std::size_t taskCount = 1;
+    if (threadPool)
+        taskCount = std::max<std::size_t>(1, std::min<std::size_t>(sMapTaskExecutor->GetWorkerCount(), i_updateObjectsTemp.size() / minObjectsPerTask));
+
+    if (i_updateDataShards.size() < taskCount)
+    {
+        i_updateDataShards.resize(taskCount);
+        i_updateDataReceivers.resize(taskCount);
+        i_updateDataStale.resize(taskCount);
+    }
+
+    for (std::size_t i = taskCount; i < i_updateDataShards.size(); ++i)
+        i_updateDataShards[i].clear();
+
+    // by source: every task accumulates the blocks of its objects per receiver
+    std::size_t chunk = (i_updateObjectsTemp.size() + taskCount - 1) / taskCount;
+    for (std::size_t i = 0; i < taskCount; ++i)
+    {
+        UpdateDataMapType* updateData = &i_updateDataShards[i];
+        std::size_t begin = i * chunk;
+        std::size_t end = std::min(begin + chunk, i_updateObjectsTemp.size());
+        auto build = [this, updateData, begin, end]()
+        {
+            for (std::size_t j = begin; j < end; ++j)
+                i_updateObjectsTemp[j]->BuildUpdate(*updateData);
+        };
+
+        if (threadPool && taskCount > 1)
+            threadPool->schedule(build);
+        else
+            build();
+    }
+
+    if (threadPool && taskCount > 1)
+        threadPool->wait();
+
+    // by receiver: blocks of all tasks are merged into one packet, tasks own disjoint receivers
+    for (std::size_t i = 0; i < taskCount; ++i)
+    {
+        auto send = [this, i, taskCount]()
+        {
+            std::unordered_map<Player*, UpdateData*>& receivers = i_updateDataReceivers[i];
+            std::vector<std::pair<std::size_t, Player*>>& stale = i_updateDataStale[i];
+            receivers.clear();
+            stale.clear();
+
+            for (std::size_t shard = 0; shard < taskCount; ++shard)
+            {
+                for (auto& updatePlayer : i_updateDataShards[shard])
+                {
+                    // keys of stale entries are never dereferenced
+                    if ((reinterpret_cast<uintptr_t>(updatePlayer.first) >> 4) % taskCount != i)
+                        continue;
+
+                    if (!updatePlayer.second.HasData())
+                    {
+                        stale.emplace_back(shard, updatePlayer.first);
+                        continue;
+                    }
+
+                    auto itr = receivers.emplace(updatePlayer.first, &updatePlayer.second);
+                    if (!itr.second)
+                    {
+                        itr.first->second->AddUpdateData(updatePlayer.second);
+                        updatePlayer.second.Clear();
+                        updatePlayer.second.SetMapId(GetId());
+                    }
+                }
+            }
+
+            WorldPacket packet;
+            for (auto& receiver : receivers)
+            {
+                if (receiver.second->BuildPacket(&packet))
+                    receiver.first->SendDirectMessage(&packet);
+                packet.clear();
+
+                receiver.second->Clear();
+                receiver.second->SetMapId(GetId());
+            }
+        };
+
+        if (threadPool && taskCount > 1)
+            threadPool->schedule(send);
+        else
+            send();
+    }
+
+    if (threadPool && taskCount > 1)
+        threadPool->wait();
+
+    // entries of receivers that got nothing this tick may point to players that are gone
+    for (std::size_t i = 0; i < taskCount; ++i)
+        for (auto const& stale : i_updateDataStale[i])
+            i_updateDataShards[stale.first].erase(stale.second);
+}
+
 void Map::AddUpdateObject(Object* obj)
 {
     std::lock_guard<std::recursive_mutex> _lock(i_objectLock);
@@ -4711,91 +4838,172 @@ void Map::RemoveUpdateObject(Object* obj)
 
 void Map::AddToMapWait(Object* obj)
 {
-    std::lock_guard<std::recursive_mutex> _objectsAddToMap_lock(m_objectsAddToMap_lock);
-    i_objectsAddToMap.emplace(obj);
+    {
+        std::lock_guard<std::recursive_mutex> _objectsAddToMap_lock(m_objectsAddToMap_lock);
+        i_objectsAddToMap.emplace(obj);
+    }
+
+    WakeTick();
 }
 
-void Map::UpdateLoop(uint32 _mapID)
+uint32 Map::UpdateTick(uint32 _mapID)
 {
-    uint32 realCurrTime = 0;
-    uint32 realPrevTime = getMSTime();
+    m_tickThread = std::this_thread::get_id();
+    bool packetWake = m_sessionWake.exchange(false);
 
-    uint32 prevSleepTime = 0;
+    uint32 realCurrTime = getMSTime();
+    if (!m_tickPrevTime)
+        m_tickPrevTime = realCurrTime;
 
-    // TC_LOG_ERROR(LOG_FILTER_WORLDSERVER, "Map::UpdateLoop Run _mapID %u thread %u", _mapID, std::this_thread::get_id());
+    uint32 diff = getMSTimeDiff(m_tickPrevTime, realCurrTime);
 
-    while (!b_isMapStop)
+    // nothing was left to update while parked, resume with one idle interval instead of the whole parked time
+    if (m_tickParked)
     {
-        try
+        diff = std::min<uint32>(diff, MAP_IDLE_TICK_INTERVAL);
+        m_tickParked = false;
+    }
+
+    try
+    {
+        m_mapLoopCounter++;
+
+        i_timer.Update(diff);
+        i_timer_se.Update(diff);
+
+        // queued packets and pending session work are handled once per session interval, idle sessions follow the map update
+        bool sessionsDue = i_timer.Passed() || ((packetWake || m_sessionsBusy) && i_timer_se.Passed());
+        if (packetWake && !sessionsDue)
+            m_sessionWake = true;
+
+        if (sessionsDue)
         {
-            m_mapLoopCounter++;
-            uint32 slepp = sWorld->getIntConfig(CONFIG_INTERVAL_MAP_SESSION_UPDATE);
-            if (!Instanceable() && !CanCreatedZone() && !HavePlayers())
-                slepp = 1000;
+            uint32 _s = getMSTime();
+            m_sessionsBusy = false;
+            UpdateSessions(uint32(i_timer_se.GetCurrent()));
+            m_sessionTime = GetMSTimeDiffToNow(_s);
 
-            realCurrTime = getMSTime();
+            i_timer_se.SetCurrent(0);
+        }
 
-            uint32 diff = getMSTimeDiff(realPrevTime, realCurrTime);
+        if (i_timer.Passed())
+        {
+            uint32 _s = getMSTime();
+            uint32 curr = uint32(i_timer.GetCurrent());
+            Update(curr);
+            DelayedUpdate(curr);
+            UpdateTransport(curr);
+            m_updateTime = GetMSTimeDiffToNow(_s);
+
+            i_timer.SetCurrent(0);
+        }
 
-            i_timer.Update(diff);
-            i_timer_se.Update(diff);
+        if (i_timer_bp.Passed())
+        {
+            PopulateBattlePet(uint32(i_timer_bp.GetCurrent()));
+            i_timer_bp.SetCurrent(0);
+        }
+    }
+    catch (std::exception& e)
+    {
+        sLog->outTryCatch("Exception caught in Map::UpdateTick %s _mapID %u InstanceId %u", e.what(), _mapID, i_InstanceId);
 
-            if (i_timer_se.Passed())
-            {
-                uint32 _s = getMSTime();
-                UpdateSessions(uint32(i_timer_se.GetCurrent()));
-                m_sessionTime = GetMSTimeDiffToNow(_s);
+        if (m_currentSession)
+            m_currentSession->KickPlayer();
+    }
+    catch (...)
+    {
+        sLog->outTryCatch("Exception caught in Map::UpdateTick _mapID %u InstanceId %u", _mapID, i_InstanceId);
 
-                i_timer_se.SetCurrent(0);
-            }
+        if (m_currentSession)
+            m_currentSession->KickPlayer();
+    }
 
-            if (i_timer.Passed())
-            {
-                uint32 _s = getMSTime();
-                uint32 curr = uint32(i_timer.GetCurrent());
-                Update(curr);
-                DelayedUpdate(curr);
-                UpdateTransport(curr);
-                m_updateTime = GetMSTimeDiffToNow(_s);
-
-                i_timer.SetCurrent(0);
-            }
+    m_tickPrevTime = realCurrTime;
 
-            if (i_timer_bp.Passed())
-            {
-                PopulateBattlePet(uint32(i_timer_bp.GetCurrent()));
-                i_timer_bp.SetCurrent(0);
-            }
+    // the next deadline is derived from the timers, time spent updating is already taken out of it
+    uint32 elapsed = GetMSTimeDiffToNow(realCurrTime);
+    auto remaining = [elapsed](IntervalTimer const& timer) -> uint32
+    {
+        time_t left = timer.GetInterval() - timer.GetCurrent() - time_t(elapsed);
+        return left > 0 ? uint32(left) : 0;
+    };
 
-            realPrevTime = realCurrTime;
+    uint32 wait = remaining(i_timer);
 
-            if (diff <= slepp + prevSleepTime)
-            {
-                prevSleepTime = slepp + prevSleepTime - diff;
-                std::this_thread::sleep_for(Milliseconds(prevSleepTime));
-            }
-            else
-                prevSleepTime = 0;
-        }
-        catch (std::exception& e)
+    // empty world maps keep the old one second cadence until nothing is left to update, then they park
+    if (!Instanceable() && !CanCreatedZone() && !HavePlayers())
+    {
+        if (CanParkTick())
         {
-            // sLog->outTryCatch("\n\n//==-----------------------------------------------------------------------------------------------------==//");
-            sLog->outTryCatch("Exception caught in Map::UpdateLoop %s _mapID %u InstanceId %u", e.what(), _mapID, i_InstanceId);
-
-            if (m_currentSession)
-                m_currentSession->KickPlayer();
+            m_tickParked = true;
+            m_tickThread = std::thread::id();
+            return MapUpdateScheduler::PARK;
         }
-        catch (...)
-        {
-            // sLog->outTryCatch("\n\n//==-----------------------------------------------------------------------------------------------------==//");
-            sLog->outTryCatch("Exception caught in Map::UpdateLoop _mapID %u InstanceId %u", _mapID, i_InstanceId);
 
-            if (m_currentSession)
-                m_currentSession->KickPlayer();
-        }
+        wait = std::max<uint32>(wait, MAP_IDLE_TICK_INTERVAL - std::min<uint32>(elapsed, MAP_IDLE_TICK_INTERVAL));
+    }
+
+    if (m_sessionWake || m_sessionsBusy)
+        wait = std::min(wait, remaining(i_timer_se));
+
+    m_tickThread = std::thread::id();
+    return wait;
+}
+
+Map* Map::GetTickOwner()
+{
+    // instances are driven by the tick of their MapInstanced
+    return m_tickTask ? this : m_parentMap;
+}
+
+void Map::WakeTick(bool packets /*= false*/)
+{
+    Map* owner = GetTickOwner();
+    if (!owner)
+        return;
+
+    if (packets)
+        owner->m_sessionWake = true;
+
+    if (MapTickTask* task = owner->m_tickTask)
+        sMapUpdateScheduler->Wake(task);
+}
+
+void Map::WakeTickForQueuedWork(bool sessions)
+{
+    Map* owner = GetTickOwner();
+    if (!owner)
+        return;
+
+    // the running tick takes its own work into account when it picks the next deadline
+    if (owner->m_tickThread.load() == std::this_thread::get_id())
+    {
+        if (sessions)
+            owner->m_sessionsBusy = true;
+        return;
     }
 
-    //TC_LOG_ERROR(LOG_FILTER_WORLDSERVER, "Map::UpdateLoop Stop _mapID %u thread %u", _mapID, std::this_thread::get_id());
+    WakeTick(sessions);
+}
+
+bool Map::CanParkTick() const
+{
+    if (HavePlayers() || !m_sessions.empty() || !i_loadedGrids.empty() || !m_activeNonPlayers.empty())
+        return false;
+
+    if (!_transports.empty() || !m_StaticTransports.empty() || !m_scenarios.empty() || !m_scriptSchedule.empty())
+        return false;
+
+    if ((OutdoorPvPList && !OutdoorPvPList->empty()) || (BattlefieldList && !BattlefieldList->empty()) || m_brawlerGuild)
+        return false;
+
+    // filled from other threads, a producer that misses this check wakes the map itself
+    if (!const_cast<Map*>(this)->addSessQueue.empty() || !m_Functions.Empty())
+        return false;
+
+    std::lock_guard<std::recursive_mutex> guard(const_cast<Map*>(this)->m_objectsAddToMap_lock);
+    return i_objectsAddToMap.empty();
 }
 
 void Map::SetMapUpdateInterval()
@@ -4848,6 +5056,7 @@ void Map::AddSession(WorldSessionPtr s)
         return;
 
     addSessQueue.add(s);
+    WakeTick(true);
 }
 
 void Map::AddSession_(WorldSessionPtr s)
@@ -4884,9 +5093,11 @@ void Map::RemoveStaticTransport(StaticTransport* t)
 
 void Map::UpdateTransport(uint32 diff)
 {
-    if (b_isMapUnload)
+    if (b_isMapUnload || _transports.empty())
         return;
 
+    MapTickPhaseTimer timer(i_tickProfiler, MAP_TICK_PHASE_TRANSPORTS);
+
     for (_transportsUpdateIter = _transports.begin(); _transportsUpdateIter != _transports.end();)
     {
         WorldObject* obj = *_transportsUpdateIter;
@@ -4941,17 +5152,6 @@ bool Map::CanUnloadMap()
     return sWorld->getBoolConfig(CONFIG_GRID_UNLOAD);
 }
 
-void Map::TerminateThread()
-{
-    if (threadPool)
-    {
-        threadPool->terminate();
-        delete threadPool;
-        threadPool = new ThreadPoolMap();
-        threadPool->start(sWorld->getIntConfig(CONFIG_MAP_NUMTHREADS));
-    }
-}
-
 void Map::AddBattlePet(Creature* creature)
 {
     if (sWildBattlePetMgr->IsBattlePet(creature->GetEntry()))
@@ -4966,9 +5166,8 @@ void Map::RemoveBattlePet(Creature* creature)
         m_wildBattlePetPool[creature->GetCurrentZoneID()][creature->GetEntry()].ToBeReplaced.erase(creature);
 }
 
-void Map::PopulateBattlePet(uint32 diff)
+void Map::PopulateBattlePet(uint32 /*diff*/)
 {
-    uint32 _s = getMSTime();
     for (auto& zone : m_wildBattlePetPool)
     {
         uint16 zoneId = zone.first;
@@ -4982,9 +5181,6 @@ void Map::PopulateBattlePet(uint32 diff)
             sWildBattlePetMgr->Populate(petTemplate, &iter.second);
         }
     }
-    uint32 _ms = GetMSTimeDiffToNow(_s);
-    if (_ms > 200)
-        sLog->outDiff("Map::PopulateBattlePet mapId %u Update time - %ums diff %u", GetId(), _ms, diff);
 }
 
 void Map::DepopulateBattlePet()
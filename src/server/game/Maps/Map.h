@@ -20,6 +20,7 @@
 #define TRINITY_MAP_H
 
 #include <bitset>
+#include <thread>
 
 #include "Cell.h"
 #include "DB2Structure.h"
@@ -27,16 +28,22 @@
 #include "FunctionProcessor.h"
 #include "GameObjectModel.h"
 #include "GridDefines.h"
+#include "LatencyHistogram.h"
 #include "MapRefManager.h"
 #include "NGrid.h"
 #include "SharedDefines.h"
-#include "ThreadPoolMap.hpp"
+#include "MapTaskExecutor.h"
+#include "MapTickProfiler.h"
+#include "MapUpdatePartition.h"
 #include "Timer.h"
+#include "UnitPositionIndex.h"
+#include "UpdateData.h"
 #include "Weather.h"
 #include "World.h"
 
 #include <safe_ptr.h>
 
+struct MapTickTask;
 struct Position;
 struct ScriptAction;
 struct ScriptInfo;
@@ -472,15 +479,15 @@ class TC_GAME_API Map
         InstanceMap* ToInstanceMap();
         InstanceMap const* ToInstanceMap() const;
 
-        float GetWaterOrGroundLevel(std::set<uint32> const& phases, float x, float y, float z, float* ground = nullptr, bool swim = false) const;
-        float GetHeight(std::set<uint32> const& phases, float x, float y, float z, bool vmap = true, float maxSearchDist = DEFAULT_HEIGHT_SEARCH, DynamicTreeCallback* dCallback = nullptr) const;
-        bool isInLineOfSight(float x1, float y1, float z1, float x2, float y2, float z2, std::set<uint32> const& phases, VMAP::ModelIgnoreFlags ignoreFlags, DynamicTreeCallback* dCallback = nullptr) const;
+        float GetWaterOrGroundLevel(PhaseSet phases, float x, float y, float z, float* ground = nullptr, bool swim = false) const;
+        float GetHeight(PhaseSet phases, float x, float y, float z, bool vmap = true, float maxSearchDist = DEFAULT_HEIGHT_SEARCH, DynamicTreeCallback* dCallback = nullptr) const;
+        bool isInLineOfSight(float x1, float y1, float z1, float x2, float y2, float z2, PhaseSet phases, VMAP::ModelIgnoreFlags ignoreFlags, DynamicTreeCallback* dCallback = nullptr) const;
         void Balance() { _dynamicTree.balance(); }
         void RemoveGameObjectModel(GameObjectModel const& model) { _dynamicTree.remove(model); }
         void InsertGameObjectModel(GameObjectModel const& model) { _dynamicTree.insert(model); }
         bool ContainsGameObjectModel(GameObjectModel const& model) const { return _dynamicTree.contains(model);}
-        bool getObjectHitPos(std::set<uint32> const& phases, bool otherUsePlayerPhasingRules, Position startPos, Position destPos, float modifyDist, DynamicTreeCallback* dCallback = nullptr);
-        bool getObjectHitPos(std::set<uint32> const& phases, bool otherUsePlayerPhasingRules, float x1, float y1, float z1, float x2, float y2, float z2, float& rx, float &ry, float& rz, float modifyDist, DynamicTreeCallback* dCallback = nullptr);
+        bool getObjectHitPos(PhaseSet phases, bool otherUsePlayerPhasingRules, Position startPos, Position destPos, float modifyDist, DynamicTreeCallback* dCallback = nullptr);
+        bool getObjectHitPos(PhaseSet phases, bool otherUsePlayerPhasingRules, float x1, float y1, float z1, float x2, float y2, float z2, float& rx, float &ry, float& rz, float modifyDist, DynamicTreeCallback* dCallback = nullptr);
         void UpdateEncounterState(EncounterCreditType type, uint32 creditEntry, Unit* sourc, Unit* player);
 
         virtual ObjectGuid::LowType GetOwnerGuildId(uint32 /*team*/ = TEAM_OTHER) const { return 0; }
@@ -511,19 +518,34 @@ class TC_GAME_API Map
         bool IsMapUnload() { return b_isMapUnload; }
         void SetMapUnload(bool unload = true) { b_isMapUnload = unload; }
         void SetMapStop(bool _stop = true) { b_isMapStop = _stop; }
+        bool IsMapStop() const { return b_isMapStop; }
 
         // Update object in map
         void AddUpdateObject(Object* obj);
         void RemoveUpdateObject(Object* obj);
-        void UpdateLoop(uint32 _mapID);
+        uint32 UpdateTick(uint32 _mapID);           ///< one iteration of the map loop, returns ms until the next one is due or MapUpdateScheduler::PARK
+        void SetTickTask(MapTickTask* task) { m_tickTask = task; }
+        Map* GetTickOwner();                        ///< scheduled map that runs the ticks of this one, lives until shutdown
+        void WakeTick(bool packets = false);        ///< cut the sleep of the map driving this one short, safe from any thread
+        void WakeTickForQueuedWork(bool sessions);  ///< delayed functions were queued for this map or one of its sessions, safe from any thread
+        bool CanParkTick() const;
+        void RecordTickJitter(uint32 us) { m_tickJitter.Record(us); }
+        Trinity::LatencyHistogram const& GetTickJitter() const { return m_tickJitter; }
+        MapTickProfiler& GetTickProfiler() { return i_tickProfiler; }
         uint32 GetUpdateTime() const;
         uint32 GetSessionTime() const;
         void SetMapUpdateInterval();
 
-        void TerminateThread();
-        ThreadPoolMap* threadPool;
+        MapTaskGroup* threadPool;                   ///< fork/join barrier on the shared MapTaskExecutor
         std::set<ObjectGuid> i_objects;
 
+        // values updates of all changed objects, one SMSG_UPDATE_OBJECT per receiver
+        void SendObjectUpdates();
+        std::vector<Object*> i_updateObjectsTemp;
+        std::vector<UpdateDataMapType> i_updateDataShards;                      // one per build task, entries keep their buffers between ticks
+        std::vector<std::unordered_map<Player*, UpdateData*>> i_updateDataReceivers; // one per send task
+        std::vector<std::vector<std::pair<std::size_t, Player*>>> i_updateDataStale; // per send task, (shard, receiver) without data this tick
+
         void AddToMapWait(Object* obj);
         std::set<Object*> i_objectsAddToMap;
         std::recursive_mutex m_objectsAddToMap_lock;
@@ -556,6 +578,14 @@ class TC_GAME_API Map
         uint32 m_updateTime;
         uint32 m_sessionTime;
         uint32 m_mapLoopCounter;
+        uint32 m_tickPrevTime;
+        std::atomic<MapTickTask*> m_tickTask;
+        std::atomic<bool> m_sessionWake;            ///< packets were queued for a session of this map or its instances
+        bool m_sessionsBusy;                        ///< a session has callbacks, delayed functions or a queued spell, keeps the session interval
+        bool m_tickParked;
+        std::atomic<std::thread::id> m_tickThread;  ///< thread running UpdateTick of this map, if any
+        Trinity::LatencyHistogram m_tickJitter;     ///< us between a tick being due and a worker starting it
+        MapTickProfiler i_tickProfiler;
 
         std::set<OutdoorPvP*>* OutdoorPvPList{};
         std::set<Battlefield*>* BattlefieldList;
@@ -569,8 +599,15 @@ class TC_GAME_API Map
         uint32 m_activeEncounter;
 
         void updateCollected(std::vector<WorldObject*>& objectsToUpdate, uint32 diff, uint32 _mapId, uint32 _instanceId);
-        std::map<uint32, std::vector<WorldObject*>> i_objectUpdater[2][2];
-        std::set<WorldObject*> i_objectTest;
+        uint32 UpdateCollectedTiles(uint32 diff);
+
+        void UpdatePlayers(uint32 diff);
+        MapUpdatePartition const& GetUpdatePartition() const { return i_updatePartition; }
+        MapUpdatePartition i_updatePartition;
+        std::vector<MapUpdatePartition::Batch> i_updateBatches;
+        uint64 i_collectGeneration;                         // stamped on WorldObject::m_updateCollectGeneration to collect once per tick
+        UnitPositionIndex& GetUnitPositionIndex() { return i_unitPositionIndex; }
+        UnitPositionIndex i_unitPositionIndex;
         void VisitNearbyCellsOf(WorldObject* obj);
 
         std::set<Scenario*> m_scenarios;
@@ -23,6 +23,7 @@
 #include "InstanceSaveMgr.h"
 #include "MapInstanced.h"
 #include "MapManager.h"
+#include "MapUpdateScheduler.h"
 #include "MMapFactory.h"
 #include "ObjectMgr.h"
 #include "VMapFactory.h"
@@ -37,7 +38,6 @@ MapInstanced::MapInstanced(uint32 id, time_t expiry) : Map(id, expiry, 0, DIFFIC
     m_InstancedMaps.clear();
     m_GarrisonedMaps.clear();
 
-    _zoneThreads.clear();
     // fill with zero
     memset(&GridMapReference, 0, MAX_NUMBER_OF_GRIDS*MAX_NUMBER_OF_GRIDS*sizeof(uint16));
 }
@@ -54,19 +54,6 @@ void MapInstanced::InitVisibilityDistance()
             (*i).second->InitVisibilityDistance();
 }
 
-void MapInstanced::TerminateThread()
-{
-    if (!m_InstancedMaps.empty())
-        for (InstancedMaps::iterator i = m_InstancedMaps.begin(); i != m_InstancedMaps.end(); ++i)
-            (*i).second->TerminateThread();
-
-    if (!m_GarrisonedMaps.empty())
-        for (InstancedMaps::iterator i = m_GarrisonedMaps.begin(); i != m_GarrisonedMaps.end(); ++i)
-            (*i).second->TerminateThread();
-
-    Map::TerminateThread();
-}
-
 void MapInstanced::Update(const uint32 t)
 {
     volatile uint32 _mapId = GetId();
@@ -220,13 +207,6 @@ void MapInstanced::UnloadAll()
     m_InstancedMaps.clear();
     m_GarrisonedMaps.clear();
 
-    for (auto thread : _zoneThreads)
-    {
-        thread.second->join();
-        delete thread.second;
-    }
-    _zoneThreads.clear();
-
     // Unload own grids (just dummy(placeholder) grids, neccesary to unload GridMaps!)
     Map::UnloadAll();
 }
@@ -491,7 +471,7 @@ ZoneMap* MapInstanced::CreateZoneMap(uint32 zoneId, Player* player)
 
     map->UpdateOutdoorPvPScript();
 
-    _zoneThreads[zoneId] = new std::thread(&Map::UpdateLoop, map, zoneId);
+    sMapUpdateScheduler->Schedule(map, zoneId);
     return map;
 }
 
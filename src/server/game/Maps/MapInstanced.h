@@ -60,11 +60,8 @@ class MapInstanced : public Map
         InstancedMaps &GetInstancedMaps() { return m_InstancedMaps; }
         void InitVisibilityDistance() override;
 
-        void TerminateThread();
-
         InstancedMaps m_InstancedMaps;
         InstancedMaps m_GarrisonedMaps;
-        std::map<uint32, std::thread*> _zoneThreads;
 
     private:
         InstanceMap* CreateInstance(uint32 InstanceId, InstanceSave* save, Difficulty difficulty);
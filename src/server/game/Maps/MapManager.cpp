@@ -30,6 +30,8 @@
 #include "Log.h"
 #include "MapInstanced.h"
 #include "MapManager.h"
+#include "MapTaskExecutor.h"
+#include "MapUpdateScheduler.h"
 #include "MiscPackets.h"
 #include "ObjectAccessor.h"
 #include "ObjectMgr.h"
@@ -41,7 +43,6 @@ MapManager::MapManager(): _nextInstanceId(0), _mapInfoCounter(0), _scheduledScri
 {
     _mapCount = sMapStore.GetNumRows() + 1;
     i_maps.assign(_mapCount, nullptr);
-    _mapThreads.assign(_mapCount, nullptr);
     i_gridCleanUpDelay = sWorld->getIntConfig(CONFIG_INTERVAL_GRIDCLEAN);
 }
 
@@ -51,6 +52,9 @@ MapManager::~MapManager()
 
 void MapManager::Initialize()
 {
+    sMapUpdateScheduler->Start(sWorld->getIntConfig(CONFIG_NUMTHREADS), sWorld->getBoolConfig(CONFIG_MAP_PIN_THREADS));
+    // the executor only gets the cores the scheduler workers left free
+    sMapTaskExecutor->Start(sWorld->getIntConfig(CONFIG_MAP_NUMTHREADS), sWorld->getBoolConfig(CONFIG_MAP_PIN_THREADS), sMapUpdateScheduler->GetWorkerCount());
 }
 
 void MapManager::InitializeVisibilityDistanceInfo()
@@ -84,7 +88,7 @@ Map* MapManager::CreateBaseMap(uint32 id)
         }
 
         i_maps[id] = map;
-        _mapThreads[id] = new std::thread(&Map::UpdateLoop, map, id);
+        sMapUpdateScheduler->Schedule(map, id);
     }
 
     ASSERT(map);
@@ -372,8 +376,9 @@ void MapManager::UnloadAll()
         }
     }
 
-    // Wait when map is stop update
-    std::this_thread::sleep_for(Milliseconds(1000));
+    // Wait when map is stop update, in-flight ticks finish before the workers exit
+    sMapUpdateScheduler->Stop();
+    sMapTaskExecutor->Stop();
 
     for (uint16 i = 0; i < _mapCount; ++i)
     {
@@ -385,13 +390,6 @@ void MapManager::UnloadAll()
         }
     }
 
-    for (auto* thread : _mapThreads)
-    {
-        if (thread)
-            thread->join();
-        delete thread;
-    }
-
     sGuildMgr->UnloadAll();
     sScenarioMgr->UnloadAll();
 }
@@ -84,7 +84,6 @@ class TC_GAME_API MapManager
         void SetUnloadGarrison(uint32 lowGuid);
 
         Map* FindBaseMap(uint32 mapId) const { return i_maps[mapId]; }
-        std::vector<std::thread*> _mapThreads;
         uint16 _mapCount;
 
         uint32 IncreaseScheduledScriptsCount() { return ++_scheduledScripts; }
@@ -0,0 +1,172 @@
+/*
+ * Copyright (C) 2008-2017 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MapTaskExecutor.h"
+#include "Log.h"
+#include "MapUpdateScheduler.h"
+
+#include <algorithm>
+
+MapTaskExecutor::MapTaskExecutor() : _stopping(false)
+{
+}
+
+MapTaskExecutor::~MapTaskExecutor()
+{
+    Stop();
+}
+
+MapTaskExecutor* MapTaskExecutor::instance()
+{
+    static MapTaskExecutor instance;
+    return &instance;
+}
+
+void MapTaskExecutor::Start(std::size_t numThreads, bool pinThreads, std::size_t usedCores)
+{
+    if (!_threads.empty())
+        return;
+
+    std::size_t cores = std::max(1u, std::thread::hardware_concurrency());
+    std::size_t freeCores = cores > usedCores ? cores - usedCores : 0;
+
+    // one thread is always needed, it floats over the busy cores when none is left
+    std::size_t maxThreads = std::max<std::size_t>(1, freeCores);
+
+    if (numThreads > maxThreads)
+        TC_LOG_WARN("server.loading", "MapUpdate.Map.Threads = %u does not fit next to %u map update workers on %u hardware threads, using %u",
+            uint32(numThreads), uint32(usedCores), uint32(cores), uint32(maxThreads));
+
+    if (!numThreads || numThreads > maxThreads)
+        numThreads = maxThreads;
+
+    _stopping = false;
+
+    _threads.reserve(numThreads);
+    for (std::size_t i = 0; i < numThreads; ++i)
+        _threads.emplace_back(&MapTaskExecutor::WorkerThread, this, usedCores + i, pinThreads && usedCores + i < cores);
+
+    TC_LOG_INFO("server.loading", "Map task executor started with %u workers%s", uint32(numThreads), pinThreads && usedCores < cores ? " (pinned)" : "");
+}
+
+void MapTaskExecutor::Stop()
+{
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        if (_stopping)
+            return;
+        _stopping = true;
+    }
+    _cond.notify_all();
+
+    for (std::thread& thread : _threads)
+        if (thread.joinable())
+            thread.join();
+    _threads.clear();
+
+    // anything left is run inline, a group must never be left with pending work
+    std::deque<Task> left;
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        std::swap(left, _queue);
+    }
+
+    for (Task& task : left)
+        Run(task);
+}
+
+std::size_t MapTaskExecutor::GetQueueSize()
+{
+    std::lock_guard<std::mutex> guard(_lock);
+    return _queue.size();
+}
+
+void MapTaskExecutor::Submit(MapTaskGroup* group, std::function<void()>&& work)
+{
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        if (!_stopping && !_threads.empty())
+        {
+            _queue.push_back({ group, std::move(work) });
+            work = nullptr;
+        }
+    }
+
+    // no pool (not started yet or shutting down), keep the old single thread behaviour
+    if (work)
+    {
+        Task task{ group, std::move(work) };
+        Run(task);
+        return;
+    }
+
+    _cond.notify_one();
+}
+
+void MapTaskExecutor::WaitGroup(MapTaskGroup* group)
+{
+    // _pending is only checked under the lock, the group may be destroyed as soon as we return
+    std::unique_lock<std::mutex> guard(_lock);
+    while (!group->IsIdle())
+    {
+        auto itr = std::find_if(_queue.begin(), _queue.end(), [group](Task const& task) { return task.group == group; });
+        if (itr == _queue.end())
+        {
+            // every task left is running on a worker, the last one signals the group
+            group->_done.wait(guard, [group] { return group->IsIdle(); });
+            break;
+        }
+
+        Task task = std::move(*itr);
+        _queue.erase(itr);
+
+        guard.unlock();
+        Run(task);
+        guard.lock();
+    }
+}
+
+void MapTaskExecutor::WorkerThread(std::size_t core, bool pin)
+{
+    if (pin)
+        MapUpdateScheduler::PinCurrentThread(core);
+
+    while (true)
+    {
+        Task task;
+        {
+            std::unique_lock<std::mutex> guard(_lock);
+            _cond.wait(guard, [this] { return _stopping || !_queue.empty(); });
+            if (_queue.empty())
+                return;
+
+            task = std::move(_queue.front());
+            _queue.pop_front();
+        }
+
+        Run(task);
+    }
+}
+
+void MapTaskExecutor::Run(Task& task)
+{
+    task.work();
+
+    std::lock_guard<std::mutex> guard(_lock);
+    if (--task.group->_pending == 0)
+        task.group->_done.notify_all();
+}
@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2008-2017 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRINITY_MAP_TASK_EXECUTOR_H
+#define TRINITY_MAP_TASK_EXECUTOR_H
+
+#include "Define.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class MapTaskGroup;
+
+/*
+ * Process wide pool for the fork/join work of Map::Update (collected object
+ * pulls, update data building, instance updates of a MapInstanced).
+ * The thread count is fixed at start, no matter how many instances are open.
+ */
+class TC_GAME_API MapTaskExecutor
+{
+    friend class MapTaskGroup;
+
+    struct Task
+    {
+        MapTaskGroup* group;
+        std::function<void()> work;
+    };
+
+    MapTaskExecutor();
+    ~MapTaskExecutor();
+
+public:
+    MapTaskExecutor(MapTaskExecutor const&) = delete;
+    MapTaskExecutor& operator=(MapTaskExecutor const&) = delete;
+
+    static MapTaskExecutor* instance();
+
+    // usedCores threads already run map ticks, the executor only takes the hardware threads left over
+    // (numThreads == 0 takes all of them) and pins its workers to those cores only
+    void Start(std::size_t numThreads, bool pinThreads, std::size_t usedCores);
+    void Stop();
+
+    std::size_t GetWorkerCount() const { return _threads.size(); }
+    std::size_t GetQueueSize();
+
+private:
+    void Submit(MapTaskGroup* group, std::function<void()>&& work);
+    void WaitGroup(MapTaskGroup* group);
+
+    void WorkerThread(std::size_t core, bool pin);
+    void Run(Task& task);
+
+    std::vector<std::thread> _threads;
+
+    std::mutex _lock;
+    std::condition_variable _cond;
+    std::deque<Task> _queue;
+
+    bool _stopping;
+};
+
+/*
+ * Fork/join barrier of one map on the shared executor, replaces the per map
+ * ThreadPoolMap. wait() runs the queued tasks of this group itself and then
+ * blocks until the ones taken by workers are done, so a group may be joined
+ * from inside another executor task (nested instance updates) without
+ * starving the pool or picking up the work of other maps.
+ */
+class TC_GAME_API MapTaskGroup
+{
+    friend class MapTaskExecutor;
+
+public:
+    MapTaskGroup() : _pending(0) { }
+    ~MapTaskGroup() { wait(); }
+
+    MapTaskGroup(MapTaskGroup const&) = delete;
+    MapTaskGroup& operator=(MapTaskGroup const&) = delete;
+
+    template <typename RequestType>
+    void schedule(RequestType request)
+    {
+        ++_pending;
+        MapTaskExecutor::instance()->Submit(this, std::function<void()>(std::move(request)));
+    }
+
+    void wait() { MapTaskExecutor::instance()->WaitGroup(this); }
+
+    bool IsIdle() const { return _pending == 0; }
+
+private:
+    std::atomic<uint32> _pending;
+    std::condition_variable _done;          // signalled under the executor lock when _pending drops to 0
+};
+
+#define sMapTaskExecutor MapTaskExecutor::instance()
+
+#endif
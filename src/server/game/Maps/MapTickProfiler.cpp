@@ -0,0 +1,205 @@
+/*
+ * Copyright (C) 2008-2017 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MapTickProfiler.h"
+#include "Object.h"
+#include "StringFormat.h"
+#include "Util.h"
+#include "World.h"
+
+#include <algorithm>
+#include <cstdio>
+
+std::atomic<uint32> MapTickProfiler::_requestedGeneration(0);
+std::mutex MapTickProfiler::_reportsLock;
+std::string MapTickProfiler::_reports;
+
+MapTickProfiler::MapTickProfiler() : _slowObjects(), _slowObjectCount(0), _windowStart(std::chrono::steady_clock::now()), _reportGeneration(_requestedGeneration)
+{
+}
+
+bool MapTickProfiler::IsEnabled()
+{
+    return sWorld->getBoolConfig(CONFIG_MAP_PROFILER);
+}
+
+void MapTickProfiler::RecordObject(WorldObject const* object, uint32 us)
+{
+    if (us < sWorld->getIntConfig(CONFIG_MAP_PROFILER_SLOW_OBJECT))
+        return;
+
+    uint32 typeId = object->GetTypeId();
+    uint32 entry = object->GetEntry();
+    uint64 guidLow = object->GetGUIDLow();
+
+    std::lock_guard<std::mutex> guard(_slowObjectsLock);
+
+    // players have no useful entry, they are told apart by guid
+    for (uint32 i = 0; i < _slowObjectCount; ++i)
+    {
+        SlowObject& slow = _slowObjects[i];
+        if (slow.typeId != typeId || slow.entry != entry || (typeId == TYPEID_PLAYER && slow.guidLow != guidLow))
+            continue;
+
+        ++slow.count;
+        if (us > slow.maxTime)
+        {
+            slow.maxTime = us;
+            slow.guidLow = guidLow;
+        }
+        return;
+    }
+
+    SlowObject* slot = nullptr;
+    if (_slowObjectCount < SLOW_OBJECT_SLOTS)
+        slot = &_slowObjects[_slowObjectCount++];
+    else
+    {
+        slot = &*std::min_element(_slowObjects.begin(), _slowObjects.end(), [](SlowObject const& left, SlowObject const& right)
+        {
+            return left.maxTime < right.maxTime;
+        });
+
+        if (slot->maxTime >= us)
+            return;
+    }
+
+    slot->typeId = typeId;
+    slot->entry = entry;
+    slot->guidLow = guidLow;
+    slot->maxTime = us;
+    slot->count = 1;
+}
+
+void MapTickProfiler::Reset()
+{
+    for (Trinity::LatencyHistogram& phase : _phases)
+        phase.Reset();
+
+    {
+        std::lock_guard<std::mutex> guard(_slowObjectsLock);
+        _slowObjectCount = 0;
+    }
+
+    _windowStart.store(std::chrono::steady_clock::now());
+}
+
+std::vector<MapTickProfiler::SlowObject> MapTickProfiler::GetSlowObjects() const
+{
+    std::vector<SlowObject> slowObjects;
+    {
+        std::lock_guard<std::mutex> guard(_slowObjectsLock);
+        slowObjects.assign(_slowObjects.begin(), _slowObjects.begin() + _slowObjectCount);
+    }
+
+    std::sort(slowObjects.begin(), slowObjects.end(), [](SlowObject const& left, SlowObject const& right)
+    {
+        return left.maxTime > right.maxTime;
+    });
+
+    return slowObjects;
+}
+
+uint32 MapTickProfiler::GetWindowSeconds() const
+{
+    return uint32(std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - _windowStart.load()).count());
+}
+
+void MapTickProfiler::BuildReport(std::vector<std::string>& lines) const
+{
+    for (uint8 i = 0; i < MAX_MAP_TICK_PHASES; ++i)
+    {
+        Trinity::LatencyHistogram const& phase = _phases[i];
+        if (!phase.GetCount())
+            continue;
+
+        lines.push_back(Trinity::StringFormat("  %-11s n %8u mean %7u p50 %7u p90 %7u p99 %7u max %7u us",
+            GetPhaseName(MapTickPhase(i)), uint32(phase.GetCount()), phase.GetMean(), phase.GetPercentile(50.0), phase.GetPercentile(90.0), phase.GetPercentile(99.0), phase.GetMax()));
+    }
+
+    for (SlowObject const& slow : GetSlowObjects())
+        lines.push_back(Trinity::StringFormat("  slow object type %u entry %u guid " UI64FMTD " max %u us (%u times)", slow.typeId, slow.entry, slow.guidLow, slow.maxTime, slow.count));
+}
+
+void MapTickProfiler::ReportIfRequested(uint32 mapId, uint32 instanceId)
+{
+    uint32 requested = _requestedGeneration.load(std::memory_order_relaxed);
+    if (requested == _reportGeneration)
+        return;
+
+    _reportGeneration = requested;
+
+    if (_phases[MAP_TICK_PHASE_TOTAL].GetCount())
+    {
+        std::vector<std::string> lines;
+        BuildReport(lines);
+
+        std::string report = Trinity::StringFormat("map %u instance %u window %us\n", mapId, instanceId, GetWindowSeconds());
+        for (std::string const& line : lines)
+        {
+            report += line;
+            report += '\n';
+        }
+
+        std::lock_guard<std::mutex> guard(_reportsLock);
+        _reports += report;
+    }
+
+    Reset();
+}
+
+char const* MapTickProfiler::GetPhaseName(MapTickPhase phase)
+{
+    switch (phase)
+    {
+        case MAP_TICK_PHASE_SESSIONS:       return "sessions";
+        case MAP_TICK_PHASE_PLAYERS:        return "players";
+        case MAP_TICK_PHASE_COLLECTED:      return "collected";
+        case MAP_TICK_PHASE_SCRIPTS:        return "scripts";
+        case MAP_TICK_PHASE_MOVE_LISTS:     return "move lists";
+        case MAP_TICK_PHASE_UPDATE_DATA:    return "update data";
+        case MAP_TICK_PHASE_SCENARIOS:      return "scenarios";
+        case MAP_TICK_PHASE_TRANSPORTS:     return "transports";
+        case MAP_TICK_PHASE_TOTAL:          return "total";
+        default:                            return "unknown";
+    }
+}
+
+void MapTickProfiler::RequestReports()
+{
+    ++_requestedGeneration;
+}
+
+bool MapTickProfiler::FlushReports(std::string const& fileName)
+{
+    std::string reports;
+    {
+        std::lock_guard<std::mutex> guard(_reportsLock);
+        reports.swap(_reports);
+    }
+
+    if (reports.empty())
+        return true;
+
+    FILE* file = fopen(fileName.c_str(), "a");
+    if (!file)
+        return false;
+
+    fprintf(file, "=== %s\n%s", TimeToTimestampStr(time(nullptr)).c_str(), reports.c_str());
+    fclose(file);
+    return true;
+}
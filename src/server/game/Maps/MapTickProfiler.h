@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2008-2017 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRINITY_MAP_TICK_PROFILER_H
+#define TRINITY_MAP_TICK_PROFILER_H
+
+#include "Define.h"
+#include "LatencyHistogram.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class WorldObject;
+
+enum MapTickPhase : uint8
+{
+    MAP_TICK_PHASE_SESSIONS,
+    MAP_TICK_PHASE_PLAYERS,
+    MAP_TICK_PHASE_COLLECTED,
+    MAP_TICK_PHASE_SCRIPTS,
+    MAP_TICK_PHASE_MOVE_LISTS,
+    MAP_TICK_PHASE_UPDATE_DATA,
+    MAP_TICK_PHASE_SCENARIOS,
+    MAP_TICK_PHASE_TRANSPORTS,
+    MAP_TICK_PHASE_TOTAL,                       // whole Map::Update
+
+    MAX_MAP_TICK_PHASES
+};
+
+/*
+ * Per map (and per instance) timings of the update phases, in microseconds.
+ *
+ * Phases go into lock-free histograms, so the parallel object
+ * batches record without contention. Single object updates above
+ * MapUpdate.Profiler.SlowObject are kept as a small top list by entry
+ * (players by guid), which only takes a lock on that slow path.
+ *
+ * Reports are pulled by the map itself: RequestReports() bumps a generation,
+ * every map that sees it at its next update appends its report and starts a
+ * new window. Nothing outside the map thread ever walks the map list.
+ */
+class TC_GAME_API MapTickProfiler
+{
+public:
+    static uint32 const SLOW_OBJECT_SLOTS = 10;
+
+    struct SlowObject
+    {
+        uint32 typeId;
+        uint32 entry;
+        uint64 guidLow;
+        uint32 maxTime;                         // us
+        uint32 count;
+    };
+
+    MapTickProfiler();
+
+    MapTickProfiler(MapTickProfiler const&) = delete;
+    MapTickProfiler& operator=(MapTickProfiler const&) = delete;
+
+    static bool IsEnabled();
+
+    void RecordPhase(MapTickPhase phase, uint32 us) { _phases[phase].Record(us); }
+    void RecordObject(WorldObject const* object, uint32 us);
+
+    void Reset();
+
+    Trinity::LatencyHistogram const& GetPhase(MapTickPhase phase) const { return _phases[phase]; }
+    std::vector<SlowObject> GetSlowObjects() const;
+    uint32 GetWindowSeconds() const;
+
+    /// One line per phase with samples, then the slow objects
+    void BuildReport(std::vector<std::string>& lines) const;
+
+    /// Called at the start of Map::Update, appends the report and resets once per requested generation
+    void ReportIfRequested(uint32 mapId, uint32 instanceId);
+
+    static char const* GetPhaseName(MapTickPhase phase);
+
+    static void RequestReports();
+    /// Writes what the maps reported since the last flush, returns false if the file can't be opened
+    static bool FlushReports(std::string const& fileName);
+
+private:
+    std::array<Trinity::LatencyHistogram, MAX_MAP_TICK_PHASES> _phases;
+
+    mutable std::mutex _slowObjectsLock;
+    std::array<SlowObject, SLOW_OBJECT_SLOTS> _slowObjects;
+    uint32 _slowObjectCount;
+
+    std::atomic<std::chrono::steady_clock::time_point> _windowStart;   // reset from .server profile reset on the command thread
+    uint32 _reportGeneration;
+
+    static std::atomic<uint32> _requestedGeneration;
+    static std::mutex _reportsLock;
+    static std::string _reports;
+};
+
+/// Records the lifetime of the scope into a phase, does nothing while the profiler is disabled
+class MapTickPhaseTimer
+{
+public:
+    MapTickPhaseTimer(MapTickProfiler& profiler, MapTickPhase phase) : _profiler(profiler), _phase(phase), _enabled(MapTickProfiler::IsEnabled())
+    {
+        if (_enabled)
+            _start = std::chrono::steady_clock::now();
+    }
+
+    ~MapTickPhaseTimer()
+    {
+        if (_enabled)
+            _profiler.RecordPhase(_phase, uint32(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - _start).count()));
+    }
+
+    MapTickPhaseTimer(MapTickPhaseTimer const&) = delete;
+    MapTickPhaseTimer& operator=(MapTickPhaseTimer const&) = delete;
+
+private:
+    MapTickProfiler& _profiler;
+    MapTickPhase _phase;
+    bool _enabled;
+    std::chrono::steady_clock::time_point _start;
+};
+
+#endif
@@ -0,0 +1,243 @@
+/*
+ * Copyright (C) 2008-2017 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MapUpdatePartition.h"
+#include "GridDefines.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <unordered_map>
+
+namespace
+{
+    uint32 const MAX_SPLIT_LEVEL        = 2;                // tile = pull / 4
+    uint32 const SPLIT_MIN_COST         = 2000;             // microseconds per tick below which one worker is enough
+    uint32 const SPLIT_VOTE_TICKS       = 20;               // same verdict in a row before the layout changes
+    uint32 const SPLIT_BACKOFF_TICKS    = 600;              // no new split after one that did not pay off
+    uint32 const UNKNOWN_OBJECT_COST    = 4;                // microseconds per object for a tile without history
+
+    uint32 GetColorsPerAxis(uint32 pullCellSize, uint32 tileSize)
+    {
+        return (pullCellSize + tileSize - 1) / tileSize + 1;
+    }
+}
+
+MapUpdatePartition::MapUpdatePartition() : _pullCellSize(0), _level(0), _pendingLevel(0), _tileSize(0), _colors(2), _tilesPerRow(0),
+    _tileCount(0), _vote(0), _backoff(0)
+{
+}
+
+void MapUpdatePartition::BeginTick(uint32 pullCellSize)
+{
+    ClearTiles();
+
+    pullCellSize = std::max<uint32>(1, pullCellSize);
+    if (pullCellSize != _pullCellSize)
+        ApplyLayout(pullCellSize, 0);
+    else if (_pendingLevel != _level)
+        ApplyLayout(pullCellSize, _pendingLevel);
+}
+
+void MapUpdatePartition::ApplyLayout(uint32 pullCellSize, uint32 level)
+{
+    _pullCellSize = pullCellSize;
+    _level = std::min(level, GetMaxLevel());
+    _pendingLevel = _level;
+    _tileSize = GetTileSize(_level);
+    _colors = GetColorsPerAxis(_pullCellSize, _tileSize);
+    _tilesPerRow = (TOTAL_NUMBER_OF_CELLS_PER_MAP + _tileSize - 1) / _tileSize;
+    _tileSlot.assign(_tilesPerRow * _tilesPerRow, 0);
+    _predictedCost.assign(_tilesPerRow * _tilesPerRow, 0);
+    _vote = 0;
+}
+
+void MapUpdatePartition::ClearTiles()
+{
+    for (uint32 i = 0; i < _tileCount; ++i)
+    {
+        _tileSlot[_tiles[i].TileId] = 0;
+        _tiles[i].Objects.clear();                          // keeps capacity for the next tick
+        _tiles[i].Cost = 0;
+    }
+    _tileCount = 0;
+}
+
+uint32 MapUpdatePartition::GetTileSize(uint32 level) const
+{
+    return std::max<uint32>(1, _pullCellSize >> level);
+}
+
+uint32 MapUpdatePartition::GetMaxLevel() const
+{
+    uint32 level = 0;
+    while (level < MAX_SPLIT_LEVEL && (_pullCellSize >> (level + 1)) > 0)
+        ++level;
+    return level;
+}
+
+std::vector<WorldObject*>& MapUpdatePartition::GetTileObjects(uint32 cellX, uint32 cellY)
+{
+    uint32 tileId = GetTileId(cellX, cellY);
+
+    uint32& slot = _tileSlot[tileId];
+    if (!slot)
+    {
+        if (_tileCount == _tiles.size())
+            _tiles.emplace_back();
+
+        Tile& tile = _tiles[_tileCount];
+        tile.TileId = tileId;
+        tile.Color = GetTileColor(tileId);
+        slot = ++_tileCount;
+    }
+
+    return _tiles[slot - 1].Objects;
+}
+
+void MapUpdatePartition::BuildBatches(uint32 color, uint32 maxBatches, std::vector<Batch>& batches)
+{
+    for (Batch& batch : batches)
+        batch.clear();
+
+    std::vector<std::pair<uint32, Tile*>> tiles;
+    for (uint32 i = 0; i < _tileCount; ++i)
+    {
+        Tile& tile = _tiles[i];
+        if (tile.Color != color || tile.Objects.empty())
+            continue;
+
+        uint32 predicted = _predictedCost[tile.TileId];
+        if (!predicted)
+            predicted = uint32(tile.Objects.size()) * UNKNOWN_OBJECT_COST;
+        tiles.emplace_back(predicted, &tile);
+    }
+
+    if (tiles.empty())
+        return;
+
+    // longest processing time first: every tile goes to the currently lightest batch
+    std::sort(tiles.begin(), tiles.end(), [](std::pair<uint32, Tile*> const& left, std::pair<uint32, Tile*> const& right)
+    {
+        return left.first > right.first;
+    });
+
+    uint32 batchCount = std::min<uint32>(std::max<uint32>(1, maxBatches), uint32(tiles.size()));
+    if (batches.size() < batchCount)
+        batches.resize(batchCount);
+
+    std::vector<uint32> load(batchCount, 0);
+    for (auto const& tile : tiles)
+    {
+        uint32 lightest = uint32(std::min_element(load.begin(), load.end()) - load.begin());
+        load[lightest] += tile.first;
+        batches[lightest].push_back(tile.second);
+    }
+}
+
+uint32 MapUpdatePartition::CalculateCriticalPath(uint32 tileSize, uint32 workers, uint32& totalCost) const
+{
+    uint32 colors = GetColorsPerAxis(_pullCellSize, tileSize);
+    uint32 tilesPerRow = (TOTAL_NUMBER_OF_CELLS_PER_MAP + tileSize - 1) / tileSize;
+
+    // cost of the live tiles folded into tiles of tileSize, keyed by their center cell
+    std::unordered_map<uint32, uint32> costs;
+    for (uint32 i = 0; i < _tileCount; ++i)
+    {
+        Tile const& tile = _tiles[i];
+        uint32 cellX = (tile.TileId % _tilesPerRow) * _tileSize + _tileSize / 2;
+        uint32 cellY = (tile.TileId / _tilesPerRow) * _tileSize + _tileSize / 2;
+        costs[(cellY / tileSize) * tilesPerRow + cellX / tileSize] += tile.Cost;
+    }
+
+    std::vector<uint32> colorSum(colors * colors, 0);
+    std::vector<uint32> colorMax(colors * colors, 0);
+    totalCost = 0;
+    for (auto const& itr : costs)
+    {
+        uint32 color = ((itr.first / tilesPerRow) % colors) * colors + (itr.first % tilesPerRow) % colors;
+        colorSum[color] += itr.second;
+        colorMax[color] = std::max(colorMax[color], itr.second);
+        totalCost += itr.second;
+    }
+
+    uint32 critical = 0;
+    for (uint32 color = 0; color < colors * colors; ++color)
+        critical += std::max(colorMax[color], (colorSum[color] + workers - 1) / workers);
+
+    return critical;
+}
+
+bool MapUpdatePartition::EndTick(uint32 workers)
+{
+    workers = std::max<uint32>(1, workers);
+
+    _tileCosts.clear();
+    _stats = Stats();
+    for (uint32 i = 0; i < _tileCount; ++i)
+    {
+        Tile const& tile = _tiles[i];
+        if (tile.Objects.empty())
+            continue;
+
+        uint32& predicted = _predictedCost[tile.TileId];
+        predicted = predicted ? (predicted * 3 + tile.Cost) / 4 : std::max<uint32>(1, tile.Cost);
+
+        _tileCosts.emplace_back(tile.TileId, tile.Cost);
+        if (tile.Cost >= _stats.HotTileCost)
+        {
+            _stats.HotTileId = tile.TileId;
+            _stats.HotTileCost = tile.Cost;
+        }
+    }
+
+    _stats.SplitLevel = _level;
+    _stats.TileSize = _tileSize;
+    _stats.ColorCount = _colors * _colors;
+    _stats.TileCount = uint32(_tileCosts.size());
+    _stats.CriticalPathCost = CalculateCriticalPath(_tileSize, workers, _stats.TotalCost);
+
+    if (_backoff)
+        --_backoff;
+
+    int32 verdict = 0;
+    uint32 ideal = (_stats.TotalCost + workers - 1) / workers;
+    if (workers > 1 && !_backoff && _level < GetMaxLevel() && _stats.TotalCost >= SPLIT_MIN_COST && _stats.CriticalPathCost >= ideal * 2)
+        verdict = 1;
+    else if (_level > 0)
+    {
+        uint32 coarserTotal = 0;
+        uint32 coarser = CalculateCriticalPath(GetTileSize(_level - 1), workers, coarserTotal);
+        if (workers <= 1 || _stats.TotalCost < SPLIT_MIN_COST / 2 || coarser <= _stats.CriticalPathCost + _stats.CriticalPathCost / 8)
+            verdict = -1;
+    }
+
+    if (!verdict || (verdict > 0) != (_vote > 0))
+        _vote = verdict;
+    else
+        _vote += verdict;
+
+    if (uint32(std::abs(_vote)) < SPLIT_VOTE_TICKS)
+        return false;
+
+    // merging back right after a split means the hot spot is one tile at any size
+    if (_vote < 0 && _stats.TotalCost >= SPLIT_MIN_COST / 2)
+        _backoff = SPLIT_BACKOFF_TICKS;
+
+    _pendingLevel = _vote > 0 ? _level + 1 : _level - 1;
+    _vote = 0;
+    return true;
+}
@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2008-2017 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRINITY_MAP_UPDATE_PARTITION_H
+#define TRINITY_MAP_UPDATE_PARTITION_H
+
+#include "Define.h"
+
+#include <vector>
+
+class WorldObject;
+
+/*
+ * Splits the objects collected by Map::VisitNearbyCellsOf into square tiles
+ * that are updated in parallel.
+ *
+ * SizeCellForPull (S) is the minimal distance in cells between two tiles that
+ * may update at the same time. With tiles of T cells and a k x k coloring,
+ * two tiles of one color are at least (k - 1) * T cells apart, so every split
+ * level uses k = ceil(S / T) + 1 and runs its colors one after another:
+ *   level 0: T = S,     2 x 2 colors (the old fixed pull layout)
+ *   level 1: T = S / 2, 3 x 3 colors
+ *   level 2: T = S / 4, 5 x 5 colors
+ *
+ * Tiles of one color are dealt to the workers by their predicted cost, and the
+ * measured cost of every tile picks the split level for the next ticks: a
+ * tile that dominates its color splits the map finer, a finer layout that
+ * would not beat the coarser one merges back.
+ */
+class TC_GAME_API MapUpdatePartition
+{
+public:
+    struct Tile
+    {
+        uint32 TileId = 0;
+        uint32 Color = 0;
+        uint32 Cost = 0;                                    // microseconds spent this tick
+        std::vector<WorldObject*> Objects;
+    };
+
+    typedef std::vector<Tile*> Batch;
+
+    struct Stats
+    {
+        uint32 SplitLevel = 0;
+        uint32 TileSize = 0;                                // in cells
+        uint32 ColorCount = 0;
+        uint32 TileCount = 0;
+        uint32 HotTileId = 0;
+        uint32 HotTileCost = 0;                             // microseconds
+        uint32 TotalCost = 0;                               // sum of all tiles, microseconds
+        uint32 CriticalPathCost = 0;                        // expected wall time of the colors with the given workers
+    };
+
+    MapUpdatePartition();
+
+    // drops leftovers of an aborted tick and applies a pending split level change
+    void BeginTick(uint32 pullCellSize);
+
+    std::vector<WorldObject*>& GetTileObjects(uint32 cellX, uint32 cellY);
+
+    uint32 GetTileId(uint32 cellX, uint32 cellY) const { return (cellY / _tileSize) * _tilesPerRow + cellX / _tileSize; }
+    uint32 GetTileColor(uint32 tileId) const { return ((tileId / _tilesPerRow) % _colors) * _colors + (tileId % _tilesPerRow) % _colors; }
+    uint32 GetColorCount() const { return _colors * _colors; }
+
+    // tiles of one color as at most maxBatches lists of close predicted cost, most expensive list first
+    void BuildBatches(uint32 color, uint32 maxBatches, std::vector<Batch>& batches);
+
+    // returns true when the split level changes from next tick on
+    bool EndTick(uint32 workers);
+
+    Stats const& GetStats() const { return _stats; }
+    // (tileId, microseconds) of every tile of the last finished tick
+    std::vector<std::pair<uint32, uint32>> const& GetTileCosts() const { return _tileCosts; }
+    uint32 GetPendingSplitLevel() const { return _pendingLevel; }
+
+private:
+    void ApplyLayout(uint32 pullCellSize, uint32 level);
+    void ClearTiles();
+
+    uint32 GetTileSize(uint32 level) const;
+    uint32 GetMaxLevel() const;
+    uint32 CalculateCriticalPath(uint32 tileSize, uint32 workers, uint32& totalCost) const;
+
+    uint32 _pullCellSize;
+    uint32 _level;
+    uint32 _pendingLevel;
+    uint32 _tileSize;
+    uint32 _colors;
+    uint32 _tilesPerRow;
+
+    std::vector<Tile> _tiles;                               // reused between ticks, only the first _tileCount are live
+    uint32 _tileCount;
+    std::vector<uint32> _tileSlot;                          // tileId -> live tile index + 1
+    std::vector<uint32> _predictedCost;                     // tileId -> smoothed microseconds
+
+    int32 _vote;                                            // > 0 ticks in a row asking for finer tiles, < 0 for coarser
+    uint32 _backoff;                                        // ticks left before another split is tried
+
+    Stats _stats;
+    std::vector<std::pair<uint32, uint32>> _tileCosts;
+};
+
+#endif
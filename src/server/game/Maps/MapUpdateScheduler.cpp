@@ -0,0 +1,336 @@
+/*
+ * Copyright (C) 2008-2017 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MapUpdateScheduler.h"
+#include "Log.h"
+#include "Map.h"
+
+#include <algorithm>
+
+#ifdef _WIN32
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+MapUpdateScheduler::MapUpdateScheduler() : _stopping(false), _taskCount(0), _stealCount(0), _parkedCount(0), _wakeCount(0)
+{
+}
+
+MapUpdateScheduler::~MapUpdateScheduler()
+{
+    Stop();
+}
+
+MapUpdateScheduler* MapUpdateScheduler::instance()
+{
+    static MapUpdateScheduler instance;
+    return &instance;
+}
+
+void MapUpdateScheduler::Start(std::size_t numThreads, bool pinThreads)
+{
+    if (!_workers.empty())
+        return;
+
+    if (!numThreads)
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+
+    _stopping = false;
+
+    _workers.reserve(numThreads);
+    for (std::size_t i = 0; i < numThreads; ++i)
+        _workers.emplace_back(new Worker());
+
+    // threads are started only after every deque exists, Steal() walks all of them
+    for (std::size_t i = 0; i < numThreads; ++i)
+        _workers[i]->thread = std::thread(&MapUpdateScheduler::WorkerThread, this, i, pinThreads);
+
+    TC_LOG_INFO("server.loading", "Map update scheduler started with %u workers%s", uint32(numThreads), pinThreads ? " (pinned)" : "");
+}
+
+void MapUpdateScheduler::Stop()
+{
+    {
+        std::lock_guard<std::mutex> guard(_timerLock);
+        if (_stopping)
+            return;
+        _stopping = true;
+    }
+    _timerCond.notify_all();
+
+    for (auto& worker : _workers)
+        if (worker->thread.joinable())
+            worker->thread.join();
+
+    _workers.clear();
+
+    // tasks are owned by _tasks, deques and timer entries only point at them
+    std::lock_guard<std::mutex> guard(_timerLock);
+    for (auto& task : _tasks)
+        task->map->SetTickTask(nullptr);
+    _tasks.clear();
+    _timers = TimerQueue();
+
+    _taskCount = 0;
+    _parkedCount = 0;
+}
+
+void MapUpdateScheduler::Schedule(Map* map, uint32 mapId)
+{
+    ++_taskCount;
+
+    TickTask* task = new TickTask(map, mapId);
+    map->SetTickTask(task);
+
+    {
+        std::lock_guard<std::mutex> guard(_timerLock);
+        _tasks.emplace_back(task);
+        PushTimerLocked(task);
+    }
+    _timerCond.notify_one();
+}
+
+void MapUpdateScheduler::Wake(TickTask* task)
+{
+    // already flagged, the pending run covers this wake as well
+    if (task->wake.exchange(true))
+        return;
+
+    ++_wakeCount;
+
+    {
+        std::lock_guard<std::mutex> guard(_timerLock);
+        if (_stopping)
+            return;
+
+        switch (task->state)
+        {
+            case TickTask::TICK_PARKED:
+                --_parkedCount;
+                // no break
+            case TickTask::TICK_SLEEPING:
+                task->due = std::chrono::steady_clock::now();
+                PushTimerLocked(task);
+                break;
+            default:
+                // ready or running, RunTask sees the flag after the tick; dropped tasks never run again
+                return;
+        }
+    }
+    _timerCond.notify_one();
+}
+
+void MapUpdateScheduler::PinCurrentThread(std::size_t core)
+{
+    uint32 cores = std::max(1u, std::thread::hardware_concurrency());
+#ifdef _WIN32
+    SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << (core % cores));
+#elif defined(__linux__)
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    CPU_SET(core % cores, &mask);
+    if (pthread_setaffinity_np(pthread_self(), sizeof(mask), &mask))
+        TC_LOG_ERROR("maps", "Can't pin map worker thread to core %u", uint32(core % cores));
+#endif
+}
+
+void MapUpdateScheduler::WorkerThread(std::size_t index, bool pin)
+{
+    if (pin)
+        PinCurrentThread(index);
+
+    while (!_stopping)
+    {
+        TickTask* task = PopLocal(index);
+        if (!task)
+            task = Steal(index);
+        if (!task)
+            task = WaitForDue(index);
+
+        if (task)
+            RunTask(index, task);
+    }
+}
+
+MapUpdateScheduler::TickTask* MapUpdateScheduler::PopLocal(std::size_t index)
+{
+    Worker& worker = *_workers[index];
+    std::lock_guard<std::mutex> guard(worker.lock);
+    if (worker.ready.empty())
+        return nullptr;
+
+    TickTask* task = worker.ready.front();
+    worker.ready.pop_front();
+    return task;
+}
+
+MapUpdateScheduler::TickTask* MapUpdateScheduler::Steal(std::size_t index)
+{
+    std::size_t count = _workers.size();
+    for (std::size_t i = 1; i < count; ++i)
+    {
+        Worker& victim = *_workers[(index + i) % count];
+        std::lock_guard<std::mutex> guard(victim.lock);
+        if (victim.ready.empty())
+            continue;
+
+        TickTask* task = victim.ready.back();
+        victim.ready.pop_back();
+        ++_stealCount;
+        return task;
+    }
+
+    return nullptr;
+}
+
+MapUpdateScheduler::TickTask* MapUpdateScheduler::WaitForDue(std::size_t index)
+{
+    std::unique_lock<std::mutex> guard(_timerLock);
+
+    if (_stopping)
+        return nullptr;
+
+    // entries of tasks that were woken or rescheduled since they were pushed
+    while (!_timers.empty() && _timers.top().generation != _timers.top().task->generation)
+        _timers.pop();
+
+    // bounded wait, a task pushed to a ready deque notifies without holding the timer lock
+    if (_timers.empty())
+    {
+        _timerCond.wait_for(guard, Milliseconds(50));
+        return nullptr;
+    }
+
+    TimePoint now = std::chrono::steady_clock::now();
+    if (_timers.top().due > now)
+    {
+        _timerCond.wait_until(guard, _timers.top().due);
+        return nullptr;
+    }
+
+    TickTask* task = _timers.top().task;
+    task->state = TickTask::TICK_RUNNING;
+    _timers.pop();
+
+    // everything else that is already due goes to our deque, where idle workers can steal it
+    bool moved = false;
+    while (!_timers.empty() && _timers.top().due <= now)
+    {
+        TimerEntry entry = _timers.top();
+        _timers.pop();
+        if (entry.generation != entry.task->generation)
+            continue;
+
+        entry.task->state = TickTask::TICK_READY;
+        PushLocal(index, entry.task);
+        moved = true;
+    }
+
+    guard.unlock();
+
+    if (moved)
+        _timerCond.notify_all();
+
+    return task;
+}
+
+void MapUpdateScheduler::PushLocal(std::size_t index, TickTask* task)
+{
+    Worker& worker = *_workers[index];
+    std::lock_guard<std::mutex> guard(worker.lock);
+    worker.ready.push_back(task);
+}
+
+void MapUpdateScheduler::PushTimer(TickTask* task)
+{
+    {
+        std::lock_guard<std::mutex> guard(_timerLock);
+        PushTimerLocked(task);
+    }
+    _timerCond.notify_one();
+}
+
+void MapUpdateScheduler::PushTimerLocked(TickTask* task)
+{
+    task->state = TickTask::TICK_SLEEPING;
+    _timers.push({ task->due, ++task->generation, task });
+}
+
+void MapUpdateScheduler::DropTask(TickTask* task)
+{
+    --_taskCount;
+
+    std::lock_guard<std::mutex> guard(_timerLock);
+    task->map->SetTickTask(nullptr);
+    // stale timer entries may still point at the task, none of them matches generation 0
+    task->generation = 0;
+    task->state = TickTask::TICK_DROPPED;
+}
+
+void MapUpdateScheduler::RunTask(std::size_t index, TickTask* task)
+{
+    if (task->map->IsMapStop())
+    {
+        DropTask(task);
+        return;
+    }
+
+    TimePoint started = std::chrono::steady_clock::now();
+    if (started > task->due)
+        task->map->RecordTickJitter(uint32(std::chrono::duration_cast<std::chrono::microseconds>(started - task->due).count()));
+
+    task->wake = false;
+
+    uint32 wait = task->map->UpdateTick(task->mapId);
+
+    if (task->map->IsMapStop())
+    {
+        DropTask(task);
+        return;
+    }
+
+    TimePoint now = std::chrono::steady_clock::now();
+
+    {
+        std::lock_guard<std::mutex> guard(_timerLock);
+
+        // woken while running, whatever arrived is handled by the next tick right away
+        if (task->wake)
+            wait = 0;
+
+        if (wait == PARK)
+        {
+            task->state = TickTask::TICK_PARKED;
+            ++_parkedCount;
+            return;
+        }
+
+        task->due = now + Milliseconds(wait);
+
+        // a map that is already late stays hot on this core, the rest sleeps in the timer queue
+        if (wait)
+            PushTimerLocked(task);
+        else
+            task->state = TickTask::TICK_READY;
+    }
+
+    if (!wait)
+        PushLocal(index, task);
+    _timerCond.notify_one();
+}
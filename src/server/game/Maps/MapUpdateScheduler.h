@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2008-2017 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRINITY_MAP_UPDATE_SCHEDULER_H
+#define TRINITY_MAP_UPDATE_SCHEDULER_H
+
+#include "Define.h"
+#include "Duration.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+class Map;
+
+/// Scheduler side state of one map, handed to the map so it can wake itself up
+struct MapTickTask
+{
+    enum State : uint8
+    {
+        TICK_SLEEPING,                  // waiting in the timer queue for its deadline
+        TICK_READY,                     // in a worker deque
+        TICK_RUNNING,                   // inside Map::UpdateTick
+        TICK_PARKED,                    // idle map, no deadline, runs again only when woken
+        TICK_DROPPED                    // map stopped, kept until Stop() so late wakes stay harmless
+    };
+
+    MapTickTask(Map* map, uint32 mapId) : map(map), mapId(mapId), due(std::chrono::steady_clock::now()), state(TICK_SLEEPING), generation(0), wake(false) { }
+
+    Map* map;
+    uint32 mapId;
+    TimePoint due;
+    State state;                        // guarded by the timer lock
+    uint32 generation;                  // timer entries of older generations are stale
+    std::atomic<bool> wake;
+};
+
+/*
+ * Fixed size pool that drives Map::UpdateTick for every base map and zone map.
+ *
+ * Every map is a single tick task, so a map is never updated by two workers at
+ * once. A task that is due goes to the deque of the worker that picked it up;
+ * idle workers steal from the back of other deques, so a hot continent keeps
+ * running while empty maps only cost a heap entry until their next deadline.
+ * Maps with nothing to do park without a deadline and are woken by Wake()
+ * (player arrival, queued packets), which also cuts a pending sleep short.
+ */
+class TC_GAME_API MapUpdateScheduler
+{
+    typedef MapTickTask TickTask;
+
+    struct TimerEntry
+    {
+        TimePoint due;
+        uint32 generation;
+        TickTask* task;
+    };
+
+    struct TimerEntryCompare
+    {
+        bool operator()(TimerEntry const& left, TimerEntry const& right) const { return left.due > right.due; }
+    };
+
+    struct Worker
+    {
+        std::mutex lock;
+        std::deque<TickTask*> ready;
+        std::thread thread;
+    };
+
+    typedef std::priority_queue<TimerEntry, std::vector<TimerEntry>, TimerEntryCompare> TimerQueue;
+
+    MapUpdateScheduler();
+    ~MapUpdateScheduler();
+
+public:
+    MapUpdateScheduler(MapUpdateScheduler const&) = delete;
+    MapUpdateScheduler& operator=(MapUpdateScheduler const&) = delete;
+
+    static MapUpdateScheduler* instance();
+
+    // numThreads == 0 uses one worker per hardware thread
+    void Start(std::size_t numThreads, bool pinThreads);
+    void Stop();
+
+    // Map must stay alive until it is stopped (Map::SetMapStop) and its task is dropped, or until Stop() returns
+    void Schedule(Map* map, uint32 mapId);
+
+    // Runs the task as soon as a worker is free, safe from any thread. A wake during a tick runs the next one at once.
+    void Wake(TickTask* task);
+
+    // Map::UpdateTick result that parks the task until the next Wake()
+    static constexpr uint32 PARK = 0xFFFFFFFF;
+
+    std::size_t GetWorkerCount() const { return _workers.size(); }
+    uint32 GetTaskCount() const { return _taskCount; }
+    uint64 GetStealCount() const { return _stealCount; }
+    uint32 GetParkedCount() const { return _parkedCount; }
+    uint64 GetWakeCount() const { return _wakeCount; }
+
+    static void PinCurrentThread(std::size_t core);
+
+private:
+    void WorkerThread(std::size_t index, bool pin);
+
+    TickTask* PopLocal(std::size_t index);
+    TickTask* Steal(std::size_t index);
+    TickTask* WaitForDue(std::size_t index);
+
+    void PushLocal(std::size_t index, TickTask* task);
+    void PushTimer(TickTask* task);
+    void PushTimerLocked(TickTask* task);
+    void RunTask(std::size_t index, TickTask* task);
+    void DropTask(TickTask* task);
+
+    std::vector<std::unique_ptr<Worker>> _workers;
+    std::vector<std::unique_ptr<TickTask>> _tasks;      // guarded by the timer lock
+
+    std::mutex _timerLock;
+    std::condition_variable _timerCond;
+    TimerQueue _timers;
+
+    std::atomic<bool> _stopping;
+    std::atomic<uint32> _taskCount;
+    std::atomic<uint64> _stealCount;
+    std::atomic<uint32> _parkedCount;
+    std::atomic<uint64> _wakeCount;
+};
+
+#define sMapUpdateScheduler MapUpdateScheduler::instance()
+
+#endif
@@ -102,7 +102,7 @@ typedef std::map<uint32, TransportAnimation> TransportAnimationContainer;
 
 class TC_GAME_API TransportMgr
 {
-        friend uint32 DB2Manager::LoadStores(std::string const&, uint32);
+        friend uint32 DB2Manager::LoadStores(std::string const&, uint32, uint32);
 
     public:
         static TransportMgr* instance();
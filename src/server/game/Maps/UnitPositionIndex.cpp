@@ -0,0 +1,253 @@
+/*
+ * Copyright (C) 2008-2017 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "UnitPositionIndex.h"
+#include "Cell.h"
+#include "Creature.h"
+#include "Map.h"
+#include "ObjectAccessor.h"
+#include "Player.h"
+#include "World.h"
+
+#include <algorithm>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_set>
+
+namespace
+{
+    // fills one packed cell from the world and grid containers of a cell
+    struct UnitPositionPacker
+    {
+        UnitPositionPacker(std::vector<float>& x, std::vector<float>& y, std::vector<float>& z, std::vector<float>& reach,
+            std::vector<uint32>& typeMask, std::vector<ObjectGuid>& guid, std::unordered_map<ObjectGuid, uint32>& slot, float slack)
+            : X(x), Y(y), Z(z), Reach(reach), TypeMask(typeMask), Guid(guid), Slot(slot), Slack(slack), Visited(false) { }
+
+        template <class T>
+        void Pack(std::vector<T*> const& units, uint32 typeMask)
+        {
+            Visited = true;
+            for (T* unit : units)
+            {
+                X.push_back(unit->GetPositionX());
+                Y.push_back(unit->GetPositionY());
+                Z.push_back(unit->GetPositionZ());
+                Reach.push_back(unit->GetObjectSize() + Slack);
+                TypeMask.push_back(typeMask);
+                Slot.emplace(unit->GetGUID(), uint32(Guid.size()));
+                Guid.push_back(unit->GetGUID());
+            }
+        }
+
+        void Visit(PlayerMapType& m) { Pack(m, GRID_MAP_TYPE_MASK_PLAYER); }
+        void Visit(CreatureMapType& m) { Pack(m, GRID_MAP_TYPE_MASK_CREATURE); }
+
+        template <class NotInterested>
+        void Visit(NotInterested&) { Visited = true; }
+
+        std::vector<float>& X;
+        std::vector<float>& Y;
+        std::vector<float>& Z;
+        std::vector<float>& Reach;
+        std::vector<uint32>& TypeMask;
+        std::vector<ObjectGuid>& Guid;
+        std::unordered_map<ObjectGuid, uint32>& Slot;
+        float Slack;
+        bool Visited;                                       // false if the grid objects are not loaded
+    };
+}
+
+UnitPositionIndex::UnitPositionIndex(Map& map) : _map(map), _slack(0.0f), _cellCount(0)
+{
+}
+
+void UnitPositionIndex::Reset()
+{
+    _slack = sWorld->getFloatConfig(CONFIG_MAP_UNIT_POSITION_INDEX_SLACK);
+
+    if (!_cellCount)
+        return;
+
+    std::lock_guard<sf::contention_free_shared_mutex< >> lock(_lock);
+    _cells.clear();
+    _cellCount = 0;
+}
+
+void UnitPositionIndex::Invalidate(Cell const& cell)
+{
+    if (!_cellCount)
+        return;
+
+    std::lock_guard<sf::contention_free_shared_mutex< >> lock(_lock);
+    if (_cells.erase(cell.GetCellCoord().GetId()))
+        --_cellCount;
+}
+
+void UnitPositionIndex::OnRelocated(ObjectGuid const& guid, float x, float y, float z)
+{
+    if (!_cellCount)
+        return;
+
+    uint32 cellId = Cell(x, y).GetCellCoord().GetId();
+
+    PackedCellPtr cell;
+    {
+        std::shared_lock<sf::contention_free_shared_mutex< >> lock(_lock);
+        auto itr = _cells.find(cellId);
+        if (itr == _cells.end())
+            return;
+        cell = itr->second;
+    }
+
+    // many small steps add up, so the distance is taken from where the unit was packed
+    auto itr = cell->Slot.find(guid);
+    if (itr != cell->Slot.end())
+    {
+        uint32 i = itr->second;
+        float dx = x - cell->X[i];
+        float dy = y - cell->Y[i];
+        float dz = z - cell->Z[i];
+        if (dx * dx + dy * dy + dz * dz <= _slack * _slack)
+            return;
+    }
+
+    std::lock_guard<sf::contention_free_shared_mutex< >> lock(_lock);
+    auto current = _cells.find(cellId);
+    if (current != _cells.end() && current->second == cell)
+    {
+        _cells.erase(current);
+        --_cellCount;
+    }
+}
+
+void UnitPositionIndex::QueryRadius(Position const& center, float radius, uint32 typeMask, UnitList& units)
+{
+    Query(center.GetPositionX(), center.GetPositionY(), center.GetPositionZ(), radius, 0.0f, 0.0f, typeMask, units);
+}
+
+void UnitPositionIndex::QueryCone(Position const& apex, float orientation, float arc, float radius, uint32 typeMask, UnitList& units)
+{
+    // wider arcs reach behind the apex, only the circle can be tested
+    if (arc > float(M_PI))
+        return QueryRadius(apex, radius, typeMask, units);
+
+    Query(apex.GetPositionX(), apex.GetPositionY(), apex.GetPositionZ(), radius, std::cos(orientation), std::sin(orientation), typeMask, units);
+}
+
+void UnitPositionIndex::Query(float x, float y, float z, float radius, float dirX, float dirY, uint32 typeMask, UnitList& units)
+{
+    typeMask &= GRID_MAP_TYPE_MASK_PLAYER | GRID_MAP_TYPE_MASK_CREATURE;
+    if (!typeMask)
+        return;
+
+    CellArea area = Cell::CalculateCellArea(x, y, std::min(radius + _slack + CellSearchCompensation, SIZE_OF_GRIDS));
+
+    thread_local std::vector<uint8> hits;
+
+    std::size_t first = units.size();
+    uint32 cellsWithHits = 0;
+
+    for (uint32 cellX = area.low_bound.x_coord; cellX <= area.high_bound.x_coord; ++cellX)
+    {
+        for (uint32 cellY = area.low_bound.y_coord; cellY <= area.high_bound.y_coord; ++cellY)
+        {
+            PackedCellPtr cell = GetCell(CellCoord(cellX, cellY));
+            if (!cell)
+                continue;
+
+            uint32 count = uint32(cell->Guid.size());
+            hits.resize(count);
+
+            float const* posX = cell->X.data();
+            float const* posY = cell->Y.data();
+            float const* posZ = cell->Z.data();
+            float const* reach = cell->Reach.data();
+            uint32 const* types = cell->TypeMask.data();
+            uint8* hit = hits.data();
+
+            // no branches, so the compiler can vectorize the filter
+            for (uint32 i = 0; i < count; ++i)
+            {
+                float dx = posX[i] - x;
+                float dy = posY[i] - y;
+                float dz = posZ[i] - z;
+                float maxDist = radius + reach[i];
+                bool inRange = dx * dx + dy * dy + dz * dz <= maxDist * maxDist;
+                bool inFront = dx * dirX + dy * dirY + reach[i] >= 0.0f;
+                bool inMask = (types[i] & typeMask) != 0;
+                hit[i] = uint8(inRange & inFront & inMask);
+            }
+
+            std::size_t before = units.size();
+            for (uint32 i = 0; i < count; ++i)
+                if (hit[i])
+                    if (Unit* unit = ObjectAccessor::GetObjectInMap(cell->Guid[i], &_map, static_cast<Unit*>(nullptr)))
+                        units.push_back(unit);
+
+            if (units.size() != before)
+                ++cellsWithHits;
+        }
+    }
+
+    // a unit that changed cells is also still packed in its old cell until the next Reset()
+    if (cellsWithHits > 1)
+    {
+        thread_local std::unordered_set<Unit*> seen;
+        seen.clear();
+        units.erase(std::remove_if(units.begin() + first, units.end(), [](Unit* unit) { return !seen.insert(unit).second; }), units.end());
+    }
+}
+
+UnitPositionIndex::PackedCellPtr UnitPositionIndex::GetCell(CellCoord const& coord)
+{
+    uint32 cellId = coord.GetId();
+    {
+        std::shared_lock<sf::contention_free_shared_mutex< >> lock(_lock);
+        auto itr = _cells.find(cellId);
+        if (itr != _cells.end())
+            return itr->second;
+    }
+
+    PackedCellPtr cell = PackCell(coord);
+    if (!cell)
+        return nullptr;
+
+    // another thread may have packed the same cell meanwhile, keep the first one
+    std::lock_guard<sf::contention_free_shared_mutex< >> lock(_lock);
+    auto result = _cells.emplace(cellId, std::move(cell));
+    if (result.second)
+        ++_cellCount;
+    return result.first->second;
+}
+
+UnitPositionIndex::PackedCellPtr UnitPositionIndex::PackCell(CellCoord const& coord) const
+{
+    std::shared_ptr<PackedCell> cell = std::make_shared<PackedCell>();
+    UnitPositionPacker packer(cell->X, cell->Y, cell->Z, cell->Reach, cell->TypeMask, cell->Guid, cell->Slot, _slack);
+
+    Cell gridCell(coord);
+    gridCell.SetNoCreate();
+    _map.Visit(gridCell, Trinity::makeWorldVisitor(packer));
+    _map.Visit(gridCell, Trinity::makeGridVisitor(packer));
+
+    // grid not loaded, nothing to cache: objects may still be loaded into it this tick
+    if (!packer.Visited)
+        return nullptr;
+
+    return cell;
+}
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2008-2017 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef TRINITY_UNIT_POSITION_INDEX_H
+#define TRINITY_UNIT_POSITION_INDEX_H
+
+#include "Define.h"
+#include "GridDefines.h"
+#include "ObjectGuid.h"
+
+#include <atomic>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <boost/container/small_vector.hpp>
+#include <safe_ptr.h>
+
+class Map;
+class Unit;
+struct Cell;
+struct Position;
+
+/*
+ * Packed positions of the players and creatures of one map, used as broadphase
+ * for the spell area, cone and chain target searches.
+ *
+ * A cell is packed on the first query touching it (x, y, z, reach, type and
+ * guid as separate arrays) and stays valid until the next Reset(), which the map
+ * calls between the phases of its update. Queries only drop units that cannot
+ * pass the exact check: units that stay within MapUpdate.UnitPositionIndex.Slack
+ * yards (3D) of the position they were packed at are still found, units moving
+ * further and units entering a cell drop the packed cell. Results are resolved by guid, so removed units are skipped,
+ * and units still packed in the cell they left are only returned once.
+ */
+class TC_GAME_API UnitPositionIndex
+{
+public:
+    typedef boost::container::small_vector<Unit*, 32> UnitList;
+
+    // cells are searched this far beyond the radius, like the spell searchers do for large units
+    static constexpr float CellSearchCompensation = 30.0f;
+
+    explicit UnitPositionIndex(Map& map);
+
+    // drops every packed cell, called by the map at its sync points
+    void Reset();
+    // a unit was added to this cell
+    void Invalidate(Cell const& cell);
+    // a unit moved inside one cell, drops the cell once it is further than the slack from its packed position
+    void OnRelocated(ObjectGuid const& guid, float x, float y, float z);
+
+    // units with typeMask (GRID_MAP_TYPE_MASK_PLAYER / _CREATURE) possibly within radius + object size of center
+    void QueryRadius(Position const& center, float radius, uint32 typeMask, UnitList& units);
+    // as QueryRadius, also dropping units behind apex for arcs up to pi (same arc convention as Position::HasInArc)
+    void QueryCone(Position const& apex, float orientation, float arc, float radius, uint32 typeMask, UnitList& units);
+
+private:
+    struct PackedCell
+    {
+        std::vector<float> X;
+        std::vector<float> Y;
+        std::vector<float> Z;
+        std::vector<float> Reach;                           // object size + slack
+        std::vector<uint32> TypeMask;
+        std::vector<ObjectGuid> Guid;
+        std::unordered_map<ObjectGuid, uint32> Slot;       // guid -> index into the arrays
+    };
+
+    typedef std::shared_ptr<PackedCell const> PackedCellPtr;
+
+    PackedCellPtr GetCell(CellCoord const& coord);
+    PackedCellPtr PackCell(CellCoord const& coord) const;
+
+    // a zero direction skips the half plane test
+    void Query(float x, float y, float z, float radius, float dirX, float dirY, uint32 typeMask, UnitList& units);
+
+    Map& _map;
+    float _slack;
+
+    sf::contention_free_shared_mutex< > _lock;
+    std::unordered_map<uint32, PackedCellPtr> _cells;       // CellCoord::GetId() -> packed units
+    std::atomic<uint32> _cellCount;
+};
+
+#endif
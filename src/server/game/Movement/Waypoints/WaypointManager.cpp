@@ -31,10 +31,9 @@ void WaypointMgr::Load()
 {
     uint32 oldMSTime = getMSTime();
 
-    //                                                0    1         2           3          4            5           6        7      8       9        10              11
-    QueryResult result = WorldDatabase.Query("SELECT id, point, position_x, position_y, position_z, orientation, move_type, speed, delay, action, action_chance, delay_chance FROM waypoint_data ORDER BY id, point");
-
-    if (!result)
+    //                        0       1       2      3      4      5      6       7      8       9       10     11
+    TypedPreparedResultStream<uint32, uint32, float, float, float, float, uint32, float, uint32, uint32, int16, int16> rows;
+    if (!WorldDatabase.StreamQuery(WorldDatabase.GetPreparedStatement(WORLD_SEL_WAYPOINT_DATA_ALL), rows) || !rows.GetRowCount())
     {
         TC_LOG_ERROR("server.loading", ">> Loaded 0 waypoints. DB table `waypoint_data` is empty!");
 
@@ -43,28 +42,26 @@ void WaypointMgr::Load()
 
     uint32 count = 0;
 
-    do
+    while (rows.NextRow())
     {
-        Field* fields = result->Fetch();
-
-        uint32 pathId = fields[0].GetUInt32();
+        uint32 pathId = rows.Get<0>();
         WaypointPath& path = _waypointStore[pathId];
 
-        float x = fields[2].GetFloat();
-        float y = fields[3].GetFloat();
-        float z = fields[4].GetFloat();
-        float o = fields[5].GetFloat();
+        float x = rows.Get<2>();
+        float y = rows.Get<3>();
+        float z = rows.Get<4>();
+        float o = rows.Get<5>();
 
         Trinity::NormalizeMapCoord(x);
         Trinity::NormalizeMapCoord(y);
 
         WaypointData waypoint;
-        waypoint.id = fields[1].GetUInt32();
+        waypoint.id = rows.Get<1>();
         waypoint.x = x;
         waypoint.y = y;
         waypoint.z = z;
         waypoint.orientation = o;
-        waypoint.move_type = fields[6].GetUInt32();
+        waypoint.move_type = rows.Get<6>();
 
         if (waypoint.move_type >= WAYPOINT_MOVE_TYPE_MAX)
         {
@@ -72,48 +69,44 @@ void WaypointMgr::Load()
             continue;
         }
 
-        waypoint.speed = fields[7].GetFloat();
-        waypoint.delay = fields[8].GetUInt32();
-        waypoint.event_id = fields[9].GetUInt32();
-        waypoint.event_chance = fields[10].GetInt16();
-        waypoint.delay_chance = fields[11].GetInt16();
+        waypoint.speed = rows.Get<7>();
+        waypoint.delay = rows.Get<8>();
+        waypoint.event_id = rows.Get<9>();
+        waypoint.event_chance = rows.Get<10>();
+        waypoint.delay_chance = rows.Get<11>();
 
         path.push_back(std::move(waypoint));
         ++count;
     }
-    while (result->NextRow());
 
-    //                                    0    1         2           3          4            5           6        7      8       9        10
-    result = WorldDatabase.Query("SELECT id, point, position_x, position_y, position_z, orientation, move_type, speed, delay, action, action_chance FROM waypoint_data_script ORDER BY id, point");
-
-    if (!result)
+    //                              0       1       2      3      4      5      6       7      8       9       10
+    TypedPreparedResultStream<uint32, uint32, float, float, float, float, uint32, float, uint32, uint32, int16> scriptRows;
+    if (!WorldDatabase.StreamQuery(WorldDatabase.GetPreparedStatement(WORLD_SEL_WAYPOINT_DATA_SCRIPT_ALL), scriptRows) || !scriptRows.GetRowCount())
     {
         TC_LOG_ERROR("server.loading", ">> Loaded 0 waypoints. DB table `waypoint_data_script` is empty!");
         return;
     }
 
-    do
+    while (scriptRows.NextRow())
     {
-        Field* fields = result->Fetch();
-
-        uint32 pathId = fields[0].GetUInt32();
+        uint32 pathId = scriptRows.Get<0>();
         WaypointPath& path = _waypointScriptStore[pathId];
 
-        float x = fields[2].GetFloat();
-        float y = fields[3].GetFloat();
-        float z = fields[4].GetFloat();
-        float o = fields[5].GetFloat();
+        float x = scriptRows.Get<2>();
+        float y = scriptRows.Get<3>();
+        float z = scriptRows.Get<4>();
+        float o = scriptRows.Get<5>();
 
         Trinity::NormalizeMapCoord(x);
         Trinity::NormalizeMapCoord(y);
 
         WaypointData waypoint;
-        waypoint.id = fields[1].GetUInt32();
+        waypoint.id = scriptRows.Get<1>();
         waypoint.x = x;
         waypoint.y = y;
         waypoint.z = z;
         waypoint.orientation = o;
-        waypoint.move_type = fields[6].GetUInt32();
+        waypoint.move_type = scriptRows.Get<6>();
 
         if (waypoint.move_type >= WAYPOINT_MOVE_TYPE_MAX)
         {
@@ -121,15 +114,14 @@ void WaypointMgr::Load()
             continue;
         }
 
-        waypoint.speed = fields[7].GetFloat();
-        waypoint.delay = fields[8].GetUInt32();
-        waypoint.event_id = fields[9].GetUInt32();
-        waypoint.event_chance = fields[10].GetInt16();
+        waypoint.speed = scriptRows.Get<7>();
+        waypoint.delay = scriptRows.Get<8>();
+        waypoint.event_id = scriptRows.Get<9>();
+        waypoint.event_chance = scriptRows.Get<10>();
 
         path.push_back(std::move(waypoint));
         ++count;
     }
-    while (result->NextRow());
 
     TC_LOG_INFO("server.loading", ">> Loaded %u waypoints in %u ms", count, GetMSTimeDiffToNow(oldMSTime));
 }
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2008-2017 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SharedWorldPacket.h"
+#include "Log.h"
+#include "World.h"
+
+#include <zlib.h>
+
+namespace
+{
+// one deflate stream per thread, reset before every packet so the output never references earlier data
+struct SharedDeflateStream
+{
+    SharedDeflateStream()
+    {
+        memset(&Stream, 0, sizeof(Stream));
+        int32 z_res = deflateInit2(&Stream, sWorld->getIntConfig(CONFIG_COMPRESSION), Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY);
+        Initialized = z_res == Z_OK;
+        if (!Initialized)
+            TC_LOG_ERROR("network", "Can't initialize shared packet compression (zlib: deflateInit) Error code: %i (%s)", z_res, zError(z_res));
+    }
+
+    ~SharedDeflateStream()
+    {
+        if (Initialized)
+            deflateEnd(&Stream);
+    }
+
+    z_stream Stream;
+    bool Initialized;
+};
+
+bool Deflate(z_stream& stream, Bytef const* data, uint32 size, int flush)
+{
+    stream.next_in = const_cast<Bytef*>(data);
+    stream.avail_in = size;
+
+    int32 z_res = deflate(&stream, flush);
+    if (z_res != Z_OK)
+    {
+        TC_LOG_ERROR("network", "Can't compress shared packet (zlib: deflate) Error code: %i (%s, msg: %s)", z_res, zError(z_res), stream.msg);
+        return false;
+    }
+
+    return true;
+}
+}
+
+SharedWorldPacket::SharedWorldPacket(WorldPacket const& packet) : SharedWorldPacket(WorldPacket(packet))
+{
+}
+
+SharedWorldPacket::SharedWorldPacket(WorldPacket&& packet) : _data(std::make_shared<Data>(std::move(packet)))
+{
+    _data->Packet.FlushBits();
+}
+
+SharedWorldPacket::CompressedData const& SharedWorldPacket::GetCompressed() const
+{
+    std::call_once(_data->CompressOnce, [data = _data.get()]
+    {
+        thread_local SharedDeflateStream deflater;
+        if (!deflater.Initialized)
+            return;
+
+        z_stream& stream = deflater.Stream;
+        deflateReset(&stream);
+
+        WorldPacket const& packet = data->Packet;
+        uint16 opcode = packet.GetOpcode();
+        uint32 bound = deflateBound(&stream, packet.size() + sizeof(uint16));
+
+        std::vector<uint8> compressed(bound);
+        stream.next_out = compressed.data();
+        stream.avail_out = bound;
+
+        if (!Deflate(stream, reinterpret_cast<Bytef const*>(&opcode), sizeof(uint16), Z_NO_FLUSH)
+            || !Deflate(stream, packet.contents(), packet.size(), Z_SYNC_FLUSH))
+            return;
+
+        compressed.resize(bound - stream.avail_out);
+
+        data->Compressed.UncompressedAdler = adler32(adler32(0x9827D8F1, reinterpret_cast<Bytef const*>(&opcode), sizeof(uint16)), packet.contents(), packet.size());
+        data->Compressed.CompressedAdler = adler32(0x9827D8F1, compressed.data(), compressed.size());
+        data->Compressed.Data = std::move(compressed);
+    });
+
+    return _data->Compressed;
+}
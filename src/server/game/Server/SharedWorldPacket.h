@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2008-2017 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRINITYCORE_SHAREDWORLDPACKET_H
+#define TRINITYCORE_SHAREDWORLDPACKET_H
+
+#include "WorldPacket.h"
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/*! Immutable packet sent to many sessions.
+    Copies of this handle share one WorldPacket, so queueing it on a socket does not copy the
+    payload. Packets above WorldSocket::MinSizeForCompression are deflated once, by the first
+    socket that writes it, into a standalone raw deflate block that every socket can send as is.
+    Only the header encryption stays per socket. */
+class TC_GAME_API SharedWorldPacket
+{
+public:
+    struct CompressedData
+    {
+        uint32 UncompressedAdler = 0;
+        uint32 CompressedAdler = 0;
+        std::vector<uint8> Data;        // empty if compression failed
+    };
+
+    SharedWorldPacket() = default;
+    explicit SharedWorldPacket(WorldPacket const& packet);
+    explicit SharedWorldPacket(WorldPacket&& packet);
+
+    explicit operator bool() const { return _data != nullptr; }
+
+    WorldPacket const& GetPacket() const { return _data->Packet; }
+
+    /// Deflates opcode and payload on first use, later calls (from any thread) return the same block
+    CompressedData const& GetCompressed() const;
+
+private:
+    struct Data
+    {
+        explicit Data(WorldPacket&& packet) : Packet(std::move(packet)) { }
+
+        WorldPacket Packet;
+        std::once_flag CompressOnce;
+        CompressedData Compressed;
+    };
+
+    std::shared_ptr<Data> _data;
+};
+
+#endif
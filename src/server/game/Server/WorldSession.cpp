@@ -33,6 +33,7 @@
 #include "BattlePayMgr.h"
 #include "CharacterData.h"
 #include "CharacterPackets.h"
+#include "CharacterSaveScheduler.h"
 #include "ChatPackets.h"
 #include "Common.h"
 #include "DatabaseEnv.h"
@@ -74,7 +75,7 @@ void WorldPackets::Null::Read()
 }
 
 WorldSession::WorldSession(uint32 id, std::string&& name, const std::shared_ptr<WorldSocket>& sock, AccountTypes sec, uint8 expansion, time_t mute_time, std::string os, LocaleConstant locale, uint32 recruiter, bool isARecruiter, AuthFlags flag, std::unordered_map<uint8, int64>&& accountTokenMap):
-m_muteTime(mute_time), m_timeOutTime(0), _countPenaltiesHwid(0), _player(nullptr), m_map(nullptr), _security(sec), _accountId(id), m_expansion(expansion), m_accountExpansion(expansion), _logoutTime(0), m_inQueue(false), m_playerLogout(false), m_playerRecentlyLogout(false),
+m_muteTime(mute_time), m_timeOutTime(0), _countPenaltiesHwid(0), _player(nullptr), m_map(nullptr), m_tickMap(nullptr), _security(sec), _accountId(id), m_expansion(expansion), m_accountExpansion(expansion), _logoutTime(0), m_inQueue(false), m_playerLoadingWaitsForSave(false), m_playerLogout(false), m_playerRecentlyLogout(false),
 m_playerSave(false), m_sessionDbLocaleIndex(locale), m_latency(0), _tutorialsChanged(TUTORIALS_FLAG_NONE), recruiterId(recruiter), isRecruiter(isARecruiter), playerLoginCounter(0), forceExit(false), m_sUpdate(false), wardenModuleFailed(false), atAuthFlag(flag), canLogout(false),
 tokens(accountTokenMap)
 {
@@ -92,6 +93,12 @@ tokens(accountTokenMap)
 
     _filterAddonMessages = false;
 
+    m_Functions.SetWakeHandler([](void* session)
+    {
+        if (Map* map = static_cast<WorldSession*>(session)->m_tickMap)
+            map->WakeTickForQueuedWork(true);
+    }, this);
+
     if (sock)
     {
         m_Address = sock->GetRemoteIpAddress().to_string();
@@ -193,26 +200,26 @@ ObjectGuid::LowType WorldSession::GetGuidLow() const
     return GetPlayer() ? GetPlayer()->GetGUIDLow() : 0;
 }
 
-/// Send a packet to the client
-void WorldSession::SendPacket(WorldPacket const* packet, bool forced /*= false*/)
+/// Socket a packet is sent on, MAX_CONNECTION_TYPES if it must not be sent
+ConnectionType WorldSession::GetSendConnection(WorldPacket const* packet, bool forced) const
 {
     uint32 opcode = packet->GetOpcode();
     if (opcode == NULL_OPCODE)
     {
         TC_LOG_ERROR("misc", "Prevented sending of NULL_OPCODE to %s", GetPlayerName(false).c_str());
-        return;
+        return MAX_CONNECTION_TYPES;
     }
     if (opcode == MAX_OPCODE)
     {
         TC_LOG_ERROR("misc", "Prevented sending of wrong opcode to %s", GetPlayerName(false).c_str());
-        return;
+        return MAX_CONNECTION_TYPES;
     }
 
     ServerOpcodeHandler const* handler = opcodeTable[static_cast<OpcodeServer>(opcode)];
     if (!handler)
     {
         TC_LOG_ERROR("misc", "Prevented sending of opcode %u with non existing handler to %s", opcode, GetPlayerName().c_str());
-        return;
+        return MAX_CONNECTION_TYPES;
     }
 
     ConnectionType conIdx = handler->ConnectionIndex;
@@ -221,7 +228,7 @@ void WorldSession::SendPacket(WorldPacket const* packet, bool forced /*= false*/
         if (packet->GetConnection() != CONNECTION_TYPE_INSTANCE && IsInstanceOnlyOpcode(opcode))
         {
             TC_LOG_ERROR("misc", "Prevented sending of instance only opcode %u with connection type %u to %s", opcode, packet->GetConnection(), GetPlayerName().c_str());
-            return;
+            return MAX_CONNECTION_TYPES;
         }
 
         conIdx = packet->GetConnection();
@@ -230,15 +237,26 @@ void WorldSession::SendPacket(WorldPacket const* packet, bool forced /*= false*/
     if (!m_Socket[conIdx])
     {
         TC_LOG_DEBUG("misc", "Prevented sending of %s to non existent socket %u to %s", GetOpcodeNameForLogging(static_cast<OpcodeServer>(opcode)).c_str(), conIdx, GetPlayerName().c_str());
-        return;
+        return MAX_CONNECTION_TYPES;
     }
 
     if (!forced && handler->Status == STATUS_UNHANDLED)
     {
         TC_LOG_ERROR("misc", "Prevented sending disabled opcode %s to %s", GetOpcodeNameForLogging(static_cast<OpcodeServer>(opcode)).c_str(), GetPlayerName().c_str());
-        return;
+        return MAX_CONNECTION_TYPES;
     }
 
+    return conIdx;
+}
+
+/// Send a packet to the client
+void WorldSession::SendPacket(WorldPacket const* packet, bool forced /*= false*/)
+{
+    ConnectionType conIdx = GetSendConnection(packet, forced);
+    if (conIdx == MAX_CONNECTION_TYPES)
+        return;
+
+    uint32 opcode = packet->GetOpcode();
     uint32 packetSize = packet->size();
     uint32 start_time = getMSTime();
     const_cast<WorldPacket*>(packet)->FlushBits();
@@ -250,10 +268,38 @@ void WorldSession::SendPacket(WorldPacket const* packet, bool forced /*= false*/
         sLog->outDiff(" >> SendPacket DIFF %u player_guid %u _mapID_ %i AccountId %u opcode %u packetSize %u", getMSTime() - start_time, (_player && !_player->IsDelete()) ? _player->GetGUIDLow() : 0, (_player && !_player->IsDelete()) ? _player->GetMapId() : -1, GetAccountId(), opcode, packetSize);
 }
 
+/// Send a packet shared with other sessions, see SharedWorldPacket
+void WorldSession::SendPacket(SharedWorldPacket const& packet, bool forced /*= false*/)
+{
+    ConnectionType conIdx = GetSendConnection(&packet.GetPacket(), forced);
+    if (conIdx == MAX_CONNECTION_TYPES)
+        return;
+
+    if (std::shared_ptr<WorldSocket> socket = m_Socket[conIdx])
+        socket->SendPacket(packet);
+}
+
 /// Add an incoming packet to the queue
 void WorldSession::QueuePacket(WorldPacket* new_packet)
 {
     _recvQueue.add(new_packet);
+
+    if (Map* map = m_tickMap)
+        map->WakeTick(true);
+}
+
+void WorldSession::SetMap(Map* m)
+{
+    m_map = m;
+    m_tickMap = m ? m->GetTickOwner() : nullptr;
+}
+
+bool WorldSession::HasPendingWork() const
+{
+    if (!m_Functions.Empty() || m_Functions.SizeQueue() || !_queryProcessor.Empty() || !_transactionCallbacks.Empty() || !_queryHolderProcessor.Empty() || m_playerLoadingWaitsForSave)
+        return true;
+
+    return _player && _player->GetSpellInQueue()->GCDEnd;
 }
 
 /// Logging helper for unexpected opcodes
@@ -1002,6 +1048,13 @@ void WorldSession::ProcessQueryCallbacks()
     _queryProcessor.ProcessReadyCallbacks();
     _transactionCallbacks.ProcessReadyCallbacks();
     _queryHolderProcessor.ProcessReadyCallbacks();
+
+    if (m_playerLoadingWaitsForSave && !sCharacterSaveScheduler->IsSaveInFlight(m_playerLoading.GetCounter()))
+    {
+        m_playerLoadingWaitsForSave = false;
+        if (PlayerLoading())
+            HandleContinuePlayerLogin();
+    }
 }
 
 TransactionCallback& WorldSession::AddTransactionCallback(TransactionCallback&& callback)
@@ -1148,14 +1201,14 @@ void WorldSession::InitializeSession()
 
     std::shared_ptr<ForkJoinState> state = std::make_shared<ForkJoinState>();
 
-    AddQueryHolderCallback(CharacterDatabase.DelayQueryHolder(realmHolder)).AfterComplete([this, state, realmHolder](SQLQueryHolderBase const& /*result*/)
+    AddQueryHolderCallback(CharacterDatabase.DelayQueryHolder(realmHolder, DATABASE_LANE_LOGIN)).AfterComplete([this, state, realmHolder](SQLQueryHolderBase const& /*result*/)
     {
         state->Character = realmHolder;
         if (state->Login && state->Character)
             InitializeSessionCallback(*state->Login, *state->Character);
     });
 
-    AddQueryHolderCallback(LoginDatabase.DelayQueryHolder(holder)).AfterComplete([this, state, holder](SQLQueryHolderBase const& /*result*/)
+    AddQueryHolderCallback(LoginDatabase.DelayQueryHolder(holder, DATABASE_LANE_LOGIN)).AfterComplete([this, state, holder](SQLQueryHolderBase const& /*result*/)
     {
         state->Login = holder;
         if (state->Login && state->Character)
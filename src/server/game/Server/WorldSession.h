@@ -55,6 +55,7 @@ class Unit;
 class Warden;
 class WorldObject;
 class WorldPacket;
+class SharedWorldPacket;
 class WorldSocket;
 class LoginQueryHolder;
 class Map;
@@ -1063,6 +1064,7 @@ class TC_GAME_API WorldSession
         bool IsAddonRegistered(std::string const& prefix);
 
         void SendPacket(WorldPacket const* packet, bool forced = false);
+        void SendPacket(SharedWorldPacket const& packet, bool forced = false);
         void AddInstanceConnection(std::shared_ptr<WorldSocket> sock) { m_Socket[CONNECTION_TYPE_INSTANCE] = sock; }
         void SendNotification(const char *format, ...) ATTR_PRINTF(2, 3);
         void SendNotification(uint32 string_id, ...);
@@ -1098,7 +1100,8 @@ class TC_GAME_API WorldSession
         std::string GetPlayerInfo() const;
 
         Map* GetMap() const { return m_map; }
-        void SetMap(Map* m) { m_map = m; }
+        void SetMap(Map* m);
+        bool HasPendingWork() const;                // delayed functions, database callbacks or a queued spell wait for the next update
 
         ObjectGuid::LowType GetGuidLow() const;
         void SetSecurity(AccountTypes security) { _security = security; }
@@ -2033,9 +2036,10 @@ class TC_GAME_API WorldSession
 		float GetPersonalXPRate() { return PersonalXPRate; }
 		void SetPersonalXPRate(float rate);
 
-        void AddDelayedEvent(uint64 timeOffset, std::function<void()>&& function)
+        template <typename F>
+        void AddDelayedEvent(uint64 timeOffset, F&& function)
         {
-            m_Functions.AddDelayedEvent(timeOffset, std::move(function));
+            m_Functions.AddDelayedEvent(timeOffset, std::forward<F>(function));
         }
 
         FunctionProcessor m_Functions;
@@ -2070,6 +2074,8 @@ class TC_GAME_API WorldSession
 
         bool CanUseBank(ObjectGuid bankerGUID = ObjectGuid::Empty) const;
 
+        ConnectionType GetSendConnection(WorldPacket const* packet, bool forced) const;
+
         // logging helper
         void LogUnexpectedOpcode(WorldPacket* packet, const char* status, const char *reason);
 
@@ -2089,6 +2095,7 @@ class TC_GAME_API WorldSession
         std::shared_ptr<WorldSocket> m_Socket[MAX_CONNECTION_TYPES];
         std::string m_Address;
         Map* m_map;
+        std::atomic<Map*> m_tickMap;                                     // tick owner of m_map, woken from the network thread when packets are queued
 
         AccountTypes _security;
         uint32 _accountId;
@@ -2111,6 +2118,7 @@ class TC_GAME_API WorldSession
         time_t _logoutTime;
         bool m_inQueue;                                     // session wait in auth.queue
         ObjectGuid m_playerLoading;                         // code processed in LoginPlayer
+        bool m_playerLoadingWaitsForSave;                   // login query held back until the last save of m_playerLoading committed
         bool m_playerLogout;                                // code processed in LogoutPlayer
         bool m_playerRecentlyLogout;
         bool m_playerSave;
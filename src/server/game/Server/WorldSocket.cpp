@@ -49,6 +49,31 @@ struct CompressedWorldPacket
 
 using boost::asio::ip::tcp;
 
+// payload is copied into pooled storage, the network thread hands it back to the pool once written
+EncryptablePacket::EncryptablePacket(WorldPacket const& packet, bool encrypt) : _packet(packet.GetOpcode(), sMessageBufferPool->Acquire(packet.size()), packet.GetConnection()), _encrypt(encrypt)
+{
+    if (!packet.empty())
+        memcpy(_packet.contents(), packet.contents(), packet.size());
+}
+
+EncryptablePacket::~EncryptablePacket()
+{
+    sMessageBufferPool->Release(_packet.Move());
+}
+
+namespace
+{
+// deflate block computed once for all receivers of a shared packet, null if the packet is sent uncompressed or compressed per socket
+SharedWorldPacket::CompressedData const* GetSharedCompression(EncryptablePacket const& packet)
+{
+    if (!packet.GetShared() || packet.GetPacket().size() <= WorldSocket::MinSizeForCompression || !packet.NeedsEncryption())
+        return nullptr;
+
+    SharedWorldPacket::CompressedData const& compressed = packet.GetShared().GetCompressed();
+    return compressed.Data.empty() ? nullptr : &compressed;
+}
+}
+
 std::string const WorldSocket::ServerConnectionInitialize("WORLD OF WARCRAFT CONNECTION - SERVER TO CLIENT");
 std::string const WorldSocket::ClientConnectionInitialize("WORLD OF WARCRAFT CONNECTION - CLIENT TO SERVER");
 uint32 const WorldSocket::MinSizeForCompression = 0x400;
@@ -64,6 +89,7 @@ WorldSocket::WorldSocket(tcp::socket&& socket) : Socket(std::move(socket))
 
     _worldSession = nullptr;
     _compressionStream = nullptr;
+    _compressionStreamReset = false;
     _OverSpeedPings = 0;
     _accountId = 0;
     _authed = false;
@@ -223,24 +249,30 @@ void WorldSocket::InitializeHandler(boost::system::error_code const& error, std:
 bool WorldSocket::Update()
 {
     EncryptablePacket* queued;
-    MessageBuffer buffer(_sendBufferSize);
+    MessageBuffer buffer(std::size_t(0));   // taken from the pool when the first packet is dequeued
     while (_bufferQueue.Dequeue(queued))
     {
-        uint32 packetSize = queued->size();
-        if (packetSize > MinSizeForCompression && queued->NeedsEncryption())
+        uint32 packetSize = queued->GetPacket().size();
+        if (SharedWorldPacket::CompressedData const* compressed = GetSharedCompression(*queued))
+            packetSize = compressed->Data.size() + sizeof(CompressedWorldPacket);
+        else if (packetSize > MinSizeForCompression && queued->NeedsEncryption())
             packetSize = compressBound(packetSize) + sizeof(CompressedWorldPacket);
 
         if (buffer.GetRemainingSpace() < packetSize + SizeOfHeader)
         {
-            QueuePacket(std::move(buffer));
-            buffer.Resize(_sendBufferSize);  // NOLINT
+            if (buffer.GetActiveSize() > 0)
+                QueuePacket(std::move(buffer));
+            else
+                sMessageBufferPool->Release(std::move(buffer));
+
+            buffer = sMessageBufferPool->Acquire(_sendBufferSize);
         }
 
         if (buffer.GetRemainingSpace() >= packetSize + SizeOfHeader)
             WritePacketToBuffer(*queued, buffer);
         else    // single packet larger than 4096 bytes
         {
-            MessageBuffer packetBuffer(packetSize + SizeOfHeader);
+            MessageBuffer packetBuffer = sMessageBufferPool->Acquire(packetSize + SizeOfHeader);
             WritePacketToBuffer(*queued, packetBuffer);
             QueuePacket(std::move(packetBuffer));
         }
@@ -250,6 +282,8 @@ bool WorldSocket::Update()
 
     if (buffer.GetActiveSize() > 0)
         QueuePacket(std::move(buffer));
+    else
+        sMessageBufferPool->Release(std::move(buffer));
 
     if (!BaseSocket::Update())
         return false;
@@ -544,8 +578,25 @@ void WorldSocket::SendPacket(WorldPacket const& packet)
     _bufferQueue.Enqueue(new EncryptablePacket(packet, _authCrypt.IsInitialized()));
 }
 
-void WorldSocket::WritePacketToBuffer(EncryptablePacket const& packet, MessageBuffer& buffer)
+void WorldSocket::SendPacket(SharedWorldPacket const& packet)
+{
+    if (!IsOpen())
+        return;
+
+    WorldPacket const& data = packet.GetPacket();
+    if (data.size() > 0x7FFFFFF)
+        return;
+
+    sPacketLog->LogPacket(data, SERVER_TO_CLIENT, GetRemoteIpAddress(), GetRemotePort(), GetConnectionType());
+
+    TC_LOG_TRACE("network.opcode", "S->C: %s Size %u %s connection %i, connectionType %i (shared)", GetOpcodeNameForLogging(static_cast<OpcodeServer>(data.GetOpcode())).c_str(), uint32(data.size()), GetRemoteIpAddress().to_string().c_str(), data.GetConnection(), GetConnectionType());
+
+    _bufferQueue.Enqueue(new EncryptablePacket(packet, _authCrypt.IsInitialized()));
+}
+
+void WorldSocket::WritePacketToBuffer(EncryptablePacket const& queued, MessageBuffer& buffer)
 {
+    WorldPacket const& packet = queued.GetPacket();
     uint32 opcode = packet.GetOpcode();
     uint32 packetSize = packet.size();
 
@@ -553,7 +604,23 @@ void WorldSocket::WritePacketToBuffer(EncryptablePacket const& packet, MessageBu
     uint8* headerPos = buffer.GetWritePointer();
     buffer.WriteCompleted(SizeOfHeader);
 
-    if (packetSize > MinSizeForCompression && packet.NeedsEncryption())
+    if (SharedWorldPacket::CompressedData const* compressed = GetSharedCompression(queued))
+    {
+        CompressedWorldPacket cmp;
+        cmp.UncompressedSize = packetSize + 2;
+        cmp.UncompressedAdler = compressed->UncompressedAdler;
+        cmp.CompressedAdler = compressed->CompressedAdler;
+
+        buffer.Write(&cmp, sizeof(CompressedWorldPacket));
+        buffer.Write(compressed->Data.data(), compressed->Data.size());
+        packetSize = compressed->Data.size() + sizeof(CompressedWorldPacket);
+
+        // the client inflated data our stream has not seen, back references computed by it would point into the wrong bytes
+        _compressionStreamReset = true;
+
+        opcode = SMSG_COMPRESSED_PACKET;
+    }
+    else if (packetSize > MinSizeForCompression && queued.NeedsEncryption())
     {
         CompressedWorldPacket cmp;
         cmp.UncompressedSize = packetSize + 2;
@@ -589,6 +656,13 @@ void WorldSocket::WritePacketToBuffer(EncryptablePacket const& packet, MessageBu
 uint32 WorldSocket::CompressPacket(uint8* buffer, WorldPacket const& packet)
 {
     uint32 opcode = packet.GetOpcode();
+
+    if (_compressionStreamReset)
+    {
+        deflateReset(_compressionStream);
+        _compressionStreamReset = false;
+    }
+
     uint32 bufferSize = deflateBound(_compressionStream, packet.size() + sizeof(uint16));
 
     _compressionStream->next_out = buffer;
@@ -685,7 +759,7 @@ void WorldSocket::HandleAuthSession(std::shared_ptr<WorldPackets::Auth::AuthSess
     stmt->setInt32(0, int32(realm.Id.Realm));
     stmt->setString(1, authSession->RealmJoinTicket);
 
-    _queryProcessor.AddCallback(LoginDatabase.AsyncQuery(stmt).WithPreparedCallback(std::bind(&WorldSocket::HandleAuthSessionCallback, this, authSession, std::placeholders::_1)));
+    _queryProcessor.AddCallback(LoginDatabase.AsyncQuery(stmt, DATABASE_LANE_LOGIN).WithPreparedCallback(std::bind(&WorldSocket::HandleAuthSessionCallback, this, authSession, std::placeholders::_1)));
 }
 
 void WorldSocket::HandleAuthSessionCallback(std::shared_ptr<WorldPackets::Auth::AuthSession> authSession, PreparedQueryResult result)
@@ -968,7 +1042,7 @@ void WorldSocket::HandleAuthContinuedSession(std::shared_ptr<WorldPackets::Auth:
     LoginDatabasePreparedStatement* stmt = LoginDatabase.GetPreparedStatement(LOGIN_SEL_ACCOUNT_INFO_CONTINUED_SESSION);
     stmt->setUInt32(0, uint32(key.Fields.AccountId));
 
-    _queryProcessor.AddCallback(LoginDatabase.AsyncQuery(stmt).WithPreparedCallback(std::bind(&WorldSocket::HandleAuthContinuedSessionCallback, this, authSession, std::placeholders::_1)));
+    _queryProcessor.AddCallback(LoginDatabase.AsyncQuery(stmt, DATABASE_LANE_LOGIN).WithPreparedCallback(std::bind(&WorldSocket::HandleAuthContinuedSessionCallback, this, authSession, std::placeholders::_1)));
 }
 
 void WorldSocket::HandleAuthContinuedSessionCallback(std::shared_ptr<WorldPackets::Auth::AuthContinuedSession> authSession, PreparedQueryResult result)
@@ -22,6 +22,7 @@
 #include "DatabaseEnvFwd.h"
 #include "MPSCQueue.h"
 #include "Socket.h"
+#include "SharedWorldPacket.h"
 #include "Util.h"
 #include "WorldPacketCrypt.h"
 #include "WorldSession.h"
@@ -29,14 +30,22 @@
 
 struct z_stream_s;
 
-class EncryptablePacket : public WorldPacket
+class EncryptablePacket
 {
 public:
-    EncryptablePacket(WorldPacket const& packet, bool encrypt) : WorldPacket(packet), _encrypt(encrypt) { }
+    EncryptablePacket(WorldPacket const& packet, bool encrypt);
+    EncryptablePacket(SharedWorldPacket const& packet, bool encrypt) : _shared(packet), _encrypt(encrypt) { }
+    ~EncryptablePacket();
 
+    WorldPacket const& GetPacket() const { return _shared ? _shared.GetPacket() : _packet; }
+    SharedWorldPacket const& GetShared() const { return _shared; }
     bool NeedsEncryption() const { return _encrypt; }
 
+    std::atomic<EncryptablePacket*> SocketQueueLink;
+
 private:
+    WorldPacket _packet;
+    SharedWorldPacket _shared;
     bool _encrypt;
 };
 
@@ -71,8 +80,6 @@ class WorldSocket : public Socket<WorldSocket>
 {
     static std::string const ServerConnectionInitialize;
     static std::string const ClientConnectionInitialize;
-    static uint32 const MinSizeForCompression;
-
     static uint8 const AuthCheckSeed[16];
     static uint8 const SessionKeySeed[16];
     static uint8 const ContinuedSessionSeed[16];
@@ -80,6 +87,8 @@ class WorldSocket : public Socket<WorldSocket>
     typedef Socket<WorldSocket> BaseSocket;
 
 public:
+    static uint32 const MinSizeForCompression;
+
     WorldSocket(boost::asio::ip::tcp::socket&& socket);
     ~WorldSocket();
 
@@ -90,6 +99,7 @@ public:
     bool Update() override;
 
     void SendPacket(WorldPacket const& packet);
+    void SendPacket(SharedWorldPacket const& packet);
 
     ConnectionType GetConnectionType() const { return _type; }
 
@@ -147,10 +157,11 @@ private:
 
     MessageBuffer _headerBuffer;
     MessageBuffer _packetBuffer;
-    MPSCQueue<EncryptablePacket> _bufferQueue;
+    MPSCQueue<EncryptablePacket, &EncryptablePacket::SocketQueueLink> _bufferQueue;
     std::size_t _sendBufferSize;
 
     z_stream_s* _compressionStream;
+    bool _compressionStreamReset;       // a shared deflate block was sent, the client history no longer matches _compressionStream
 
     QueryCallbackProcessor _queryProcessor;
     std::string _ipCountry;
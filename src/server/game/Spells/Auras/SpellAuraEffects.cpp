@@ -591,6 +591,15 @@ void AuraEffect::GetApplicationList(std::list<AuraApplication*> & applicationLis
     }
 }
 
+void AuraEffect::InvalidateTargetModifierTotals()
+{
+    Aura::ApplicationMap const& targetMap = GetBase()->GetApplicationMap();
+    for (Aura::ApplicationMap::const_iterator appIter = targetMap.begin(); appIter != targetMap.end(); ++appIter)
+        if (AuraApplicationPtr aurApp = appIter->second)
+            if (aurApp->HasEffect(GetEffIndex()))
+                aurApp->GetTarget()->InvalidateAuraModifierTotals(GetAuraType());
+}
+
 float AuraEffect::CalculateAmount(Unit* caster)
 {
     Item* castItem = nullptr;
@@ -1816,6 +1825,7 @@ void AuraEffect::ChangeAmount(float newAmount, bool mark, bool onStackOrReapply)
         if (!mark)
         {
             m_amount = newAmount;
+            InvalidateTargetModifierTotals();
             GetBase()->UpdateConcatenateAura(GetCaster(), newAmount, m_effIndex);
         }
         else
@@ -7867,6 +7877,7 @@ void AuraEffect::HandlePeriodicDamageAurasTick(Unit* target, Unit* caster, Spell
                     damage += m_amount_add;
                     damage += damage_add;
                     const_cast<AuraEffect*>(this)->m_amount = damage;
+                    const_cast<AuraEffect*>(this)->InvalidateTargetModifierTotals();
                 }
 
                 if (!(GetSpellInfo()->HasAttribute(SPELL_ATTR9_UNK28)))
@@ -8340,6 +8351,7 @@ void AuraEffect::HandlePeriodicHealAurasTick(Unit* target, Unit* caster, SpellEf
             damage *= m_amount_mod;
             damage += m_amount_add;
             const_cast<AuraEffect*>(this)->m_amount = damage;
+            const_cast<AuraEffect*>(this)->InvalidateTargetModifierTotals();
         }
 
         // Wild Growth = amount + (6 - 2*doneTicks) * ticks* amount / 100
@@ -82,6 +82,7 @@ class TC_GAME_API AuraEffect
             if (m_amount != amount)
             {
                 m_amount = amount;
+                InvalidateTargetModifierTotals();
                 GetBase()->SetNeedClientUpdateForTargets();
                 GetBase()->UpdateConcatenateAura(GetCaster(), m_amount, m_effIndex);
             }
@@ -97,6 +98,7 @@ class TC_GAME_API AuraEffect
         void CalculatePeriodic(Unit* caster, bool resetPeriodicTimer = true, bool load = false);
         void CalculateSpellMod();
         void ChangeAmount(float newAmount, bool mark = true, bool onStackOrReapply = false);
+        void InvalidateTargetModifierTotals();      ///< drop the cached aura type totals of every target the effect is applied to
         void RecalculateAmount() { if (!CanBeRecalculated()) return; ChangeAmount(CalculateAmount(GetCaster()), false); }
         void RecalculateAmount(Unit* caster) { if (!CanBeRecalculated()) return; ChangeAmount(CalculateAmount(caster), false); }
         bool CanBeRecalculated() const { return m_canBeRecalculated; }
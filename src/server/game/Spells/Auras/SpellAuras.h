@@ -53,7 +53,7 @@ namespace WorldPackets
 class TC_GAME_API AuraApplication
 {
     friend void Unit::_ApplyAura(AuraApplication * aurApp, uint32 effMask);
-    friend void Unit::_UnapplyAura(/*AuraApplicationMap*/std::multimap<uint32, AuraApplicationPtr>::iterator &i, AuraRemoveMode removeMode);
+    friend void Unit::_UnapplyAura(Unit::AuraApplicationMap::iterator &i, AuraRemoveMode removeMode);
     friend void Unit::_ApplyAuraEffect(Aura* aura, uint32 effIndex);
     friend void Unit::RemoveAura(AuraApplication * aurApp, AuraRemoveMode mode);
     friend void Unit::RemoveOwnedAuraAll();
@@ -65,6 +65,9 @@ class TC_GAME_API AuraApplication
         uint8 _flags;                                  // Aura info flag
         uint32 _effectMask;
         uint32 _effectsToApply;                         // Used only at spell hit to determine which effect should be applied
+        uint32 _procMask;                               // proc flags this application is indexed under on its target
+        uint32 _procSequence;                           // registration order in the target's proc index
+        uint32 _procVisit;                              // last proc event of the target that collected this application
         bool _needClientUpdate:1;
 
     public:
@@ -85,6 +88,17 @@ class TC_GAME_API AuraApplication
         bool IsSelfcasted() const { return !(_flags & AFLAG_NOCASTER); }
         uint32 GetEffectsToApply() const { return _effectsToApply; }
 
+        uint32 GetProcMask() const { return _procMask; }
+        uint32 GetProcSequence() const { return _procSequence; }
+        void _SetProcSubscription(uint32 procMask, uint32 sequence) { _procMask = procMask; _procSequence = sequence; }
+        bool _MarkProcVisit(uint32 visit)
+        {
+            if (_procVisit == visit)
+                return false;
+            _procVisit = visit;
+            return true;
+        }
+
         void SetRemoveMode(AuraRemoveMode mode) { _removeMode = mode; }
         AuraRemoveMode GetRemoveMode() const {return _removeMode;}
 
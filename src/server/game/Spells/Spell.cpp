@@ -53,6 +53,7 @@
 #include "SpellInfo.h"
 #include "SpellMgr.h"
 #include "SpellPackets.h"
+#include "SpellPool.h"
 #include "SpellScript.h"
 #include "TemporarySummon.h"
 #include "TradeData.h"
@@ -273,6 +274,16 @@ Spell::~Spell()
     spellCountInWorld[m_spellInfo->Id]--;
 }
 
+void* Spell::operator new(std::size_t size)
+{
+    return sSpellPool->Allocate(size);
+}
+
+void Spell::operator delete(void* storage, std::size_t size)
+{
+    sSpellPool->Deallocate(storage, size);
+}
+
 void Spell::InitExplicitTargets(SpellCastTargets const& targets)
 {
     m_targets = targets;
@@ -939,6 +950,28 @@ void Spell::SelectImplicitConeTargets(SpellEffIndex effIndex, SpellImplicitTarge
     if (uint32 containerTypeMask = GetSearcherTypeMask(objectType, condList))
     {
         Trinity::WorldObjectSpellConeTargetCheck check(coneAngle, radius, caster, m_spellInfo, selectionType, condList);
+
+        if (sWorld->getBoolConfig(CONFIG_MAP_UNIT_POSITION_INDEX) && (containerTypeMask & (GRID_MAP_TYPE_MASK_PLAYER | GRID_MAP_TYPE_MASK_CREATURE)))
+        {
+            // same order of cone shapes as WorldObjectSpellConeTargetCheck, back cones only get the circle
+            UnitPositionIndex::UnitList units;
+            UnitPositionIndex& index = caster->GetMap()->GetUnitPositionIndex();
+            if (m_spellInfo->AttributesCu[0] & SPELL_ATTR0_CU_CONE_BACK)
+                index.QueryRadius(*caster, radius, containerTypeMask, units);
+            else if (m_spellInfo->AttributesCu[0] & SPELL_ATTR0_CU_CONE_LINE)
+                index.QueryCone(*caster, caster->GetOrientation(), float(M_PI), radius, containerTypeMask, units);
+            else if (coneAngle < 0.0f)
+                index.QueryRadius(*caster, radius, containerTypeMask, units);
+            else
+                index.QueryCone(*caster, caster->GetOrientation(), Position::NormalizeOrientation(coneAngle), radius, containerTypeMask, units);
+
+            for (Unit* unit : units)
+                if (check(unit))
+                    targets.push_back(unit);
+
+            containerTypeMask &= ~(GRID_MAP_TYPE_MASK_PLAYER | GRID_MAP_TYPE_MASK_CREATURE);
+        }
+
         Trinity::WorldObjectListSearcher<Trinity::WorldObjectSpellConeTargetCheck> searcher(caster, targets, check, containerTypeMask);
         SearchTargets<Trinity::WorldObjectListSearcher<Trinity::WorldObjectSpellConeTargetCheck> >(searcher, containerTypeMask, caster, caster, radius);
 
@@ -2024,6 +2057,19 @@ void Spell::SearchAreaTargets(std::list<WorldObject*>& targets, float range, Pos
         return;
     Unit* caster = m_originalCaster ? m_originalCaster : m_caster;
     Trinity::WorldObjectSpellAreaTargetCheck check(range, position, caster, referer, m_spellInfo, selectionType, condList, allowObjectSize);
+
+    // units come from the packed positions of the map, the grid is only walked for the other object types
+    if (sWorld->getBoolConfig(CONFIG_MAP_UNIT_POSITION_INDEX) && (containerTypeMask & (GRID_MAP_TYPE_MASK_PLAYER | GRID_MAP_TYPE_MASK_CREATURE)))
+    {
+        UnitPositionIndex::UnitList units;
+        caster->GetMap()->GetUnitPositionIndex().QueryRadius(*position, range, containerTypeMask, units);
+        for (Unit* unit : units)
+            if (check(unit))
+                targets.push_back(unit);
+
+        containerTypeMask &= ~(GRID_MAP_TYPE_MASK_PLAYER | GRID_MAP_TYPE_MASK_CREATURE);
+    }
+
     Trinity::WorldObjectListSearcher<Trinity::WorldObjectSpellAreaTargetCheck> searcher(caster, targets, check, containerTypeMask);
     SearchTargets<Trinity::WorldObjectListSearcher<Trinity::WorldObjectSpellAreaTargetCheck> > (searcher, containerTypeMask, caster, position, range);
 }
@@ -2334,7 +2380,7 @@ void Spell::AddUnitTarget(Unit* target, uint32 effectMask, bool checkIfValid /*=
     // This is new target calculate data for him
 
     // Get spell hit result on target
-    TargetInfoPtr targetInfo = std::make_shared<TargetInfo>(targetGUID, effectMask);
+    TargetInfoPtr targetInfo = m_targetInfoArena.Create(targetGUID, effectMask);
 
     if (target->IsAlive())
         targetInfo->AddMask(TARGET_INFO_ALIVE);
@@ -2432,7 +2478,7 @@ void Spell::AddTargetVisualHit(Unit* target)
         return;
 
     // Get spell hit result on target
-    TargetInfoPtr targetInfo = std::make_shared<TargetInfo>(target->GetGUID(), m_spellInfo->EffectMask);
+    TargetInfoPtr targetInfo = m_targetInfoArena.Create(target->GetGUID(), m_spellInfo->EffectMask);
 
     if (target->IsAlive())
         targetInfo->AddMask(TARGET_INFO_ALIVE);
@@ -3055,7 +3101,7 @@ void Spell::DoAllEffectOnTarget(TargetInfoPtr target)
 
 TargetInfoPtr Spell::GetTargetInfo(ObjectGuid const& targetGUID)
 {
-    TargetInfoPtr infoTarget;
+    TargetInfoPtr infoTarget = nullptr;
     if (m_UniqueTargetInfo.empty())
         return infoTarget;
 
@@ -355,6 +355,10 @@ class TC_GAME_API Spell
         Spell(Unit* caster, SpellInfo const* info, TriggerCastData& triggerData);
         ~Spell();
 
+        // storage comes from sSpellPool, casts do not hit the heap for the Spell itself
+        static void* operator new(std::size_t size);
+        static void operator delete(void* storage, std::size_t size);
+
         void InitExplicitTargets(SpellCastTargets const& targets);
         void SelectExplicitTargets();
 
@@ -660,6 +664,7 @@ class TC_GAME_API Spell
         // *****************************************
         // Spell target subsystem
         // *****************************************
+        TargetInfoArena m_targetInfoArena;                       // owns the TargetInfo of both lists
         std::vector<TargetInfoPtr> m_UniqueTargetInfo;
         std::vector<TargetInfoPtr> m_VisualHitTargetInfo;
         TargetInfoPtr GetTargetInfo(ObjectGuid const& targetGUID);
@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2008-2017 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "SpellPool.h"
+#include "Spell.h"
+
+#include <new>
+
+SpellPool* SpellPool::instance()
+{
+    static SpellPool instance;
+    return &instance;
+}
+
+void* SpellPool::Allocate(std::size_t size)
+{
+    void* storage;
+    if (size != sizeof(Spell) || !_pool.Acquire(storage))
+        storage = ::operator new(size);
+    return storage;
+}
+
+void SpellPool::Deallocate(void* storage, std::size_t size)
+{
+    if (!storage)
+        return;
+
+    if (size != sizeof(Spell))
+        ::operator delete(storage);
+    else
+        _pool.Release(std::move(storage));
+}
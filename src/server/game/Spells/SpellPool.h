@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2008-2017 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef TRINITY_SPELL_POOL_H
+#define TRINITY_SPELL_POOL_H
+
+#include "ThreadCachedPool.h"
+
+/// Recycles the storage of Spell objects, used by Spell::operator new / delete.
+/// Every map update thread keeps a small free list and exchanges batches with a shared
+/// depot, spells finished on another thread than the one that cast them (caster changed
+/// map, session threads) go back through the depot.
+class TC_GAME_API SpellPool
+{
+public:
+    static std::size_t const ThreadCacheCount = 64;
+    static std::size_t const DepotCount = 4096;
+
+    typedef Trinity::ThreadCachedPool<void*, SpellPool> Pool;
+    typedef Pool::Stats Stats;
+
+    static SpellPool* instance();
+
+    void* Allocate(std::size_t size);
+    void Deallocate(void* storage, std::size_t size);
+
+    Stats GetStats() const { return _pool.GetStats(); }
+
+private:
+    SpellPool() : _pool(ThreadCacheCount, DepotCount) { }
+    ~SpellPool() = default;
+
+    Pool _pool;
+};
+
+#define sSpellPool SpellPool::instance()
+
+#endif
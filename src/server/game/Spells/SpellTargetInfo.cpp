@@ -64,6 +64,24 @@ TargetInfo::TargetInfo()
     scaleAura = false;
 }
 
+TargetInfo* TargetInfoArena::Create(ObjectGuid targetGUID, uint32 effectMask)
+{
+    TargetInfo* info;
+    if (_size < InlineCount)
+        info = &_inline[_size];
+    else
+    {
+        std::size_t index = (_size - InlineCount) % ChunkCount;
+        if (!index)
+            _chunks.emplace_back(new TargetInfo[ChunkCount]);
+        info = &_chunks.back()[index];
+    }
+
+    ++_size;
+    *info = TargetInfo(targetGUID, effectMask);
+    return info;
+}
+
 bool TargetInfo::HasMask(uint32 Mask) const
 {
     return targetInfoMask & Mask;
@@ -23,6 +23,10 @@
 #include "ObjectMgr.h"
 #include "SpellInfo.h"
 
+#include <array>
+#include <memory>
+#include <vector>
+
 class Unit;
 class Player;
 class GameObject;
@@ -92,7 +96,29 @@ private:
     uint32 targetInfoMask;
 };
 
-typedef std::shared_ptr<TargetInfo> TargetInfoPtr;
+// owned by the TargetInfoArena of the spell, valid until the spell is destroyed
+typedef TargetInfo* TargetInfoPtr;
+
+/// Storage for the unit targets of one spell. Entries never move, the first InlineCount
+/// live inside the arena (and so inside the pooled Spell), larger target lists add chunks.
+class TC_GAME_API TargetInfoArena
+{
+public:
+    static std::size_t const InlineCount = 32;
+    static std::size_t const ChunkCount = 64;
+
+    TargetInfoArena() : _size(0) { }
+    TargetInfoArena(TargetInfoArena const&) = delete;
+    TargetInfoArena& operator=(TargetInfoArena const&) = delete;
+
+    TargetInfo* Create(ObjectGuid targetGUID, uint32 effectMask);
+    std::size_t GetSize() const { return _size; }
+
+private:
+    std::array<TargetInfo, InlineCount> _inline;
+    std::vector<std::unique_ptr<TargetInfo[]>> _chunks;
+    std::size_t _size;
+};
 
 enum WeightType
 {
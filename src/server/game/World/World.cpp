@@ -41,6 +41,7 @@
 #include "ChallengeMgr.h"
 #include "Channel.h"
 #include "CharacterData.h"
+#include "CharacterSaveScheduler.h"
 #include "CharacterDatabaseCleaner.h"
 #include "Chat.h"
 #include "ChatPackets.h"
@@ -76,6 +77,7 @@
 #include "LootMgr.h"
 #include "MMapFactory.h"
 #include "MapManager.h"
+#include "MapTickProfiler.h"
 #include "MiscPackets.h"
 #include "ObjectMgr.h"
 #include "Opcodes.h"
@@ -89,6 +91,7 @@
 #include "ScriptMgr.h"
 #include "ScriptReloadMgr.h"
 #include "ScriptsData.h"
+#include "SharedWorldPacket.h"
 #include "SkillDiscovery.h"
 #include "SkillExtraItems.h"
 #include "SmartAI.h"
@@ -107,6 +110,7 @@
 #include "WeatherMgr.h"
 #include "WildBattlePet.h"
 #include "WordFilterMgr.h"
+#include "WorldLoader.h"
 #include "WorldPacket.h"
 #include "WorldSession.h"
 #include "WorldStateMgr.h"
@@ -680,6 +684,8 @@ void World::LoadConfigSettings(bool reload)
     m_int_configs[CONFIG_PRESERVE_CUSTOM_CHANNEL_DURATION] = sConfigMgr->GetIntDefault("PreserveCustomChannelDuration", 14);
     m_bool_configs[CONFIG_GRID_UNLOAD] = sConfigMgr->GetBoolDefault("GridUnload", true);
     m_int_configs[CONFIG_INTERVAL_SAVE] = sConfigMgr->GetIntDefault("PlayerSaveInterval", 15 * MINUTE * IN_MILLISECONDS);
+    m_int_configs[CONFIG_INTERVAL_SAVE_COALESCE] = sConfigMgr->GetIntDefault("PlayerSave.CoalesceWindow", 2 * IN_MILLISECONDS);
+    m_int_configs[CONFIG_INTERVAL_SAVE_MAX_DELAY] = sConfigMgr->GetIntDefault("PlayerSave.MaxDelay", 30 * IN_MILLISECONDS);
     m_int_configs[CONFIG_INTERVAL_DISCONNECT_TOLERANCE] = sConfigMgr->GetIntDefault("DisconnectToleranceInterval", 0);
 
     m_int_configs[CONFIG_INTERVAL_GRIDCLEAN] = sConfigMgr->GetIntDefault("GridCleanUpDelay", 5 * MINUTE * IN_MILLISECONDS);
@@ -1261,6 +1267,10 @@ void World::LoadConfigSettings(bool reload)
         TC_LOG_INFO("server.loading", "Using DataDir %s", m_dataPath.c_str());
     }
 
+    m_int_configs[CONFIG_DB2_LOAD_THREADS] = sConfigMgr->GetIntDefault("DB2.LoadThreads", 0);
+    m_int_configs[CONFIG_WORLD_LOAD_THREADS] = sConfigMgr->GetIntDefault("World.LoadThreads", 0);
+    m_bool_configs[CONFIG_STARTUP_SNAPSHOT] = sConfigMgr->GetBoolDefault("StartupSnapshot.Enable", false);
+
     // MMap related
     m_bool_configs[CONFIG_ENABLE_MMAPS] = sConfigMgr->GetBoolDefault("mmap.enablePathFinding", true);
     TC_LOG_INFO("server.loading", "WORLD: MMap data directory is: %smmaps", m_dataPath.c_str());
@@ -1295,8 +1305,19 @@ void World::LoadConfigSettings(bool reload)
 
     m_bool_configs[CONFIG_NO_RESET_TALENT_COST] = sConfigMgr->GetBoolDefault("NoResetTalentsCost", false);
     m_bool_configs[CONFIG_SHOW_KICK_IN_WORLD] = sConfigMgr->GetBoolDefault("ShowKickInWorld", false);
-    m_int_configs[CONFIG_NUMTHREADS] = sConfigMgr->GetIntDefault("MapUpdate.Threads", 1);
+    m_int_configs[CONFIG_NUMTHREADS] = sConfigMgr->GetIntDefault("MapUpdate.Threads", 0);
+    m_bool_configs[CONFIG_MAP_PIN_THREADS] = sConfigMgr->GetBoolDefault("MapUpdate.PinThreads", false);
     m_int_configs[CONFIG_MAP_NUMTHREADS] = sConfigMgr->GetIntDefault("MapUpdate.Map.Threads", 1);
+    m_bool_configs[CONFIG_MAP_UNIT_POSITION_INDEX] = sConfigMgr->GetBoolDefault("MapUpdate.UnitPositionIndex", true);
+    m_float_configs[CONFIG_MAP_UNIT_POSITION_INDEX_SLACK] = sConfigMgr->GetFloatDefault("MapUpdate.UnitPositionIndex.Slack", 10.0f);
+    if (m_float_configs[CONFIG_MAP_UNIT_POSITION_INDEX_SLACK] < 0.0f)
+    {
+        TC_LOG_ERROR("server.loading", "MapUpdate.UnitPositionIndex.Slack (%f) must be >= 0. Using 10.0 instead.", m_float_configs[CONFIG_MAP_UNIT_POSITION_INDEX_SLACK]);
+        m_float_configs[CONFIG_MAP_UNIT_POSITION_INDEX_SLACK] = 10.0f;
+    }
+    m_bool_configs[CONFIG_MAP_PROFILER] = sConfigMgr->GetBoolDefault("MapUpdate.Profiler", false);
+    m_int_configs[CONFIG_MAP_PROFILER_SLOW_OBJECT] = sConfigMgr->GetIntDefault("MapUpdate.Profiler.SlowObject", 5000);
+    m_int_configs[CONFIG_MAP_PROFILER_DUMP_INTERVAL] = sConfigMgr->GetIntDefault("MapUpdate.Profiler.DumpInterval", 0);
     m_int_configs[CONFIG_MAX_RESULTS_LOOKUP_COMMANDS] = sConfigMgr->GetIntDefault("Command.LookupMaxResults", 0);
 
     // chat logging
@@ -1619,7 +1640,7 @@ void World::SetInitialWorldSettings()
     CharacterDatabase.Execute(stmt);
 
     TC_LOG_INFO("server.loading", "Loading db2 info...");
-    m_availableDbcLocaleMask = sDB2Manager.LoadStores(m_dataPath, m_defaultDbcLocale);
+    m_availableDbcLocaleMask = sDB2Manager.LoadStores(m_dataPath, m_defaultDbcLocale, getIntConfig(CONFIG_DB2_LOAD_THREADS));
 
     TC_LOG_INFO("server.loading", "Loading hotfix info...");
     sDB2Manager.LoadHotfixData();
@@ -1685,149 +1706,219 @@ void World::SetInitialWorldSettings()
         sObjectMgr->RestructGameObjectGUID();
     }
 
-    std::thread locales([]() -> void
-    {
-        TC_LOG_INFO("server.loading", "Loading Localization strings...");
-        uint32 oldMSTime = getMSTime();
-        sObjectMgr->LoadCreatureLocales();
-        sObjectMgr->LoadGameObjectLocales();
-        sQuestDataStore->LoadQuestTemplateLocale();
-        sQuestDataStore->LoadQuestOfferRewardLocale();
-        sQuestDataStore->LoadQuestRequestItemsLocale();
-        sQuestDataStore->LoadQuestObjectivesLocale();
-        sObjectMgr->LoadPageTextLocales();
-        sGossipDataStore->LoadGossipMenuItemsLocales();
-        sQuestDataStore->LoadPointOfInterestLocales();
-        TC_LOG_INFO("server.loading", ">> Localization strings loaded in %u ms", GetMSTimeDiffToNow(oldMSTime));
-    });
+    uint32 loadThreads = WorldLoader::GetConfiguredThreads();
+
+    // localization strings are only read by clients, they load in the background until the world is up
+    WorldLoader locales("Localization strings");
+    locales.Add("creature locales", {}, { "creature_locales" }, []() { sObjectMgr->LoadCreatureLocales(); });
+    locales.Add("gameobject locales", {}, { "gameobject_locales" }, []() { sObjectMgr->LoadGameObjectLocales(); });
+    locales.Add("quest template locales", {}, { "quest_locales" }, []() { sQuestDataStore->LoadQuestTemplateLocale(); });
+    locales.Add("quest offer reward locales", {}, { "quest_locales" }, []() { sQuestDataStore->LoadQuestOfferRewardLocale(); });
+    locales.Add("quest request items locales", {}, { "quest_locales" }, []() { sQuestDataStore->LoadQuestRequestItemsLocale(); });
+    locales.Add("quest objectives locales", {}, { "quest_locales" }, []() { sQuestDataStore->LoadQuestObjectivesLocale(); });
+    locales.Add("page text locales", {}, { "page_text_locales" }, []() { sObjectMgr->LoadPageTextLocales(); });
+    locales.Add("gossip menu items locales", {}, { "gossip_locales" }, []() { sGossipDataStore->LoadGossipMenuItemsLocales(); });
+    locales.Add("points of interest locales", {}, { "quest_locales" }, []() { sQuestDataStore->LoadPointOfInterestLocales(); });
+    TC_LOG_INFO("server.loading", "Loading Localization strings...");
+    locales.Start(loadThreads > 1 ? 1 : 0);
 
     sObjectMgr->SetDBCLocaleIndex(GetDefaultDbcLocale());        // Get once for all the locale index of DBC language (console/broadcasts)
 
-    TC_LOG_INFO("server.loading","Loading Letter Analogs...");
-    sWordFilterMgr->LoadLetterAnalogs();
+    // every stage declares the stores it reads and writes, see WorldLoader
+    WorldLoader templates("Templates");
 
-    TC_LOG_INFO("server.loading","Loading Bad Words...");
-    sWordFilterMgr->LoadBadWords();
-    
-    TC_LOG_INFO("server.loading","Loading Bad Sentences...");
-    sWordFilterMgr->LoadBadSentences();
-    
-    TC_LOG_INFO("server.loading","Loading Complaints...");
-    sWordFilterMgr->LoadComplaints();
+    templates.Add("word filter", {}, { "word_filter" }, []()
+    {
+        TC_LOG_INFO("server.loading", "Loading Letter Analogs...");
+        sWordFilterMgr->LoadLetterAnalogs();
 
-    TC_LOG_INFO("server.loading", "Loading Page Texts...");
-    sObjectMgr->LoadPageTexts();
+        TC_LOG_INFO("server.loading", "Loading Bad Words...");
+        sWordFilterMgr->LoadBadWords();
 
-    TC_LOG_INFO("server.loading", "Loading Game Object Templates...");         // must be after LoadPageTexts
-    sObjectMgr->LoadGameObjectTemplate();
+        TC_LOG_INFO("server.loading", "Loading Bad Sentences...");
+        sWordFilterMgr->LoadBadSentences();
 
-    TC_LOG_INFO("server.loading", "Loading Transport templates...");
-    sTransportMgr->LoadTransportTemplates();
+        TC_LOG_INFO("server.loading", "Loading Complaints...");
+        sWordFilterMgr->LoadComplaints();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Transport animations and rotations...");
-    sTransportMgr->LoadTransportAnimationAndRotation();
+    templates.Add("page texts", {}, { "page_texts" }, []()
+    {
+        TC_LOG_INFO("server.loading", "Loading Page Texts...");
+        sObjectMgr->LoadPageTexts();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Spell Rank Data...");
-    sSpellMgr->LoadSpellRanks();
+    templates.Add("gameobject templates", { "page_texts" }, { "gameobject_templates" }, []()
+    {
+        TC_LOG_INFO("server.loading", "Loading Game Object Templates...");
+        sObjectMgr->LoadGameObjectTemplate();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Spell Required Data...");
-    sSpellMgr->LoadSpellRequired();
+    templates.Add("transports", { "gameobject_templates" }, { "transports" }, []()
+    {
+        TC_LOG_INFO("server.loading", "Loading Transport templates...");
+        sTransportMgr->LoadTransportTemplates();
 
-    TC_LOG_INFO("server.loading", "Loading Spell Group types...");
-    sSpellMgr->LoadSpellGroups();
+        TC_LOG_INFO("server.loading", "Loading Transport animations and rotations...");
+        sTransportMgr->LoadTransportAnimationAndRotation();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Spell Learn Skills...");
-    sSpellMgr->LoadSpellLearnSkills();                           // must be after LoadSpellRanks
+    // the spell loaders all fill or adjust SpellMgr data, they stay one chain
+    templates.Add("spell ranks", {}, { "spells" }, []()
+    {
+        TC_LOG_INFO("server.loading", "Loading Spell Rank Data...");
+        sSpellMgr->LoadSpellRanks();
 
-    TC_LOG_INFO("server.loading", "Loading Spell Learn Spells...");
-    sSpellMgr->LoadSpellLearnSpells();
+        TC_LOG_INFO("server.loading", "Loading Spell Required Data...");
+        sSpellMgr->LoadSpellRequired();
 
-    TC_LOG_INFO("server.loading", "Loading Spell Proc Event conditions...");
-    sSpellMgr->LoadSpellProcEvents();
+        TC_LOG_INFO("server.loading", "Loading Spell Group types...");
+        sSpellMgr->LoadSpellGroups();
 
-    TC_LOG_INFO("server.loading", "Loading Spell Proc conditions and data...");
-    sSpellMgr->LoadSpellProcs();
+        TC_LOG_INFO("server.loading", "Loading Spell Learn Skills...");
+        sSpellMgr->LoadSpellLearnSkills();                       // must be after LoadSpellRanks
 
-    TC_LOG_INFO("server.loading", "Loading Spell Bonus Data...");
-    sSpellMgr->LoadSpellBonusess();
+        TC_LOG_INFO("server.loading", "Loading Spell Learn Spells...");
+        sSpellMgr->LoadSpellLearnSpells();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Aggro Spells Definitions...");
-    sSpellMgr->LoadSpellThreats();
+    templates.Add("spell procs", {}, { "spells" }, []()
+    {
+        TC_LOG_INFO("server.loading", "Loading Spell Proc Event conditions...");
+        sSpellMgr->LoadSpellProcEvents();
 
-    TC_LOG_INFO("server.loading", "Loading Spell Group Stack Rules...");
-    sSpellMgr->LoadSpellGroupStackRules();
+        TC_LOG_INFO("server.loading", "Loading Spell Proc conditions and data...");
+        sSpellMgr->LoadSpellProcs();
+    });
 
-    sSpellMgr->LoadSpellInfoSpellSpecificAndAuraState();
+    templates.Add("spell bonuses", {}, { "spells" }, []()
+    {
+        TC_LOG_INFO("server.loading", "Loading Spell Bonus Data...");
+        sSpellMgr->LoadSpellBonusess();
 
-    TC_LOG_INFO("server.loading", "Loading forbidden spells...");
-    sSpellMgr->LoadForbiddenSpells();
+        TC_LOG_INFO("server.loading", "Loading Aggro Spells Definitions...");
+        sSpellMgr->LoadSpellThreats();
 
-    TC_LOG_INFO("server.loading", "Loading Spell Phase Dbc Info...");
-    sObjectMgr->LoadSpellPhaseInfo();
+        TC_LOG_INFO("server.loading", "Loading Spell Group Stack Rules...");
+        sSpellMgr->LoadSpellGroupStackRules();
 
-    sAreaTriggerDataStore->LoadAreaTriggerForces();
+        sSpellMgr->LoadSpellInfoSpellSpecificAndAuraState();
 
-    TC_LOG_INFO("server.loading", "Loading NPC Texts...");
-    sObjectMgr->LoadNPCText();
+        TC_LOG_INFO("server.loading", "Loading forbidden spells...");
+        sSpellMgr->LoadForbiddenSpells();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Enchant Spells Proc datas...");
-    sSpellMgr->LoadSpellEnchantProcData();
+    templates.Add("spell phases", { "spells" }, { "spell_phases" }, []()
+    {
+        TC_LOG_INFO("server.loading", "Loading Spell Phase Dbc Info...");
+        sObjectMgr->LoadSpellPhaseInfo();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Item Random Enchantments Table...");
-    LoadRandomEnchantmentsTable();
+    templates.Add("areatrigger forces", {}, { "areatrigger_forces" }, []() { sAreaTriggerDataStore->LoadAreaTriggerForces(); });
 
-    TC_LOG_INFO("server.loading", "Loading Disables");
-    DisableMgr::LoadDisables();                                 // must be before loading quests and items
+    templates.Add("npc texts", {}, { "npc_texts" }, []()
+    {
+        TC_LOG_INFO("server.loading", "Loading NPC Texts...");
+        sObjectMgr->LoadNPCText();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Items...");                         // must be after LoadRandomEnchantmentsTable and LoadPageTexts
-    sObjectMgr->LoadItemTemplates();
+    templates.Add("enchant proc data", {}, { "spells" }, []()
+    {
+        TC_LOG_INFO("server.loading", "Loading Enchant Spells Proc datas...");
+        sSpellMgr->LoadSpellEnchantProcData();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Item set names...");                // must be after LoadItemPrototypes
-    sObjectMgr->LoadItemTemplateAddon();
+    templates.Add("random enchantments", {}, { "item_enchantments" }, []()
+    {
+        TC_LOG_INFO("server.loading", "Loading Item Random Enchantments Table...");
+        LoadRandomEnchantmentsTable();
+    });
 
-    TC_LOG_INFO("misc", "Loading Item Scripts...");                 // must be after LoadItemPrototypes
-    sObjectMgr->LoadItemScriptNames();
+    templates.Add("disables", { "spells" }, { "disables" }, []()
+    {
+        TC_LOG_INFO("server.loading", "Loading Disables");
+        DisableMgr::LoadDisables();                             // must be before loading quests and items
+    });
 
-    sConversationDataStore->LoadConversationData();
+    templates.Add("items", { "item_enchantments", "page_texts", "disables" }, { "items" }, []()
+    {
+        TC_LOG_INFO("server.loading", "Loading Items...");
+        sObjectMgr->LoadItemTemplates();
 
-    TC_LOG_INFO("server.loading", "Loading Creature Model Based Info Data...");
-    sObjectMgr->LoadCreatureModelInfo();
-    
-    TC_LOG_INFO("server.loading", "Loading Creature template outfits..."); // must be before LoadCreatureTemplates
-    sObjectMgr->LoadCreatureOutfits();
+        TC_LOG_INFO("server.loading", "Loading Item set names...");
+        sObjectMgr->LoadItemTemplateAddon();
+
+        TC_LOG_INFO("misc", "Loading Item Scripts...");
+        sObjectMgr->LoadItemScriptNames();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Equipment templates...");
-    sObjectMgr->LoadEquipmentTemplates();
+    templates.Add("conversation data", {}, { "conversations" }, []() { sConversationDataStore->LoadConversationData(); });
 
-    TC_LOG_INFO("server.loading", "Loading Creature Texts...");
-    sCreatureTextMgr->LoadCreatureTexts();
+    templates.Add("creature models", {}, { "creature_models" }, []()
+    {
+        TC_LOG_INFO("server.loading", "Loading Creature Model Based Info Data...");
+        sObjectMgr->LoadCreatureModelInfo();
+    });
 
-    sObjectMgr->LoadWDBCreatureTemplates();
-    sObjectMgr->LoadCreatureTemplates();
-    sEventObjectDataStore->LoadEventObjectTemplates();
+    templates.Add("creature outfits", {}, { "creature_outfits" }, []()
+    {
+        TC_LOG_INFO("server.loading", "Loading Creature template outfits...");
+        sObjectMgr->LoadCreatureOutfits();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Creature template addons...");
-    sObjectMgr->LoadCreatureTemplateAddons();
+    templates.Add("equipment templates", { "items" }, { "equipment" }, []()
+    {
+        TC_LOG_INFO("server.loading", "Loading Equipment templates...");
+        sObjectMgr->LoadEquipmentTemplates();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Creature template scaling...");
-    sObjectMgr->LoadCreatureScalingData();
+    templates.Add("creature texts", { "spells" }, { "creature_texts" }, []()
+    {
+        TC_LOG_INFO("server.loading", "Loading Creature Texts...");
+        sCreatureTextMgr->LoadCreatureTexts();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Creature difficulty stat...");
-    sObjectMgr->LoadCreatureDifficultyStat();
+    templates.Add("creature templates", { "spells", "creature_models", "creature_outfits", "equipment", "creature_texts" }, { "creature_templates" }, []()
+    {
+        sObjectMgr->LoadWDBCreatureTemplates();
+        sObjectMgr->LoadCreatureTemplates();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Reputation Reward Rates...");
-    sObjectMgr->LoadReputationRewardRate();
+    templates.Add("eventobject templates", { "spells" }, { "eventobject_templates" }, []() { sEventObjectDataStore->LoadEventObjectTemplates(); });
 
-    TC_LOG_INFO("server.loading", "Loading Creature Reputation OnKill Data...");
-    sObjectMgr->LoadReputationOnKill();
+    templates.Add("creature template data", { "spells" }, { "creature_templates" }, []()
+    {
+        TC_LOG_INFO("server.loading", "Loading Creature template addons...");
+        sObjectMgr->LoadCreatureTemplateAddons();
 
-    TC_LOG_INFO("server.loading", "Loading Reputation Spillover Data...");
-    sObjectMgr->LoadReputationSpilloverTemplate();
+        TC_LOG_INFO("server.loading", "Loading Creature template scaling...");
+        sObjectMgr->LoadCreatureScalingData();
 
-    sQuestDataStore->LoadPointsOfInterest();
+        TC_LOG_INFO("server.loading", "Loading Creature difficulty stat...");
+        sObjectMgr->LoadCreatureDifficultyStat();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Creature Base Stats...");
-    sObjectMgr->LoadCreatureClassLevelStats();
+    templates.Add("reputation", { "creature_templates" }, { "reputation" }, []()
+    {
+        TC_LOG_INFO("server.loading", "Loading Reputation Reward Rates...");
+        sObjectMgr->LoadReputationRewardRate();
+
+        TC_LOG_INFO("server.loading", "Loading Creature Reputation OnKill Data...");
+        sObjectMgr->LoadReputationOnKill();
+
+        TC_LOG_INFO("server.loading", "Loading Reputation Spillover Data...");
+        sObjectMgr->LoadReputationSpilloverTemplate();
+    });
+
+    templates.Add("points of interest", {}, { "points_of_interest" }, []() { sQuestDataStore->LoadPointsOfInterest(); });
+
+    templates.Add("creature base stats", { "creature_templates" }, { "creature_base_stats" }, []()
+    {
+        TC_LOG_INFO("server.loading", "Loading Creature Base Stats...");
+        sObjectMgr->LoadCreatureClassLevelStats();
+    });
+
+    templates.Run(loadThreads);
 
     TC_LOG_INFO("server.loading", "Loading Creature Data...");
     sObjectMgr->LoadCreatures();
@@ -2168,6 +2259,8 @@ void World::SetInitialWorldSettings()
 
     m_timers[WUPDATE_CHECK_FILECHANGES].SetInterval(500);
 
+    m_timers[WUPDATE_MAP_PROFILE].SetInterval(std::max<uint32>(1, getIntConfig(CONFIG_MAP_PROFILER_DUMP_INTERVAL)) * IN_MILLISECONDS);
+
     //to set mailtimer to return mails every day between 4 and 5 am
     //mailtimer is increased when updating auctions
     //one second is 1000 -(tested on win system)
@@ -2292,7 +2385,7 @@ void World::SetInitialWorldSettings()
         if (m_realmName[i] != ' ')
             m_trimmedRealmName += m_realmName[i];
 
-    locales.join();
+    locales.Wait();
     uint32 startupDuration = GetMSTimeDiffToNow(startupBegin);
 
     TC_LOG_INFO("server.worldserver", "World initialized in %u minutes %u seconds", (startupDuration / 60000), ((startupDuration % 60000) / 1000));
@@ -2350,6 +2443,8 @@ void World::Update(uint32 diff)
             m_timers[i].SetCurrent(0);
     }
 
+    sCharacterSaveScheduler->Update(diff);
+
     /// Handle daily quests reset time
     if (currentGameTime > m_NextDailyQuestReset)
     {
@@ -2437,6 +2532,22 @@ void World::Update(uint32 diff)
         m_timers[WUPDATE_CHECK_FILECHANGES].Reset();
     }
 
+    /// <li> Write the map tick profiles reported since the last pass and ask the maps for the next window
+    if (m_timers[WUPDATE_MAP_PROFILE].Passed())
+    {
+        m_timers[WUPDATE_MAP_PROFILE].Reset();
+        if (getBoolConfig(CONFIG_MAP_PROFILER))
+        {
+            // reports also come from .server profile dump while periodic dumps are off
+            // relative to LogsDir, like the file appenders
+            std::string fileName = sLog->GetLogsDir() + sConfigMgr->GetStringDefault("MapUpdate.Profiler.DumpFile", "MapTickProfile.log");
+            if (!MapTickProfiler::FlushReports(fileName))
+                TC_LOG_ERROR("maps", "Can't write map tick profiles to %s", fileName.c_str());
+            if (getIntConfig(CONFIG_MAP_PROFILER_DUMP_INTERVAL))
+                MapTickProfiler::RequestReports();
+        }
+    }
+
     sWorldStateMgr.Update(diff);
     sContributionMgr.Update(diff);
 
@@ -2597,6 +2708,7 @@ void World::UpdateGlobalMessage()
     while (!aMessageQueue.empty())
     {
         GlobalMessageData* message = &aMessageQueue.front();
+        SharedWorldPacket shared(std::move(message->packet));
 
         for (SessionMap::const_iterator itr = m_sessions.begin(); itr != m_sessions.end(); ++itr)
         {
@@ -2606,7 +2718,7 @@ void World::UpdateGlobalMessage()
                 itr->second.get() != message->self &&
                 (message->team == 0 || itr->second->GetPlayer()->GetTeam() == message->team))
             {
-                itr->second->SendPacket(&message->packet);
+                itr->second->SendPacket(shared);
             }
         }
         aMessageQueue.pop();
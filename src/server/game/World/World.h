@@ -93,6 +93,7 @@ enum WorldTimers
     WUPDATE_BLACKMARKET,
     WUPDATE_AHBOT,
     WUPDATE_CHECK_FILECHANGES,
+    WUPDATE_MAP_PROFILE,
 
     WUPDATE_COUNT
 };
@@ -236,6 +237,10 @@ enum WorldBoolConfigs
     CONFIG_HOTSWAP_BUILD_FILE_RECREATION_ENABLED,
     CONFIG_HOTSWAP_INSTALL_ENABLED,
     CONFIG_HOTSWAP_PREFIX_CORRECTION_ENABLED,
+    CONFIG_MAP_PIN_THREADS,
+    CONFIG_MAP_UNIT_POSITION_INDEX,
+    CONFIG_MAP_PROFILER,
+    CONFIG_STARTUP_SNAPSHOT,
     BOOL_CONFIG_VALUE_COUNT
 };
 
@@ -256,6 +261,7 @@ enum WorldFloatConfigs
     CONFIG_ARCHAEOLOGY_RARE_MAXLEVEL_CHANCE,
     CONFIG_CAP_KILLPOINTS,
     CONFIG_CAP_KILL_CREATURE_POINTS,
+    CONFIG_MAP_UNIT_POSITION_INDEX_SLACK,
     FLOAT_CONFIG_VALUE_COUNT
 };
 
@@ -263,6 +269,8 @@ enum WorldIntConfigs
 {
     CONFIG_COMPRESSION = 0,
     CONFIG_INTERVAL_SAVE,
+    CONFIG_INTERVAL_SAVE_COALESCE,
+    CONFIG_INTERVAL_SAVE_MAX_DELAY,
     CONFIG_INTERVAL_GRIDCLEAN,
     CONFIG_INTERVAL_MAPUPDATE,
     CONFIG_INTERVAL_INSTANCE_UPDATE,
@@ -384,6 +392,10 @@ enum WorldIntConfigs
     CONFIG_PLAYER_ALLOW_COMMANDS,
     CONFIG_NUMTHREADS,
     CONFIG_MAP_NUMTHREADS,
+    CONFIG_MAP_PROFILER_SLOW_OBJECT,
+    CONFIG_MAP_PROFILER_DUMP_INTERVAL,
+    CONFIG_DB2_LOAD_THREADS,
+    CONFIG_WORLD_LOAD_THREADS,
     CONFIG_LOGDB_CLEARINTERVAL,
     CONFIG_LOGDB_CLEARTIME,
     CONFIG_CLIENTCACHE_VERSION,
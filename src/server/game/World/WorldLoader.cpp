@@ -0,0 +1,186 @@
+/*
+ * Copyright (C) 2008-2017 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "WorldLoader.h"
+#include "Errors.h"
+#include "Log.h"
+#include "StringFormat.h"
+#include "Timer.h"
+#include "World.h"
+
+#include <algorithm>
+
+WorldLoader::WorldLoader(std::string name) : _name(std::move(name)), _finished(0), _startTime(0), _started(false)
+{
+}
+
+WorldLoader::~WorldLoader()
+{
+    ASSERT(_workers.empty(), "WorldLoader %s destroyed while running", _name.c_str());
+}
+
+void WorldLoader::Add(char const* name, std::initializer_list<char const*> reads, std::initializer_list<char const*> writes, LoadFunction load)
+{
+    ASSERT(!_started, "WorldLoader %s: stage %s added after Start", _name.c_str(), name);
+
+    std::size_t index = _stages.size();
+    std::set<std::size_t> dependencies;
+
+    for (char const* store : reads)
+    {
+        auto writer = _lastWriter.find(store);
+        if (writer != _lastWriter.end())
+            dependencies.insert(writer->second);
+    }
+
+    for (char const* store : writes)
+    {
+        auto writer = _lastWriter.find(store);
+        if (writer != _lastWriter.end())
+            dependencies.insert(writer->second);
+
+        std::vector<std::size_t>& readers = _readers[store];
+        dependencies.insert(readers.begin(), readers.end());
+        readers.clear();
+    }
+
+    for (char const* store : writes)
+        _lastWriter[store] = index;
+
+    for (char const* store : reads)
+        if (std::find(writes.begin(), writes.end(), store) == writes.end())
+            _readers[store].push_back(index);
+
+    _stages.emplace_back();
+    Stage& stage = _stages.back();
+    stage.name = name;
+    stage.load = std::move(load);
+    stage.dependencies.assign(dependencies.begin(), dependencies.end());
+    stage.pending = uint32(dependencies.size());
+
+    for (std::size_t dependency : dependencies)
+        _stages[dependency].dependents.push_back(index);
+}
+
+void WorldLoader::Start(uint32 workers)
+{
+    _started = true;
+    _startTime = getMSTime();
+
+    for (std::size_t i = 0; i < _stages.size(); ++i)
+        if (!_stages[i].pending)
+            _ready.insert(i);
+
+    workers = std::min(workers, uint32(_stages.size()));
+    for (uint32 i = 0; i < workers; ++i)
+        _workers.emplace_back(&WorldLoader::Work, this);
+}
+
+void WorldLoader::Wait()
+{
+    Work();
+
+    for (std::thread& worker : _workers)
+        worker.join();
+
+    uint32 threads = uint32(_workers.size()) + 1;
+    _workers.clear();
+
+    LogReport(GetMSTimeDiffToNow(_startTime), threads);
+}
+
+void WorldLoader::Run(uint32 threads)
+{
+    Start(std::max(threads, 1u) - 1);
+    Wait();
+}
+
+uint32 WorldLoader::GetConfiguredThreads()
+{
+    if (uint32 threads = sWorld->getIntConfig(CONFIG_WORLD_LOAD_THREADS))
+        return threads;
+
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+void WorldLoader::Work()
+{
+    std::unique_lock<std::mutex> guard(_lock);
+    for (;;)
+    {
+        _condition.wait(guard, [this]() { return !_ready.empty() || _finished == _stages.size(); });
+        if (_ready.empty())
+            return;
+
+        std::size_t index = *_ready.begin();
+        _ready.erase(_ready.begin());
+        Stage& stage = _stages[index];
+
+        guard.unlock();
+        uint32 stageStart = getMSTime();
+        stage.load();
+        uint32 duration = GetMSTimeDiffToNow(stageStart);
+        guard.lock();
+
+        stage.duration = duration;
+        ++_finished;
+
+        for (std::size_t dependent : stage.dependents)
+            if (!--_stages[dependent].pending)
+                _ready.insert(dependent);
+
+        _condition.notify_all();
+    }
+}
+
+void WorldLoader::LogReport(uint32 wallTime, uint32 threads) const
+{
+    // longest chain of dependent stages ending at every stage, dependencies always have a lower index
+    std::vector<uint32> pathTime(_stages.size(), 0);
+    std::vector<std::size_t> pathPrevious(_stages.size(), _stages.size());
+    uint32 serialTime = 0;
+    std::size_t pathEnd = _stages.size();
+
+    for (std::size_t i = 0; i < _stages.size(); ++i)
+    {
+        Stage const& stage = _stages[i];
+        for (std::size_t dependency : stage.dependencies)
+        {
+            if (pathTime[dependency] >= pathTime[i])
+            {
+                pathTime[i] = pathTime[dependency];
+                pathPrevious[i] = dependency;
+            }
+        }
+
+        pathTime[i] += stage.duration;
+        serialTime += stage.duration;
+
+        if (pathEnd == _stages.size() || pathTime[i] > pathTime[pathEnd])
+            pathEnd = i;
+
+        TC_LOG_DEBUG("server.loading", "%s: stage %s took %u ms", _name.c_str(), stage.name.c_str(), stage.duration);
+    }
+
+    std::string path;
+    for (std::size_t i = pathEnd; i < _stages.size(); i = pathPrevious[i])
+        path.insert(0, Trinity::StringFormat("%s%s (%u ms)", pathPrevious[i] < _stages.size() ? " -> " : "", _stages[i].name.c_str(), _stages[i].duration));
+
+    TC_LOG_INFO("server.loading", ">> %s: %u stages in %u ms on %u threads, %u ms one after another", _name.c_str(), uint32(_stages.size()), wallTime, threads, serialTime);
+    if (pathEnd < _stages.size())
+        TC_LOG_INFO("server.loading", ">> %s critical path %u ms: %s", _name.c_str(), pathTime[pathEnd], path.c_str());
+}
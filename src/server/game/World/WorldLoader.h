@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2008-2017 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRINITY_WORLD_LOADER_H
+#define TRINITY_WORLD_LOADER_H
+
+#include "Define.h"
+
+#include <condition_variable>
+#include <functional>
+#include <initializer_list>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/*
+ * Runs startup loaders as a dependency graph.
+ *
+ * Every stage names the stores it reads and the stores it writes. A stage
+ * waits for every earlier stage that writes a store it touches and, when it
+ * writes a store itself, for every earlier stage reading it. Stages without
+ * such a conflict run side by side; conflicting stages keep the order they
+ * were added in, so with a single thread the stages run exactly in that order.
+ *
+ * When the graph is done the loader logs the wall time of every stage, the
+ * total and the critical path (the chain of dependent stages that bounds the
+ * wall time no matter how many threads are used).
+ */
+class TC_GAME_API WorldLoader
+{
+public:
+    typedef std::function<void()> LoadFunction;
+
+    explicit WorldLoader(std::string name);
+    ~WorldLoader();
+
+    WorldLoader(WorldLoader const&) = delete;
+    WorldLoader& operator=(WorldLoader const&) = delete;
+
+    void Add(char const* name, std::initializer_list<char const*> reads, std::initializer_list<char const*> writes, LoadFunction load);
+
+    /// Starts running the graph on `workers` background threads (none: nothing runs before Wait)
+    void Start(uint32 workers);
+    /// The calling thread joins the work until every stage is done, then the report is logged
+    void Wait();
+    /// Start and Wait with `threads` threads in total, the calling one included
+    void Run(uint32 threads);
+
+    /// Thread count from the World.LoadThreads setting
+    static uint32 GetConfiguredThreads();
+
+private:
+    struct Stage
+    {
+        std::string name;
+        LoadFunction load;
+        std::vector<std::size_t> dependencies;
+        std::vector<std::size_t> dependents;
+        uint32 pending = 0;
+        uint32 duration = 0;
+    };
+
+    void Work();
+    void LogReport(uint32 wallTime, uint32 threads) const;
+
+    std::string _name;
+    std::vector<Stage> _stages;
+    std::unordered_map<std::string, std::size_t> _lastWriter;
+    std::unordered_map<std::string, std::vector<std::size_t>> _readers;       // since the last writer
+
+    std::mutex _lock;
+    std::condition_variable _condition;
+    std::set<std::size_t> _ready;            // lowest index first, keeps the declared order with one thread
+    std::size_t _finished;
+    std::vector<std::thread> _workers;
+    uint32 _startTime;
+    bool _started;
+};
+
+#endif
@@ -0,0 +1,404 @@
+/*
+ * Copyright (C) 2008-2017 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* ScriptData
+Name: bench_commandscript
+%Complete: 100
+Comment: Micro benchmarks of the database, network, spell and aura hot paths
+Category: commandscripts
+EndScriptData */
+
+#include "ScriptMgr.h"
+#include "Chat.h"
+#include "DatabaseEnv.h"
+#include "MessageBufferPool.h"
+#include "Player.h"
+#include "PreparedResultStream.h"
+#include "SharedWorldPacket.h"
+#include "SpellMgr.h"
+#include "SpellPool.h"
+#include "World.h"
+#include "WorldSession.h"
+#include "WorldSocket.h"
+#include "WorldSocketMgr.h"
+#include <chrono>
+#include <deque>
+#include <sstream>
+#include <zlib.h>
+
+// only built with WITH_COREDEBUG, the benches block the calling thread and are no tool for live realms
+#ifdef TRINITY_DEBUG
+
+class bench_commandscript : public CommandScript
+{
+public:
+    bench_commandscript() : CommandScript("bench_commandscript") { }
+
+    std::vector<ChatCommand> GetCommands() const override
+    {
+        static std::vector<ChatCommand> benchCommandTable =
+        {
+            { "query",      SEC_ADMINISTRATOR,  true,  &HandleBenchQueryCommand,         ""},
+            { "dbqueue",    SEC_ADMINISTRATOR,  true,  &HandleBenchDatabaseQueueCommand, ""},
+            { "broadcast",  SEC_ADMINISTRATOR,  true,  &HandleBenchBroadcastCommand,     ""},
+            { "sendbuffer", SEC_ADMINISTRATOR,  true,  &HandleBenchSendBufferCommand,    ""},
+            { "spellcast",  SEC_ADMINISTRATOR,  false, &HandleBenchSpellCastCommand,     ""},
+            { "auramods",   SEC_ADMINISTRATOR,  false, &HandleBenchAuraModsCommand,      ""}
+        };
+        static std::vector<ChatCommand> commandTable =
+        {
+            { "bench",      SEC_ADMINISTRATOR,  true,  NULL,                             "", benchCommandTable }
+        };
+        return commandTable;
+    }
+
+    // .bench query [#runs] - reads waypoint_data through PreparedResultSet and PreparedResultStream and prints rows/sec of both
+    static bool HandleBenchQueryCommand(ChatHandler* handler, char const* args)
+    {
+        uint32 runs = std::max(1, atoi(args));
+
+        uint64 fieldRows = 0;
+        uint64 streamRows = 0;
+        double checksum = 0.0;
+        std::chrono::steady_clock::duration fieldTime = std::chrono::steady_clock::duration::zero();
+        std::chrono::steady_clock::duration streamTime = std::chrono::steady_clock::duration::zero();
+
+        for (uint32 i = 0; i < runs; ++i)
+        {
+            auto start = std::chrono::steady_clock::now();
+            if (PreparedQueryResult result = WorldDatabase.Query(WorldDatabase.GetPreparedStatement(WORLD_SEL_WAYPOINT_DATA_ALL)))
+            {
+                do
+                {
+                    Field* fields = result->Fetch();
+                    checksum += fields[0].GetUInt32() + fields[1].GetUInt32() + fields[2].GetFloat() + fields[3].GetFloat() + fields[4].GetFloat()
+                        + fields[5].GetFloat() + fields[6].GetUInt32() + fields[7].GetFloat() + fields[8].GetUInt32() + fields[9].GetUInt32()
+                        + fields[10].GetInt16() + fields[11].GetInt16();
+                    ++fieldRows;
+                } while (result->NextRow());
+            }
+            fieldTime += std::chrono::steady_clock::now() - start;
+
+            start = std::chrono::steady_clock::now();
+            TypedPreparedResultStream<uint32, uint32, float, float, float, float, uint32, float, uint32, uint32, int16, int16> rows;
+            if (WorldDatabase.StreamQuery(WorldDatabase.GetPreparedStatement(WORLD_SEL_WAYPOINT_DATA_ALL), rows))
+            {
+                while (rows.NextRow())
+                {
+                    checksum -= rows.Get<0>() + rows.Get<1>() + rows.Get<2>() + rows.Get<3>() + rows.Get<4>()
+                        + rows.Get<5>() + rows.Get<6>() + rows.Get<7>() + rows.Get<8>() + rows.Get<9>()
+                        + rows.Get<10>() + rows.Get<11>();
+                    ++streamRows;
+                }
+            }
+            streamTime += std::chrono::steady_clock::now() - start;
+        }
+
+        auto rowsPerSecond = [](uint64 rowCount, std::chrono::steady_clock::duration time)
+        {
+            double seconds = std::chrono::duration<double>(time).count();
+            return seconds > 0.0 ? uint64(rowCount / seconds) : 0;
+        };
+
+        handler->PSendSysMessage("waypoint_data, %u runs", runs);
+        handler->PSendSysMessage("Field:  " UI64FMTD " rows in " SI64FMTD " ms, " UI64FMTD " rows/sec", fieldRows,
+            int64(std::chrono::duration_cast<std::chrono::milliseconds>(fieldTime).count()), rowsPerSecond(fieldRows, fieldTime));
+        handler->PSendSysMessage("Stream: " UI64FMTD " rows in " SI64FMTD " ms, " UI64FMTD " rows/sec", streamRows,
+            int64(std::chrono::duration_cast<std::chrono::milliseconds>(streamTime).count()), rowsPerSecond(streamRows, streamTime));
+        if (fieldRows != streamRows || std::abs(checksum) > 1.0)
+            handler->PSendSysMessage("Results differ (checksum %f)", checksum);
+        return true;
+    }
+
+    template<class T>
+    static void SendDatabaseQueueStats(ChatHandler* handler, char const* name, DatabaseWorkerPool<T> const& pool)
+    {
+        static char const* const laneNames[MAX_DATABASE_LANES] = { "interactive", "login", "save", "log" };
+
+        handler->PSendSysMessage("%s: " SZFMTD " queued", name, pool.QueueSize());
+        for (uint8 i = 0; i < MAX_DATABASE_LANES; ++i)
+        {
+            DatabaseQueueStats stats = pool.GetQueueStats(DatabaseQueueLane(i));
+            if (!stats.Executed && !stats.Depth)
+                continue;
+
+            std::ostringstream histogram;
+            for (size_t bucket = 0; bucket < DatabaseQueueStats::LatencyBuckets; ++bucket)
+                histogram << (bucket ? " " : "") << stats.Latency[bucket];
+
+            handler->PSendSysMessage("  %-11s depth " SZFMTD " (peak " SZFMTD ")%s, " UI64FMTD " executed, wait ms <1/<2/<4/../>=1024: %s", laneNames[i],
+                stats.Depth, stats.PeakDepth, pool.IsBackpressured(DatabaseQueueLane(i)) ? " backpressured" : "", stats.Executed, histogram.str().c_str());
+        }
+    }
+
+    // .bench dbqueue - queue depth and queue wait histogram of every async database lane
+    static bool HandleBenchDatabaseQueueCommand(ChatHandler* handler, char const* /*args*/)
+    {
+        SendDatabaseQueueStats(handler, "Login", LoginDatabase);
+        SendDatabaseQueueStats(handler, "Character", CharacterDatabase);
+        SendDatabaseQueueStats(handler, "World", WorldDatabase);
+        SendDatabaseQueueStats(handler, "Hotfix", HotfixDatabase);
+        return true;
+    }
+
+    // .bench broadcast [#receivers] [#bytes] - cost of queueing one packet to many sockets,
+    // per socket copy and deflate (old path) against one SharedWorldPacket deflated once
+    static bool HandleBenchBroadcastCommand(ChatHandler* handler, char const* args)
+    {
+        Tokenizer tokens(args, ' ');
+        uint32 receivers = std::min(std::max(tokens.size() > 0 ? atoi(tokens[0]) : 40, 1), 200);
+        uint32 packetSize = std::min(std::max(tokens.size() > 1 ? atoi(tokens[1]) : 0x2000, int32(WorldSocket::MinSizeForCompression + 1)), 0x100000);
+        uint32 const iterations = 50;
+
+        // update fields like payload, compresses about as well as real broadcasts
+        WorldPacket packet(SMSG_UPDATE_OBJECT, packetSize);
+        for (uint32 i = 0; packetSize - packet.size() >= sizeof(uint32); ++i)
+            packet << uint32(i % 64 ? i / 16 : urand(0, 0xFFFF));
+
+        std::vector<z_stream> streams(receivers);
+        for (z_stream& stream : streams)
+        {
+            memset(&stream, 0, sizeof(stream));
+            deflateInit2(&stream, sWorld->getIntConfig(CONFIG_COMPRESSION), Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY);
+        }
+
+        std::vector<uint8> sendBuffer(compressBound(packetSize + 2) + 64);
+        uint64 copiedBytes = 0;
+
+        auto start = std::chrono::steady_clock::now();
+        for (uint32 i = 0; i < iterations; ++i)
+        {
+            for (z_stream& stream : streams)
+            {
+                WorldPacket queued(packet);
+                uint16 opcode = queued.GetOpcode();
+                stream.next_out = sendBuffer.data();
+                stream.avail_out = uint32(sendBuffer.size());
+                stream.next_in = reinterpret_cast<Bytef*>(&opcode);
+                stream.avail_in = sizeof(opcode);
+                deflate(&stream, Z_NO_FLUSH);
+                stream.next_in = const_cast<Bytef*>(queued.contents());
+                stream.avail_in = uint32(queued.size());
+                deflate(&stream, Z_SYNC_FLUSH);
+                copiedBytes += sendBuffer.size() - stream.avail_out;
+            }
+        }
+        std::chrono::duration<double> perSocket = std::chrono::steady_clock::now() - start;
+
+        for (z_stream& stream : streams)
+            deflateEnd(&stream);
+
+        start = std::chrono::steady_clock::now();
+        for (uint32 i = 0; i < iterations; ++i)
+        {
+            SharedWorldPacket shared(packet);
+            for (uint32 r = 0; r < receivers; ++r)
+            {
+                SharedWorldPacket queued(shared);
+                SharedWorldPacket::CompressedData const& compressed = queued.GetCompressed();
+                memcpy(sendBuffer.data(), compressed.Data.data(), compressed.Data.size());
+                copiedBytes -= compressed.Data.size();
+            }
+        }
+        std::chrono::duration<double> sharedOnce = std::chrono::steady_clock::now() - start;
+
+        uint64 const packets = uint64(iterations) * receivers;
+        handler->PSendSysMessage("%u byte packet to %u receivers, %u broadcasts", packetSize, receivers, iterations);
+        handler->PSendSysMessage("per socket: %.2f ms, %.0f packets/sec", perSocket.count() * 1000.0, perSocket.count() > 0.0 ? packets / perSocket.count() : 0.0);
+        handler->PSendSysMessage("shared:     %.2f ms, %.0f packets/sec", sharedOnce.count() * 1000.0, sharedOnce.count() > 0.0 ? packets / sharedOnce.count() : 0.0);
+        handler->PSendSysMessage("compressed size difference over all packets: " SI64FMTD " bytes", int64(copiedBytes));
+        return true;
+    }
+
+    // .bench sendbuffer [#packets] [#bytes] - per packet allocations of the socket send path,
+    // heap copies and a fresh send buffer per update against buffers recycled through the pool
+    static bool HandleBenchSendBufferCommand(ChatHandler* handler, char const* args)
+    {
+        Tokenizer tokens(args, ' ');
+        uint32 packetCount = std::min(std::max(tokens.size() > 0 ? atoi(tokens[0]) : 200000, 1000), 5000000);
+        uint32 packetSize = std::min(std::max(tokens.size() > 1 ? atoi(tokens[1]) : 120, 1), 0x10000);
+        uint32 const packetsPerUpdate = 8;
+        std::size_t const sendBufferSize = sWorldSocketMgr.GetApplicationSendBufferSize();
+
+        WorldPacket packet(SMSG_UPDATE_OBJECT, packetSize);
+        packet.resize(packetSize);
+
+        std::deque<MessageBuffer> writeQueue;
+        uint64 writtenBytes = 0;
+
+        auto start = std::chrono::steady_clock::now();
+        for (uint32 i = 0; i < packetCount; i += packetsPerUpdate)
+        {
+            MessageBuffer buffer(sendBufferSize);
+            for (uint32 p = 0; p < packetsPerUpdate; ++p)
+            {
+                WorldPacket* queued = new WorldPacket(packet);
+                if (buffer.GetRemainingSpace() < queued->size())
+                {
+                    writeQueue.push_back(std::move(buffer));
+                    buffer.Resize(std::max(sendBufferSize, queued->size()));
+                }
+
+                buffer.Write(queued->contents(), queued->size());
+                delete queued;
+            }
+
+            writeQueue.push_back(std::move(buffer));
+            for (MessageBuffer& written : writeQueue)
+                writtenBytes += written.GetActiveSize();
+            writeQueue.clear();
+        }
+        std::chrono::duration<double> heap = std::chrono::steady_clock::now() - start;
+
+        MessageBufferPool::Stats before = sMessageBufferPool->GetStats();
+        start = std::chrono::steady_clock::now();
+        for (uint32 i = 0; i < packetCount; i += packetsPerUpdate)
+        {
+            MessageBuffer buffer(std::size_t(0));
+            for (uint32 p = 0; p < packetsPerUpdate; ++p)
+            {
+                std::vector<uint8> queued = sMessageBufferPool->AcquireStorage(packet.size());
+                memcpy(queued.data(), packet.contents(), packet.size());
+                if (buffer.GetRemainingSpace() < queued.size())
+                {
+                    if (buffer.GetActiveSize() > 0)
+                        writeQueue.push_back(std::move(buffer));
+                    buffer = sMessageBufferPool->Acquire(std::max(sendBufferSize, queued.size()));
+                }
+
+                buffer.Write(queued.data(), queued.size());
+                sMessageBufferPool->Release(std::move(queued));
+            }
+
+            writeQueue.push_back(std::move(buffer));
+            for (MessageBuffer& written : writeQueue)
+            {
+                writtenBytes -= written.GetActiveSize();
+                sMessageBufferPool->Release(std::move(written));
+            }
+            writeQueue.clear();
+        }
+        std::chrono::duration<double> pooled = std::chrono::steady_clock::now() - start;
+        MessageBufferPool::Stats after = sMessageBufferPool->GetStats();
+
+        handler->PSendSysMessage("%u packets of %u bytes, %u packets per socket update", packetCount, packetSize, packetsPerUpdate);
+        handler->PSendSysMessage("heap:   %.2f ms, %.0f packets/sec", heap.count() * 1000.0, heap.count() > 0.0 ? packetCount / heap.count() : 0.0);
+        handler->PSendSysMessage("pooled: %.2f ms, %.0f packets/sec, " UI64FMTD " buffers allocated", pooled.count() * 1000.0,
+            pooled.count() > 0.0 ? packetCount / pooled.count() : 0.0, after.Allocated - before.Allocated);
+        handler->PSendSysMessage("pool totals: " UI64FMTD " allocated, " UI64FMTD " fetched from depot, " UI64FMTD " returned to depot, " UI64FMTD " freed",
+            after.Allocated, after.DepotFetched, after.DepotReturned, after.Freed);
+        if (writtenBytes)
+            handler->PSendSysMessage("written size mismatch: " UI64FMTD " bytes", writtenBytes);
+        return true;
+    }
+
+    // .bench spellcast [#spellId] [#casts] - casts the spell triggered at the selected unit (or self) through
+    // the whole cast path: checks, target selection, effects and hits. Every cast really happens,
+    // so use a harmless spell on a test realm; prints casts/sec, targets hit and Spell allocations.
+    static bool HandleBenchSpellCastCommand(ChatHandler* handler, char const* args)
+    {
+        Player* player = handler->GetSession()->GetPlayer();
+
+        Tokenizer tokens(args, ' ');
+        uint32 spellId = tokens.size() > 0 ? atoi(tokens[0]) : 1449;
+        uint32 castCount = std::min(std::max(tokens.size() > 1 ? atoi(tokens[1]) : 1000, 1), 10000);
+
+        SpellInfo const* spellInfo = sSpellMgr->GetSpellInfo(spellId);
+        if (!spellInfo)
+        {
+            handler->PSendSysMessage("Spell %u does not exist", spellId);
+            handler->SetSentErrorMessage(true);
+            return false;
+        }
+
+        Unit* target = handler->getSelectedUnit();
+        if (!target)
+            target = player;
+
+        SpellPool::Stats before = sSpellPool->GetStats();
+        uint32 targetsBefore = player->_targetCount;
+        uint32 casted = 0;
+
+        auto start = std::chrono::steady_clock::now();
+        for (uint32 i = 0; i < castCount; ++i)
+            if (player->CastSpell(target, spellInfo, TRIGGERED_FULL_MASK) == SPELL_CAST_OK)
+                ++casted;
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        SpellPool::Stats after = sSpellPool->GetStats();
+        uint32 hits = player->_targetCount - targetsBefore;
+
+        handler->PSendSysMessage("spell %u, %u of %u casts succeeded, %u targets hit", spellId, casted, castCount, hits);
+        handler->PSendSysMessage("%.2f ms, %.0f casts/sec, %.0f targets/sec", elapsed.count() * 1000.0,
+            elapsed.count() > 0.0 ? castCount / elapsed.count() : 0.0, elapsed.count() > 0.0 ? hits / elapsed.count() : 0.0);
+        handler->PSendSysMessage("spells allocated: " UI64FMTD ", pool totals: " UI64FMTD " allocated, " UI64FMTD " fetched from depot, " UI64FMTD " returned to depot, " UI64FMTD " freed",
+            after.Allocated - before.Allocated, after.Allocated, after.DepotFetched, after.DepotReturned, after.Freed);
+        return true;
+    }
+
+    // .bench auramods [#auratype] [#queries] - GetTotalAuraModifier of the selected unit (or self) through the
+    // cached per type totals against the predicated walk over every effect of the type
+    static bool HandleBenchAuraModsCommand(ChatHandler* handler, char const* args)
+    {
+        Tokenizer tokens(args, ' ');
+        uint32 auraType = tokens.size() > 0 ? atoi(tokens[0]) : SPELL_AURA_MOD_DAMAGE_PERCENT_DONE;
+        uint32 queryCount = std::min(std::max(tokens.size() > 1 ? atoi(tokens[1]) : 1000000, 1000), 50000000);
+
+        if (auraType >= TOTAL_AURAS)
+        {
+            handler->PSendSysMessage("Aura type %u does not exist", auraType);
+            handler->SetSentErrorMessage(true);
+            return false;
+        }
+
+        Unit* target = handler->getSelectedUnit();
+        if (!target)
+            target = handler->GetSession()->GetPlayer();
+
+        AuraType type = AuraType(auraType);
+        int64 cachedSum = 0;
+        int64 walkedSum = 0;
+
+        auto start = std::chrono::steady_clock::now();
+        for (uint32 i = 0; i < queryCount; ++i)
+            cachedSum += target->GetTotalAuraModifier(type);
+        std::chrono::duration<double> cached = std::chrono::steady_clock::now() - start;
+
+        std::function<bool(AuraEffect const*)> const everyEffect = [](AuraEffect const* /*aurEff*/) { return true; };
+        start = std::chrono::steady_clock::now();
+        for (uint32 i = 0; i < queryCount; ++i)
+            walkedSum += target->GetTotalAuraModifier(type, everyEffect);
+        std::chrono::duration<double> walked = std::chrono::steady_clock::now() - start;
+
+        handler->PSendSysMessage("aura type %u on %s, %u effects, %u queries", auraType, target->GetName(),
+            uint32(target->GetAuraEffectsByType(type).size()), queryCount);
+        handler->PSendSysMessage("cached: %.2f ms, %.0f queries/sec", cached.count() * 1000.0, cached.count() > 0.0 ? queryCount / cached.count() : 0.0);
+        handler->PSendSysMessage("walked: %.2f ms, %.0f queries/sec", walked.count() * 1000.0, walked.count() > 0.0 ? queryCount / walked.count() : 0.0);
+        if (cachedSum != walkedSum)
+            handler->PSendSysMessage("Results differ (" SI64FMTD " cached, " SI64FMTD " walked)", cachedSum, walkedSum);
+        return true;
+    }
+};
+
+#endif
+
+void AddSC_bench_commandscript()
+{
+#ifdef TRINITY_DEBUG
+    new bench_commandscript();
+#endif
+}
@@ -368,9 +368,9 @@ public:
         sDB2Manager.Map2ZoneCoordinates(zoneX, zoneY, zoneId);
 
         Map const* map = object->GetMap();
-        float groundZ = map->GetHeight(object->GetPhases(), object->GetPositionX(), object->GetPositionY(), MAX_HEIGHT);
+        float groundZ = map->GetHeight(object->GetPhaseSet(), object->GetPositionX(), object->GetPositionY(), MAX_HEIGHT);
         DynamicTreeCallback dCallback;
-        float floorZ = map->GetHeight(object->GetPhases(), object->GetPositionX(), object->GetPositionY(), object->GetPositionZ(), true, DEFAULT_HEIGHT_SEARCH, &dCallback);
+        float floorZ = map->GetHeight(object->GetPhaseSet(), object->GetPositionX(), object->GetPositionY(), object->GetPositionZ(), true, DEFAULT_HEIGHT_SEARCH, &dCallback);
         float vmapZ = map->GetVmapHeight(object->GetPositionX(), object->GetPositionY(), object->GetPositionZ());
         GridCoord gridCoord = Trinity::ComputeGridCoord(object->GetPositionX(), object->GetPositionY());
 
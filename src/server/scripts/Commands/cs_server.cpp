@@ -29,6 +29,8 @@ EndScriptData */
 #include "GameTime.h"
 #include "GitRevision.h"
 #include "MapManager.h"
+#include "MapTickProfiler.h"
+#include "MapUpdateScheduler.h"
 #include "MySQLThreading.h"
 #include "ObjectAccessor.h"
 #include "ScriptMgr.h"
@@ -70,6 +72,13 @@ public:
             { ""   ,            SEC_ADMINISTRATOR,  true,  &HandleServerShutDownCommand,            ""}
         };
 
+        static std::vector<ChatCommand> serverProfileCommandTable =
+        {
+            { "dump",           SEC_ADMINISTRATOR,  true,  &HandleServerProfileDumpCommand,         ""},
+            { "reset",          SEC_ADMINISTRATOR,  false, &HandleServerProfileResetCommand,        ""},
+            { ""   ,            SEC_ADMINISTRATOR,  false, &HandleServerProfileCommand,             ""}
+        };
+
         static std::vector<ChatCommand> serverSetCommandTable =
         {
             { "difftime",       SEC_CONSOLE,        true,  &HandleServerSetDiffTimeCommand,         ""},
@@ -89,6 +98,7 @@ public:
             { "info",            SEC_PLAYER,         true,  &HandleServerInfoCommand,                ""},
             { "motd",            SEC_PLAYER,         true,  &HandleServerMotdCommand,                ""},
             { "plimit",          SEC_ADMINISTRATOR,  true,  &HandleServerPLimitCommand,              ""},
+            { "profile",         SEC_ADMINISTRATOR,  true,  NULL,                                    "", serverProfileCommandTable },
             { "restart",         SEC_ADMINISTRATOR,  true,  NULL,                                    "", serverRestartCommandTable },
             { "shutdown",        SEC_ADMINISTRATOR,  true,  NULL,                                    "", serverShutdownCommandTable },
             { "set",             SEC_ADMINISTRATOR,  true,  NULL,                                    "", serverSetCommandTable }
@@ -258,6 +268,7 @@ public:
         uint32 updateTime           = sWorldUpdateTime.GetLastUpdateTime();
         uint32 updateTimeMap        = 0;
         uint32 updateSessionTime    = 0;
+        Map* tickMap                = nullptr;
         if (auto const& session = handler->GetSession())
         {
             if (Player* player = session->GetPlayer())
@@ -266,11 +277,13 @@ public:
                 {
                     updateTimeMap = player->GetMap()->GetUpdateTime();
                     updateSessionTime = player->GetMap()->GetSessionTime();
+                    tickMap = player->GetMap();
                 }
                 else if (Map* map = sMapMgr->FindBaseNonInstanceMap(player->GetMapId()))
                 {
                     updateTimeMap = map->GetUpdateTime();
                     updateSessionTime = map->GetSessionTime();
+                    tickMap = map;
                 }
             }
         }
@@ -281,6 +294,12 @@ public:
         handler->PSendSysMessage("World delay: %u ms", updateTime);
         handler->PSendSysMessage("Map delay: %u ms diff %u", updateTimeMap, sWorld->getIntConfig(CONFIG_INTERVAL_MAPUPDATE));
         handler->PSendSysMessage("Session delay: %u ms diff %u", updateSessionTime, sWorld->getIntConfig(CONFIG_INTERVAL_MAP_SESSION_UPDATE));
+        if (tickMap)
+        {
+            Trinity::LatencyHistogram const& jitter = tickMap->GetTickJitter();
+            handler->PSendSysMessage("Map tick jitter: p50 %u us p99 %u us max %u us (%u late ticks)", jitter.GetPercentile(50.0), jitter.GetPercentile(99.0), jitter.GetMax(), uint32(jitter.GetCount()));
+        }
+        handler->PSendSysMessage("Map scheduler: %u maps, %u parked, " UI64FMTD " wakes", sMapUpdateScheduler->GetTaskCount(), sMapUpdateScheduler->GetParkedCount(), sMapUpdateScheduler->GetWakeCount());
 
         // Can't use sWorld->ShutdownMsg here in case of console command
         if (sWorld->IsShuttingDown())
@@ -288,6 +307,52 @@ public:
 
         return true;
     }
+    // Tick phases of the map (or instance) the player is on, since the last reset or dump
+    static bool HandleServerProfileCommand(ChatHandler* handler, char const* /*args*/)
+    {
+        Player* player = handler->GetSession()->GetPlayer();
+        Map* map = player->GetMap();
+        if (!map)
+            return false;
+
+        if (!MapTickProfiler::IsEnabled())
+        {
+            handler->PSendSysMessage("Map tick profiler is disabled (MapUpdate.Profiler).");
+            return true;
+        }
+
+        MapTickProfiler& profiler = map->GetTickProfiler();
+        handler->PSendSysMessage("Map %u instance %u, last %u s:", map->GetId(), map->GetInstanceId(), profiler.GetWindowSeconds());
+
+        std::vector<std::string> lines;
+        profiler.BuildReport(lines);
+        for (std::string const& line : lines)
+            handler->SendSysMessage(line.c_str());
+
+        return true;
+    }
+
+    static bool HandleServerProfileResetCommand(ChatHandler* handler, char const* /*args*/)
+    {
+        if (Map* map = handler->GetSession()->GetPlayer()->GetMap())
+            map->GetTickProfiler().Reset();
+        return true;
+    }
+
+    // Every map writes its profile to MapUpdate.Profiler.DumpFile at its next update
+    static bool HandleServerProfileDumpCommand(ChatHandler* handler, char const* /*args*/)
+    {
+        if (!MapTickProfiler::IsEnabled())
+        {
+            handler->PSendSysMessage("Map tick profiler is disabled (MapUpdate.Profiler).");
+            return true;
+        }
+
+        MapTickProfiler::RequestReports();
+        handler->PSendSysMessage("Map tick profiles will be written to %s.", (sLog->GetLogsDir() + sConfigMgr->GetStringDefault("MapUpdate.Profiler.DumpFile", "MapTickProfile.log")).c_str());
+        return true;
+    }
+
     // Display the 'Message of the day' for the realm
     static bool HandleServerMotdCommand(ChatHandler* handler, char const* /*args*/)
     {
@@ -1733,7 +1733,7 @@ public:
                         {
                             BadAvery->CastSpell(BadAvery, SPELL_GET_SHOT, true);
                             BadAvery->setDeathState(JUST_DIED);
-                            player->SaveToDB();
+                            player->RequestSave();
                             BadAvery->DespawnOrUnsummon(1000);
                             me->DespawnOrUnsummon(1000);
                             tEvent = 5000;
@@ -2622,7 +2622,7 @@ public:
             player->RemoveAurasDueToSpell(SPELL_WORGEN_BITE);
             godfrey->AddAura(SPELL_INFECTED_BITE, player);
             player->CastSpell(player, SPELL_GILNEAS_CANNON_CAMERA);
-            player->SaveToDB();
+            player->RequestSave();
             if (Creature* cannon = GetClosestCreatureWithEntry(godfrey, NPC_COMMANDEERED_CANNON, 50.0f))
             {
                 CAST_AI(npc_commandeered_cannon::npc_commandeered_cannonAI, cannon->AI())->EventStart = true; // Start Event
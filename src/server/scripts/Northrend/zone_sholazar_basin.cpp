@@ -1159,7 +1159,7 @@ public:
 
                         bird->Kill(bird);
                         crunchy->GetMotionMaster()->MovePoint(0, bird->GetPositionX(), bird->GetPositionY(),
-                            bird->GetMap()->GetWaterOrGroundLevel(bird->GetPhases(), bird->GetPositionX(), bird->GetPositionY(), bird->GetPositionZ()));
+                            bird->GetMap()->GetWaterOrGroundLevel(bird->GetPhaseSet(), bird->GetPositionX(), bird->GetPositionY(), bird->GetPositionZ()));
                         // TODO: Make crunchy perform emote eat when he reaches the bird
 
                         break;
@@ -4870,7 +4870,7 @@ public:
             float posX = frand(228.0f, 270.0f);
             float posY = frand(3949.0f, 3962.0f);
 
-            me->SummonCreature(RAND(NPC_HEALER_A, NPC_HEALER_H), posX, posY, map->GetHeight(me->GetPhases(), posX, posY, 100.0f), 1.37f, TEMPSUMMON_CORPSE_DESPAWN);
+            me->SummonCreature(RAND(NPC_HEALER_A, NPC_HEALER_H), posX, posY, map->GetHeight(me->GetPhaseSet(), posX, posY, 100.0f), 1.37f, TEMPSUMMON_CORPSE_DESPAWN);
         }
 
         void JustSummoned(Creature* summon)
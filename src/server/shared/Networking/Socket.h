@@ -19,14 +19,17 @@
 #define __SOCKET_H__
 
 #include "Log.h"
-#include "MessageBuffer.h"
+#include "MessageBufferPool.h"
 #include <boost/asio/ip/tcp.hpp>
+#include <algorithm>
+#include <array>
 #include <atomic>
 #include <memory>
-#include <queue>
+#include <deque>
 #include <type_traits>
 
 #define READ_BLOCK_SIZE 4096
+#define WRITE_GATHER_COUNT 16
 #ifdef BOOST_ASIO_HAS_IOCP
 #define TC_SOCKET_USE_IOCP
 #endif
@@ -140,7 +143,7 @@ public:
 
     void QueuePacket(MessageBuffer&& buffer)
     {
-        _writeQueue.push(std::move(buffer));
+        _writeQueue.push_back(std::move(buffer));
 
 #ifdef TC_SOCKET_USE_IOCP
         AsyncProcessQueue();
@@ -188,8 +191,9 @@ protected:
         _isWritingAsync = true;
 
 #ifdef TC_SOCKET_USE_IOCP
-        MessageBuffer& buffer = _writeQueue.front();
-        _socket.async_write_some(boost::asio::buffer(buffer.GetReadPointer(), buffer.GetActiveSize()),
+        WriteBufferSequence buffers;
+        GatherWriteQueue(buffers);
+        _socket.async_write_some(buffers,
             [self = this->shared_from_this()](boost::system::error_code const& error, std::size_t transferedBytes)
             {
                 self->WriteHandler(error, transferedBytes);
@@ -239,9 +243,7 @@ private:
         if (!error)
         {
             _isWritingAsync = false;
-            _writeQueue.front().ReadCompleted(transferedBytes);
-            if (!_writeQueue.front().GetActiveSize())
-                _writeQueue.pop();
+            ConsumeWriteQueue(transferedBytes);
 
             if (!_writeQueue.empty())
                 AsyncProcessQueue();
@@ -265,37 +267,34 @@ private:
         if (_writeQueue.empty())
             return false;
 
-        MessageBuffer& queuedMessage = _writeQueue.front();
-
-        std::size_t bytesToSend = queuedMessage.GetActiveSize();
+        WriteBufferSequence buffers;
+        std::size_t bytesToSend = GatherWriteQueue(buffers);
 
         boost::system::error_code error;
-        std::size_t bytesSent = _socket.write_some(boost::asio::buffer(queuedMessage.GetReadPointer(), bytesToSend), error);
+        std::size_t bytesSent = _socket.write_some(buffers, error);
 
         if (error)
         {
             if (error == boost::asio::error::would_block || error == boost::asio::error::try_again)
                 return AsyncProcessQueue();
 
-            _writeQueue.pop();
+            PopWriteQueue();
             if (_closing && _writeQueue.empty())
                 CloseSocket();
             return false;
         }
         else if (bytesSent == 0)
         {
-            _writeQueue.pop();
+            PopWriteQueue();
             if (_closing && _writeQueue.empty())
                 CloseSocket();
             return false;
         }
-        else if (bytesSent < bytesToSend) // now n > 0
-        {
-            queuedMessage.ReadCompleted(bytesSent);
+
+        ConsumeWriteQueue(bytesSent);
+        if (bytesSent < bytesToSend) // now n > 0
             return AsyncProcessQueue();
-        }
 
-        _writeQueue.pop();
         if (_closing && _writeQueue.empty())
             CloseSocket();
         return !_writeQueue.empty();
@@ -303,13 +302,51 @@ private:
 
 #endif
 
+    // unused trailing entries stay empty, asio skips zero sized buffers
+    typedef std::array<boost::asio::const_buffer, WRITE_GATHER_COUNT> WriteBufferSequence;
+
+    /// Fills buffers with the head of the write queue so one syscall sends several queued buffers
+    std::size_t GatherWriteQueue(WriteBufferSequence& buffers)
+    {
+        std::size_t bytes = 0;
+        std::size_t count = 0;
+        for (auto itr = _writeQueue.begin(); itr != _writeQueue.end() && count < buffers.size(); ++itr, ++count)
+        {
+            buffers[count] = boost::asio::const_buffer(itr->GetReadPointer(), itr->GetActiveSize());
+            bytes += itr->GetActiveSize();
+        }
+
+        return bytes;
+    }
+
+    void ConsumeWriteQueue(std::size_t bytes)
+    {
+        while (bytes && !_writeQueue.empty())
+        {
+            MessageBuffer& buffer = _writeQueue.front();
+            std::size_t consumed = std::min<std::size_t>(bytes, buffer.GetActiveSize());
+            buffer.ReadCompleted(consumed);
+            bytes -= consumed;
+            if (buffer.GetActiveSize())
+                break;
+
+            PopWriteQueue();
+        }
+    }
+
+    void PopWriteQueue()
+    {
+        sMessageBufferPool->Release(std::move(_writeQueue.front()));
+        _writeQueue.pop_front();
+    }
+
     Stream _socket;
 
     boost::asio::ip::address _remoteAddress;
     uint16 _remotePort;
 
     MessageBuffer _readBuffer;
-    std::queue<MessageBuffer> _writeQueue;
+    std::deque<MessageBuffer> _writeQueue;
 
     std::atomic<bool> _closed;
     std::atomic<bool> _closing;
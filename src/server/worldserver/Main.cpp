@@ -33,6 +33,7 @@
 #include "AsyncAcceptor.h"
 #include "BattlegroundMgr.h"
 #include "BigNumber.h"
+#include "CharacterSaveScheduler.h"
 #include "CliRunnable.h"
 #include "Common.h"
 #include "Configuration/Config.h"
@@ -301,6 +302,7 @@ extern int main(int argc, char **argv)
     {
         sWorld->KickAll();                                       // save and kick all players
         sWorld->UpdateSessions(1);                             // real players unload required UpdateSessions call
+        sCharacterSaveScheduler->Flush();                      // logout saves queued behind older saves of the same character
 
         sWorldSocketMgr.StopNetwork();
 